@@ -0,0 +1,44 @@
+#ifndef ALIGNED_ARRAY_H
+#define ALIGNED_ARRAY_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+// Fixed-size, zero-initialized array of trivially copyable T whose storage
+// starts on a cache-line boundary (so SIMD loads never split a line at the
+// start of the array and neighbouring arrays never share one).
+template <typename T, size_t Alignment = 64>
+class AlignedArray {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "AlignedArray holds plain data only");
+
+private:
+    T* data_;
+    size_t size_;
+
+public:
+    explicit AlignedArray(size_t size = 0)
+        : data_(nullptr), size_(size) {
+        if (size_ > 0) {
+            data_ = static_cast<T*>(::operator new(size_ * sizeof(T), std::align_val_t(Alignment)));
+            for (size_t i = 0; i < size_; ++i) data_[i] = T();
+        }
+    }
+    
+    ~AlignedArray() {
+        if (data_) ::operator delete(data_, std::align_val_t(Alignment));
+    }
+    
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+    
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+#endif // ALIGNED_ARRAY_H
@@ -0,0 +1,83 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Debug counter of heap allocations, used to check that the tick path runs
+// without touching the heap once it has warmed up.
+//
+// Configure with -DSTOCK_SIMULATOR_COUNT_ALLOCATIONS=ON to replace the global
+// operator new/delete with versions that count every allocation. The
+// replacements must exist exactly once per program, so they are only
+// emitted by the translation unit that defines
+// STOCK_SIMULATOR_DEFINE_ALLOCATION_HOOKS before including this header
+// (main.cpp). Without the option nothing is replaced and the counters stay 0.
+namespace alloc_counter {
+
+#ifdef STOCK_SIMULATOR_COUNT_ALLOCATIONS
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+// Constant-initialized, so they are usable from operator new before main()
+inline std::atomic<uint64_t> g_allocations{0};
+inline std::atomic<uint64_t> g_allocated_bytes{0};
+
+inline uint64_t allocations() { return g_allocations.load(std::memory_order_relaxed); }
+inline uint64_t allocatedBytes() { return g_allocated_bytes.load(std::memory_order_relaxed); }
+
+inline void count(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+}  // namespace alloc_counter
+
+#if defined(STOCK_SIMULATOR_COUNT_ALLOCATIONS) && defined(STOCK_SIMULATOR_DEFINE_ALLOCATION_HOOKS)
+
+// The nothrow and array forms of the standard library forward to these.
+// GCC sees free() inlined into delete calls on memory from new and flags
+// it; here that pairing is exactly the intent.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    alloc_counter::count(size);
+    if (void* p = std::malloc(size > 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    alloc_counter::count(size);
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (size + align - 1) / align * align;     // aligned_alloc needs a multiple
+    if (void* p = std::aligned_alloc(align, rounded > 0 ? rounded : align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return ::operator new(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+#endif // ALLOCATION_COUNTER_H
@@ -0,0 +1,103 @@
+#ifndef ASYNC_CONSOLE_WRITER_H
+#define ASYNC_CONSOLE_WRITER_H
+
+#include "ThreadPlacement.h"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <string>
+
+// Writes frames to stdout on its own thread, keeping only the newest.
+//
+// submit() hands a finished frame over by swapping strings under a short
+// lock and returns at once; the terminal write (which can block for as
+// long as the terminal likes) happens on the writer thread. If a frame is
+// still waiting when the next one arrives, the older one is dropped
+// (coalesced): a display only ever needs its latest state.
+//
+// Frames go through stdio (fwrite/fflush), which std::cout is synchronized
+// with, so they interleave with the rest of the program's console output
+// rather than overtaking it. All three strings keep their capacity, so a
+// steady frame size costs no allocations.
+class AsyncConsoleWriter {
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::string pending_;                   // Newest frame not yet written
+    bool has_pending_ = false;
+    bool stop_ = false;
+    std::string writing_;                   // Writer thread only
+    
+    std::atomic<size_t> submitted_{0};
+    std::atomic<size_t> written_{0};
+    std::atomic<size_t> coalesced_{0};      // Frames replaced before being written
+    
+    std::thread thread_;                    // Last: starts once the rest exists
+    
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Background, "AsyncConsoleWriter");
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stop_ || has_pending_; });
+                if (!has_pending_) return;  // Stopped with nothing left to write
+                writing_.swap(pending_);
+                has_pending_ = false;
+            }
+            std::fwrite(writing_.data(), 1, writing_.size(), stdout);
+            std::fflush(stdout);
+            written_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    AsyncConsoleWriter() : thread_(&AsyncConsoleWriter::run, this) {}
+    
+    ~AsyncConsoleWriter() {
+        stop();
+    }
+    
+    AsyncConsoleWriter(const AsyncConsoleWriter&) = delete;
+    AsyncConsoleWriter& operator=(const AsyncConsoleWriter&) = delete;
+    
+    /**
+     * @brief Queue frame for writing; frame receives a spare buffer in exchange
+     *
+     * Never waits for the terminal. The caller can clear() and reuse the
+     * returned string for its next frame.
+     */
+    void submit(std::string& frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (has_pending_) {
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+            }
+            pending_.swap(frame);
+            has_pending_ = true;
+        }
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        ready_.notify_one();
+    }
+    
+    /**
+     * @brief Write any pending frame, then stop the writer thread
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    size_t submitted() const { return submitted_.load(std::memory_order_relaxed); }
+    size_t written() const { return written_.load(std::memory_order_relaxed); }
+    size_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+};
+
+#endif // ASYNC_CONSOLE_WRITER_H
@@ -0,0 +1,285 @@
+#ifndef BAR_AGGREGATOR_H
+#define BAR_AGGREGATOR_H
+
+#include "PriceData.h"
+#include "PriceRing.h"
+#include "TickArena.h"
+#include "SymbolRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Resolution an indicator runs at: raw ticks or closed OHLCV bars.
+enum class BarResolution {
+    Tick,
+    Second,
+    Minute,
+    FiveMinutes,
+    Hour
+};
+
+constexpr size_t kBarLevels = 4;                // 1s, 1m, 5m, 1h
+
+inline const char* barResolutionName(BarResolution resolution) {
+    switch (resolution) {
+        case BarResolution::Tick: return "tick";
+        case BarResolution::Second: return "1s";
+        case BarResolution::Minute: return "1m";
+        case BarResolution::FiveMinutes: return "5m";
+        case BarResolution::Hour: return "1h";
+    }
+    return "?";
+}
+
+// Level index of a bar resolution (not Tick)
+inline size_t barLevel(BarResolution resolution) {
+    return static_cast<size_t>(resolution) - 1;
+}
+
+// Bar period of a level in TickClock nanoseconds
+inline int64_t barPeriodNs(size_t level) {
+    static constexpr int64_t kSeconds[kBarLevels] = {1, 60, 300, 3600};
+    return kSeconds[level] * 1000000000LL;
+}
+
+// One OHLCV bar (one cache line)
+struct Bar {
+    TickClock::rep start = 0;       // Period start, a multiple of the period on TickClock
+    TickClock::rep last = 0;        // Timestamp of the closing tick
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    uint64_t ticks = 0;             // 0: no bar
+};
+
+static_assert(sizeof(Bar) == 64, "bar layout");
+
+// Fixed-capacity single-writer ring of closed bars (one symbol, one level).
+//
+// Same protocol as PriceRing: the writer fills the next slot and then
+// advances closed_; readers copy slots and re-check closed_ afterwards,
+// retrying if the writer lapped them. Capacity is at least twice the bar
+// history, so readers of the newest history have slack.
+class BarSeries {
+private:
+    Bar* bars_ = nullptr;
+    size_t capacity_ = 1;           // Power of two
+    size_t mask_ = 0;
+    size_t history_limit_ = 0;
+    alignas(64) std::atomic<uint64_t> closed_{0};   // Bars ever closed
+    
+    static size_t capacityFor(size_t history_limit) {
+        size_t cap = 1;
+        while (cap < 2 * (history_limit > 0 ? history_limit : 1)) cap <<= 1;
+        return cap;
+    }
+    
+    bool intact(uint64_t oldest) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return closed_.load(std::memory_order_relaxed) < oldest + capacity_;
+    }
+
+public:
+    static size_t storageBytes(size_t history_limit) {
+        return capacityFor(history_limit) * sizeof(Bar);
+    }
+    
+    void attach(std::byte* storage, size_t history_limit) {
+        bars_ = reinterpret_cast<Bar*>(storage);
+        capacity_ = capacityFor(history_limit);
+        mask_ = capacity_ - 1;
+        history_limit_ = history_limit;
+    }
+    
+    /**
+     * @brief Writer: append a closed bar (never blocks)
+     */
+    void publish(const Bar& bar) {
+        uint64_t seq = closed_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bars_[seq & mask_] = bar;
+        closed_.store(seq + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Number of bars closed so far (acquire)
+     */
+    uint64_t sequence() const { return closed_.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief Copy up to count most recent bars (oldest to newest)
+     */
+    size_t readRecent(size_t count, std::vector<Bar>& out) const {
+        if (count > history_limit_) count = history_limit_;
+        for (;;) {
+            uint64_t seq = sequence();
+            uint64_t n = std::min<uint64_t>(seq, count);
+            out.clear();
+            for (uint64_t i = seq - n; i < seq; ++i) out.push_back(bars_[i & mask_]);
+            if (intact(seq - n)) return out.size();
+        }
+    }
+    
+    /**
+     * @brief Copy the bars closed after cursor as ticks: price = close,
+     *        change = close - open, volume, timestamp = closing tick
+     *
+     * At most the bar history is returned; older bars count in missed.
+     * @return New cursor value
+     */
+    uint64_t readSince(uint64_t cursor, SymbolId symbol, TickBatch& out, uint64_t* missed) const {
+        out.symbol = symbol;
+        for (;;) {
+            out.clear();
+            uint64_t seq = sequence();
+            if (seq <= cursor) {
+                if (missed) *missed = 0;
+                return cursor;
+            }
+            uint64_t first = std::max<uint64_t>(cursor, seq > history_limit_ ? seq - history_limit_ : 0);
+            for (uint64_t i = first; i < seq; ++i) {
+                const Bar& bar = bars_[i & mask_];
+                out.prices.push_back(bar.close);
+                out.changes.push_back(bar.close - bar.open);
+                out.volumes.push_back(bar.volume);
+                out.timestamps.push_back(bar.last);
+            }
+            if (intact(first)) {
+                if (missed) *missed = first - cursor;
+                return seq;
+            }
+        }
+    }
+};
+
+// OHLCV bars of every symbol at 1s, 1m, 5m and 1h, built as ticks are pushed.
+//
+// Only the 1s level looks at ticks. A coarser level is derived from the
+// level below it: it folds in a finer bar when that bar closes, so its
+// per-tick cost is nothing and its per-bar cost is a few min/max. A
+// tick past the end of the forming bar closes it, and closing cascades
+// upwards as far as the tick also ends coarser periods; a bar therefore
+// closes with the first tick of a later period, and periods without ticks
+// produce no bar.
+//
+// Every level keeps its last bar_history closed bars in a BarSeries, all
+// in one preallocated TickArena, so memory is fixed no matter how long
+// the bars span (64 bytes x 4 levels x about 2 x bar_history per symbol).
+// Each symbol has one writer (the producer that pushes it); forming bars
+// are private to it, readers only see closed bars.
+class BarAggregator {
+private:
+    struct SymbolBars {
+        Bar forming[kBarLevels];
+        TickClock::rep end[kBarLevels] = {};        // End of each forming bar's period
+        BarSeries series[kBarLevels];
+    };
+    
+    size_t history_limit_;
+    TickArena arena_;
+    std::unique_ptr<SymbolBars[]> symbols_;
+    size_t size_;
+    
+    static void open(Bar& bar, TickClock::rep& end, size_t level, TickClock::rep start_time) {
+        int64_t period = barPeriodNs(level);
+        TickClock::rep start = start_time - ((start_time % period) + period) % period;
+        bar = Bar();
+        bar.start = start;
+        end = start + period;
+    }
+    
+    // Fold a closed bar of the level below into level's forming bar
+    static void fold(SymbolBars& bars, size_t level, const Bar& finer) {
+        Bar& bar = bars.forming[level];
+        if (bar.ticks == 0) {
+            open(bar, bars.end[level], level, finer.start);
+            bar.open = finer.open;
+            bar.high = finer.high;
+            bar.low = finer.low;
+        } else {
+            bar.high = std::max(bar.high, finer.high);
+            bar.low = std::min(bar.low, finer.low);
+        }
+        bar.close = finer.close;
+        bar.last = finer.last;
+        bar.volume += finer.volume;
+        bar.ticks += finer.ticks;
+    }
+
+public:
+    /**
+     * @param symbols Symbol IDs 0..symbols-1
+     * @param history_limit Closed bars kept per symbol and level
+     */
+    BarAggregator(size_t symbols, size_t history_limit)
+        : history_limit_(history_limit),
+          arena_(symbols * kBarLevels, BarSeries::storageBytes(history_limit)),
+          symbols_(std::make_unique<SymbolBars[]>(symbols)),
+          size_(symbols) {
+        for (size_t id = 0; id < symbols; ++id) {
+            for (size_t level = 0; level < kBarLevels; ++level) {
+                symbols_[id].series[level].attach(arena_.slice(id * kBarLevels + level), history_limit);
+            }
+        }
+    }
+    
+    size_t historyLimit() const { return history_limit_; }
+    size_t storageBytes() const { return arena_.bytes(); }
+    
+    /**
+     * @brief Writer: fold a tick into its symbol's 1s bar (and close bars it ends)
+     */
+    void add(const PriceData& tick) {
+        if (tick.symbol >= size_) {
+            return;
+        }
+        SymbolBars& bars = symbols_[tick.symbol];
+        TickClock::rep time = tick.timestamp.time_since_epoch().count();
+        
+        // Close every level whose period this tick is past
+        for (size_t level = 0; level < kBarLevels; ++level) {
+            Bar& bar = bars.forming[level];
+            if (bar.ticks == 0 || time < bars.end[level]) {
+                break;
+            }
+            bars.series[level].publish(bar);
+            if (level + 1 < kBarLevels) fold(bars, level + 1, bar);
+            bar.ticks = 0;
+        }
+        
+        Bar& bar = bars.forming[0];
+        if (bar.ticks == 0) {
+            open(bar, bars.end[0], 0, time);
+            bar.open = bar.high = bar.low = tick.price;
+        } else {
+            bar.high = std::max(bar.high, tick.price);
+            bar.low = std::min(bar.low, tick.price);
+        }
+        bar.close = tick.price;
+        bar.last = time;
+        bar.volume += tick.volume;
+        ++bar.ticks;
+    }
+    
+    const BarSeries& series(SymbolId symbol, size_t level) const {
+        return symbols_[symbol].series[level];
+    }
+    
+    /**
+     * @brief Bars closed so far at each level, all symbols
+     */
+    void closedBars(uint64_t (&counts)[kBarLevels]) const {
+        for (size_t level = 0; level < kBarLevels; ++level) {
+            counts[level] = 0;
+            for (size_t id = 0; id < size_; ++id) counts[level] += symbols_[id].series[level].sequence();
+        }
+    }
+};
+
+#endif // BAR_AGGREGATOR_H
@@ -0,0 +1,43 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Size that keeps two objects from sharing a cache line (false sharing)
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns that the value depends on -mtune; every translation unit here
+// is built with the same flags, so layouts agree
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+constexpr size_t kCacheLineSize = 64;
+#endif
+
+// A T that owns its cache line(s): nothing else is placed on them, so a
+// thread writing it never invalidates a line another thread is reading.
+// Use for state written by one thread that sits next to other threads'
+// state, e.g. per-symbol entries of a vector processed by different workers.
+template <typename T>
+struct alignas(kCacheLineSize) CachePadded {
+    T value;
+    
+    CachePadded() : value() {}
+    
+    template <typename... Args>
+    explicit CachePadded(Args&&... args) : value(std::forward<Args>(args)...) {}
+    
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+};
+
+#endif // CACHE_LINE_H
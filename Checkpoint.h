@@ -0,0 +1,531 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "SharedBuffer.h"
+#include "IndicatorTask.h"
+#include "CheckpointStream.h"
+#include "Clock.h"
+#include "ThreadPlacement.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Checkpoint file format (native byte order, read back by the same build):
+//
+//   CheckpointHeader                       64 bytes
+//   payload (payload_bytes, FNV-1a checksummed):
+//     symbol names                         symbol_count x (uint32 length, bytes)
+//     listed flags                         symbol_count x uint8 (1 = listed when captured)
+//     rings                                symbol_count x (uint64 sequence, uint32 n,
+//                                          n prices, n changes, n volumes, n timestamps)
+//     uint32 section_count
+//     sections                             (name, uint64 size, IndicatorTask::saveState bytes)
+//
+// Rings keep their sequence numbers, so the indicator cursors saved next to
+// them still point at the right ticks after a restart. Timestamps are
+// TickClock readings of the process that wrote the file; a restore shifts
+// them by (now - captured_ns) so restored ticks look as old as they were
+// when the checkpoint was taken, instead of carrying another process's epoch.
+//
+// Every registered symbol is saved, delisted ones included (their rings
+// keep their ticks), with a flag saying whether it was listed.
+
+constexpr char kCheckpointMagic[8] = {'S', 'T', 'K', 'C', 'K', 'P', 'T', '1'};
+constexpr uint32_t kCheckpointVersion = 2;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t symbol_count;
+    uint64_t history_limit;     // Buffer history size of the writer
+    uint64_t number;            // Checkpoints the writing run had written (1 = first)
+    int64_t captured_ns;        // TickClock time the rings were captured
+    uint64_t payload_bytes;     // Bytes following the header
+    uint64_t checksum;          // FNV-1a 64 of the payload
+    uint64_t reserved;
+};
+
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header layout");
+
+inline uint64_t checkpointChecksum(const std::byte* data, size_t n) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < n; ++i) {
+        hash ^= static_cast<uint64_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Read-only memory mapping of a checkpoint, used once at startup.
+//
+// The constructor validates the header and checksum, so a torn or foreign
+// file is rejected before anything is restored. restoreBuffer() copies the
+// rings into a SharedBuffer and restoreIndicator() hands each indicator its
+// section; both run before any producer or consumer thread starts.
+class MappedCheckpoint {
+private:
+    std::string path_;
+    void* base_;
+    size_t length_;
+    CheckpointHeader header_;
+    const std::byte* payload_;
+    std::vector<std::string> symbols_;
+    std::vector<uint8_t> listed_;           // Symbol ID -> listed when captured
+    size_t rings_offset_;                   // Within the payload
+    size_t sections_offset_;
+    TickClock::duration clock_shift_;
+    
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("checkpoint " + path_ + ": " + what);
+    }
+
+public:
+    /**
+     * @brief Map and validate a checkpoint
+     * @throws std::runtime_error if the file cannot be mapped or is malformed
+     */
+    explicit MappedCheckpoint(const std::string& path)
+        : path_(path), base_(nullptr), length_(0), header_(), payload_(nullptr),
+          rings_offset_(0), sections_offset_(0),
+          clock_shift_(TickClock::duration::zero()) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(std::strerror(errno));
+        
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(std::strerror(errno));
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        if (length_ < sizeof(CheckpointHeader)) {
+            ::close(fd);
+            fail("too small for a header");
+        }
+        
+        base_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file referenced
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            fail(std::strerror(errno));
+        }
+        
+        try {
+            parse();
+        } catch (...) {
+            ::munmap(base_, length_);
+            throw;
+        }
+        clock_shift_ = TickClock::now().time_since_epoch() - TickClock::duration(header_.captured_ns);
+    }
+    
+    ~MappedCheckpoint() {
+        if (base_) ::munmap(base_, length_);
+    }
+    
+    MappedCheckpoint(const MappedCheckpoint&) = delete;
+    MappedCheckpoint& operator=(const MappedCheckpoint&) = delete;
+    
+    const std::string& path() const { return path_; }
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    bool listed(SymbolId id) const { return id < listed_.size() && listed_[id]; }
+    uint64_t number() const { return header_.number; }
+    
+    /**
+     * @brief Refill buffer's rings (before any thread uses it)
+     *
+     * Symbols the checkpoint has beyond the buffer's (listed at runtime)
+     * take spare registry slots again. Symbols that were delisted when it
+     * was captured are delisted; the others are listed.
+     * @return Number of ticks restored
+     * @throws std::runtime_error (buffer untouched) if the checkpoint was
+     *         written for different symbols, they do not fit the registry, or
+     *         the writer kept a different history size
+     */
+    size_t restoreBuffer(SharedBuffer& buffer) const {
+        // Restored cursors and windows count ticks of the writer's rings
+        if (header_.history_limit != buffer.historyLimit()) {
+            fail("written with --history=" + std::to_string(header_.history_limit) + " (this run: " +
+                 std::to_string(buffer.historyLimit()) + ")");
+        }
+        const SymbolRegistry& registry = buffer.registry();
+        std::vector<std::string> registered = registry.names();
+        if (registered.size() > symbols_.size() ||
+            !std::equal(registered.begin(), registered.end(), symbols_.begin())) {
+            fail("written for different symbols");
+        }
+        if (symbols_.size() > registry.capacity()) {
+            fail("written for more symbols than --symbol-capacity");
+        }
+        // Register the runtime symbols (updateListings lists them), then delist the delisted
+        std::vector<SymbolId> delisted;
+        for (size_t id = 0; id < symbols_.size(); ++id) {
+            if (!listed_[id]) delisted.push_back(static_cast<SymbolId>(id));
+        }
+        if (symbols_.size() > registered.size()) {
+            buffer.updateListings(std::vector<std::string>(symbols_.begin() + registered.size(), symbols_.end()), {});
+        }
+        buffer.updateListings({}, delisted);
+        
+        CheckpointReader in = payloadReader(rings_offset_);
+        TickBatch ticks;
+        size_t restored = 0;
+        for (size_t id = 0; id < symbols_.size(); ++id) {
+            uint64_t sequence = 0;
+            uint32_t n = 0;
+            in.get(sequence);
+            in.get(n);
+            ticks.clear();
+            ticks.prices.resize(n);
+            ticks.changes.resize(n);
+            ticks.volumes.resize(n);
+            ticks.timestamps.resize(n);
+            in.getArray(ticks.prices.data(), n);
+            in.getArray(ticks.changes.data(), n);
+            in.getArray(ticks.volumes.data(), n);
+            in.getArray(ticks.timestamps.data(), n);
+            if (!in.ok()) fail("truncated ring data");  // Checksummed, so only a writer bug gets here
+            
+            for (auto& t : ticks.timestamps) t += clock_shift_.count();
+            buffer.restoreHistory(static_cast<SymbolId>(id), sequence, ticks);
+            restored += (n < buffer.historyLimit()) ? n : buffer.historyLimit();
+        }
+        return restored;
+    }
+    
+    /**
+     * @brief Restore an indicator from the section named after it (task.name())
+     * @return false if there is no such section or it does not fit the indicator
+     */
+    bool restoreIndicator(IndicatorTask& task) const {
+        CheckpointReader in = payloadReader(sections_offset_);
+        uint32_t sections = 0;
+        in.get(sections);
+        std::string name;
+        for (uint32_t i = 0; i < sections && in.ok(); ++i) {
+            uint64_t size = 0;
+            in.getString(name);
+            in.get(size);
+            CheckpointReader section = in.sub(static_cast<size_t>(size));
+            if (in.ok() && name == task.name()) {
+                return task.loadState(section, clock_shift_);
+            }
+        }
+        return false;
+    }
+
+private:
+    CheckpointReader payloadReader(size_t offset) const {
+        return CheckpointReader(payload_ + offset, static_cast<size_t>(header_.payload_bytes) - offset);
+    }
+    
+    void parse() {
+        const std::byte* bytes = static_cast<const std::byte*>(base_);
+        std::memcpy(&header_, bytes, sizeof(header_));
+        
+        if (std::memcmp(header_.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0) {
+            fail("bad magic (not a checkpoint)");
+        }
+        if (header_.version != kCheckpointVersion) {
+            fail("unsupported version " + std::to_string(header_.version));
+        }
+        if (header_.payload_bytes != length_ - sizeof(CheckpointHeader)) {
+            fail("truncated (header says " + std::to_string(header_.payload_bytes) + " payload bytes)");
+        }
+        payload_ = bytes + sizeof(CheckpointHeader);
+        if (checkpointChecksum(payload_, static_cast<size_t>(header_.payload_bytes)) != header_.checksum) {
+            fail("checksum mismatch");
+        }
+        
+        // Symbol table, then remember where the rings and sections start
+        CheckpointReader in = payloadReader(0);
+        symbols_.resize(header_.symbol_count);
+        for (auto& name : symbols_) {
+            if (!in.getString(name)) fail("truncated symbol table");
+        }
+        listed_.resize(header_.symbol_count);
+        if (!in.getArray(listed_.data(), listed_.size())) fail("truncated symbol table");
+        rings_offset_ = static_cast<size_t>(header_.payload_bytes) - in.remaining();
+        
+        for (uint32_t id = 0; id < header_.symbol_count; ++id) {
+            uint64_t sequence = 0;
+            uint32_t n = 0;
+            in.get(sequence);
+            in.get(n);
+            in.sub(static_cast<size_t>(n) * 4 * sizeof(double));
+            if (!in.ok()) fail("truncated ring data");
+        }
+        sections_offset_ = static_cast<size_t>(header_.payload_bytes) - in.remaining();
+    }
+};
+
+// Writes periodic checkpoints of the buffer and registered indicators.
+//
+// Every interval the checkpointer thread asks each indicator for a fresh
+// copy of its state; the indicator serializes it between two passes (see
+// IndicatorTask::passComplete), into the back half of its double-buffered
+// CheckpointSection. Once every indicator has answered (or a timeout
+// passes, in which case its previous copy is used) the thread copies the
+// rings with ordinary lock-free reads, which are never older than the
+// indicator cursors, and writes the file. Nothing on the tick path waits
+// for the disk.
+//
+// Files are written to path.tmp, fsync'ed and renamed over path, so the
+// previous checkpoint stays intact until a complete new one replaces it.
+class Checkpointer {
+private:
+    struct Source {
+        IndicatorTask* task;
+        CheckpointSection section;
+        
+        explicit Source(IndicatorTask& t) : task(&t), section(t.name()) {}
+    };
+    
+    SharedBuffer& buffer_;
+    std::string path_;
+    std::string temp_path_;
+    int interval_ms_;
+    std::vector<std::unique_ptr<Source>> sources_;
+    
+    std::atomic<bool> running_;
+    std::thread thread_;
+    
+    uint64_t epoch_;                        // Last state request
+    CheckpointWriter payload_;              // Reused for every file
+    TickBatch ticks_;                       // Ring copy scratch
+    SymbolTable::Reader listed_;            // Checkpointer thread, then stop()'s final write
+    std::vector<uint8_t> listed_flags_;     // Symbol ID -> listed, per file
+    
+    std::atomic<size_t> written_;
+    std::atomic<size_t> failed_;
+    std::atomic<size_t> last_bytes_;
+    std::atomic<int64_t> last_write_us_;
+    
+    // Sleep up to ms, waking early on stop()
+    bool sleepFor(int ms) {
+        const int slice = 50;
+        for (int waited = 0; waited < ms; waited += slice) {
+            if (!running_.load()) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(ms - waited < slice ? ms - waited : slice));
+        }
+        return running_.load();
+    }
+    
+    // Ask every indicator for a copy; wait (bounded) until they all staged one
+    void collectIndicators() {
+        ++epoch_;
+        for (auto& source : sources_) {
+            source->section.request(epoch_);
+        }
+        int budget_ms = interval_ms_ < 2000 ? interval_ms_ : 2000;
+        for (int waited = 0; waited < budget_ms && running_.load(); waited += 10) {
+            bool all = true;
+            for (auto& source : sources_) {
+                all = all && source->section.staged(epoch_);
+            }
+            if (all) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    
+    // Assemble the payload from the staged sections and the current rings, then write it
+    bool write() {
+        auto write_start = std::chrono::steady_clock::now();
+        const SymbolRegistry& registry = buffer_.registry();
+        
+        // Listings first: each listed ID is below the registry size read after them.
+        // Symbols listed after this point have no ticks in this checkpoint yet
+        listed_.refresh();
+        size_t symbols = registry.size();
+        listed_flags_.assign(symbols, 0);
+        for (SymbolId id : listed_.symbols()) listed_flags_[id] = 1;
+        payload_.clear();
+        for (size_t id = 0; id < symbols; ++id) {
+            payload_.putString(registry.name(static_cast<SymbolId>(id)));
+        }
+        payload_.putArray(listed_flags_.data(), symbols);
+        
+        // Rings after the sections were staged: every saved cursor is <= its ring's sequence
+        int64_t captured_ns = TickClock::now().time_since_epoch().count();
+        for (size_t id = 0; id < symbols; ++id) {
+            uint64_t sequence = buffer_.readSince(static_cast<SymbolId>(id), 0, ticks_);
+            uint32_t n = static_cast<uint32_t>(ticks_.size());
+            payload_.put(sequence);
+            payload_.put(n);
+            payload_.putArray(ticks_.prices.data(), n);
+            payload_.putArray(ticks_.changes.data(), n);
+            payload_.putArray(ticks_.volumes.data(), n);
+            payload_.putArray(ticks_.timestamps.data(), n);
+        }
+        
+        // Section count is patched in once we know which indicators staged a copy
+        size_t count_at = payload_.size();
+        payload_.put(uint32_t(0));
+        uint32_t sections = 0;
+        for (const auto& source : sources_) {
+            if (source->section.appendTo(payload_)) ++sections;
+        }
+        std::memcpy(payload_.bytes().data() + count_at, &sections, sizeof(sections));
+        
+        CheckpointHeader header = {};
+        std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+        header.version = kCheckpointVersion;
+        header.symbol_count = static_cast<uint32_t>(symbols);
+        header.history_limit = buffer_.historyLimit();
+        header.number = written_.load() + 1;
+        header.captured_ns = captured_ns;
+        header.payload_bytes = payload_.size();
+        header.checksum = checkpointChecksum(payload_.data(), payload_.size());
+        
+        if (!writeFile(header)) {
+            failed_.fetch_add(1);
+            return false;
+        }
+        
+        last_bytes_.store(sizeof(header) + payload_.size());
+        last_write_us_.store(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - write_start).count());
+        written_.fetch_add(1);
+        return true;
+    }
+    
+    static bool writeAll(int fd, const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            ssize_t done = ::write(fd, p, n);
+            if (done < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += done;
+            n -= static_cast<size_t>(done);
+        }
+        return true;
+    }
+    
+    bool writeFile(const CheckpointHeader& header) {
+        int fd = ::open(temp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "[Checkpointer] Cannot create " << temp_path_ << ": " << std::strerror(errno) << "\n";
+            return false;
+        }
+        bool ok = writeAll(fd, &header, sizeof(header)) &&
+                  writeAll(fd, payload_.data(), payload_.size()) &&
+                  ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        if (ok && ::rename(temp_path_.c_str(), path_.c_str()) != 0) ok = false;
+        if (!ok) {
+            std::cerr << "[Checkpointer] Writing " << path_ << " failed: " << std::strerror(errno) << "\n";
+            ::unlink(temp_path_.c_str());
+        }
+        return ok;
+    }
+
+public:
+    /**
+     * @param path Checkpoint file (replaced atomically on every write)
+     * @param interval_ms Time between checkpoints
+     */
+    Checkpointer(SharedBuffer& buffer, const std::string& path, int interval_ms = 5000)
+        : buffer_(buffer), path_(path), temp_path_(path + ".tmp"),
+          interval_ms_(interval_ms > 0 ? interval_ms : 1), running_(false), epoch_(0),
+          listed_(buffer.symbolTable()), written_(0), failed_(0), last_bytes_(0), last_write_us_(0) {
+        // Room for full rings up front, so files don't reallocate as the history fills
+        size_t history = buffer_.historyLimit();
+        size_t symbols = buffer_.registry().capacity();
+        payload_.reserve(symbols * (64 + 1 + 12 + 4 * sizeof(double) * history) + 4096);
+        listed_flags_.reserve(symbols);
+        ticks_.prices.reserve(history);
+        ticks_.changes.reserve(history);
+        ticks_.volumes.reserve(history);
+        ticks_.timestamps.reserve(history);
+    }
+    
+    ~Checkpointer() {
+        if (running_.exchange(false) && thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+    
+    /**
+     * @brief Include an indicator's state (before start()); saved under task.name()
+     *
+     * Whatever runs the indicator's passes must call passComplete() after
+     * each one (the dedicated loops and IndicatorScheduler do).
+     */
+    void addIndicator(IndicatorTask& task) {
+        sources_.push_back(std::make_unique<Source>(task));
+        task.attachCheckpoint(&sources_.back()->section);
+    }
+    
+    void start() {
+        bool expected = false;
+        if (running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&Checkpointer::run, this);
+            std::cout << "[Checkpointer] Started checkpoint thread (ID: " << thread_.get_id()
+                      << ") writing " << path_ << " every " << interval_ms_ << " ms\n";
+        }
+    }
+    
+    /**
+     * @brief Stop the thread and write a final checkpoint
+     *
+     * Call after the indicators have stopped: their state is then copied
+     * directly instead of being requested from their (finished) passes.
+     */
+    void stop() {
+        if (!running_.exchange(false)) return;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        
+        ++epoch_;
+        for (auto& source : sources_) {
+            source->section.request(epoch_);
+            source->section.stage([&source](CheckpointWriter& out) { source->task->saveState(out); });
+        }
+        write();
+        std::cout << "[Checkpointer] Checkpoint thread stopped after " << written_.load()
+                  << " checkpoints (" << failed_.load() << " failed; last " << last_bytes_.load() / 1024
+                  << " KB in " << last_write_us_.load() << " us)\n";
+    }
+    
+    size_t written() const { return written_.load(); }
+    size_t failed() const { return failed_.load(); }
+
+private:
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Background, "Checkpointer");
+        std::cout << "[Checkpointer] Checkpoint loop starting...\n";
+        
+        while (sleepFor(interval_ms_)) {
+            collectIndicators();
+            if (!running_.load()) break;    // stop() writes the final one
+            
+            if (write() && (written_.load() == 1 || written_.load() % 10 == 0)) {
+                std::cout << "\n[Checkpointer] Wrote checkpoint " << written_.load() << " ("
+                          << last_bytes_.load() / 1024 << " KB in " << last_write_us_.load() << " us)\n";
+            }
+        }
+        
+        std::cout << "[Checkpointer] Checkpoint loop exited\n";
+    }
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,192 @@
+#ifndef CHECKPOINT_STREAM_H
+#define CHECKPOINT_STREAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Byte streams for checkpoint payloads (see Checkpoint.h).
+//
+// Values are copied raw, in native byte order: a checkpoint is read back
+// by the same build on the same machine, not exchanged. The writer appends
+// to a vector that keeps its capacity across clear(), so serializing the
+// same state again does not allocate.
+class CheckpointWriter {
+private:
+    std::vector<std::byte> bytes_;
+
+public:
+    void clear() { bytes_.clear(); }
+    void reserve(size_t n) { bytes_.reserve(n); }
+    
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are copied raw");
+        putBytes(&value, sizeof(T));
+    }
+    
+    template <typename T>
+    void putArray(const T* values, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are copied raw");
+        putBytes(values, n * sizeof(T));
+    }
+    
+    void putString(const std::string& s) {
+        put(static_cast<uint32_t>(s.size()));
+        putBytes(s.data(), s.size());
+    }
+    
+    void putBytes(const void* data, size_t n) {
+        size_t at = bytes_.size();
+        bytes_.resize(at + n);
+        if (n > 0) std::memcpy(bytes_.data() + at, data, n);
+    }
+    
+    const std::byte* data() const { return bytes_.data(); }
+    size_t size() const { return bytes_.size(); }
+    std::vector<std::byte>& bytes() { return bytes_; }
+};
+
+// Bounds-checked reads from a checkpoint payload (usually mapped memory).
+//
+// A read past the end, or a string longer than what is left, fails the
+// reader: it returns false from then on and leaves its outputs untouched,
+// so callers can read a whole record and check ok() once.
+class CheckpointReader {
+private:
+    const std::byte* data_;
+    size_t size_;
+    size_t pos_;
+    bool ok_;
+
+public:
+    CheckpointReader(const std::byte* data, size_t size)
+        : data_(data), size_(size), pos_(0), ok_(true) {}
+    
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are copied raw");
+        return getBytes(&value, sizeof(T));
+    }
+    
+    template <typename T>
+    bool getArray(T* values, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are copied raw");
+        if (n > (size_ - pos_) / sizeof(T)) return fail();
+        return getBytes(values, n * sizeof(T));
+    }
+    
+    bool getString(std::string& s) {
+        uint32_t n = 0;
+        if (!get(n) || n > size_ - pos_) return fail();
+        s.assign(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return true;
+    }
+    
+    bool getBytes(void* out, size_t n) {
+        if (!ok_ || n > size_ - pos_) return fail();
+        if (n > 0) std::memcpy(out, data_ + pos_, n);
+        pos_ += n;
+        return true;
+    }
+    
+    // Reader over the next n bytes (this reader skips past them)
+    CheckpointReader sub(size_t n) {
+        if (!ok_ || n > size_ - pos_) {
+            fail();
+            CheckpointReader empty(nullptr, 0);
+            empty.ok_ = false;
+            return empty;
+        }
+        CheckpointReader r(data_ + pos_, n);
+        pos_ += n;
+        return r;
+    }
+    
+    bool ok() const { return ok_; }
+    size_t remaining() const { return ok_ ? size_ - pos_ : 0; }
+
+private:
+    bool fail() {
+        ok_ = false;
+        return false;
+    }
+};
+
+// Double-buffered, periodically refreshed copy of one component's state.
+//
+// The component's own thread serializes its state into the back buffer
+// whenever the checkpointer has asked for a newer copy (stage()), then
+// swaps it in as the ready copy under a short lock; the checkpointer thread
+// copies the ready bytes into the file it is assembling (appendTo()). The
+// component therefore never waits for disk, and the checkpointer never
+// reads state that is being modified.
+class CheckpointSection {
+private:
+    std::string name_;
+    std::atomic<uint64_t> requested_{0};    // Newest epoch the checkpointer asked for
+    std::atomic<uint64_t> staged_{0};       // Epoch of the ready copy
+    CheckpointWriter back_;                 // Component thread only
+    
+    mutable std::mutex mutex_;              // Guards ready_
+    std::vector<std::byte> ready_;
+    bool has_ready_ = false;
+
+public:
+    explicit CheckpointSection(std::string name) : name_(std::move(name)) {}
+    
+    CheckpointSection(const CheckpointSection&) = delete;
+    CheckpointSection& operator=(const CheckpointSection&) = delete;
+    
+    const std::string& name() const { return name_; }
+    
+    // Checkpointer: ask for a copy at least as new as epoch
+    void request(uint64_t epoch) { requested_.store(epoch, std::memory_order_release); }
+    
+    bool staged(uint64_t epoch) const { return staged_.load(std::memory_order_acquire) >= epoch; }
+    
+    // Component: true if the checkpointer is waiting for a fresh copy (cheap; call after every pass)
+    bool wanted() const {
+        return requested_.load(std::memory_order_acquire) > staged_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Component: serialize with fill(CheckpointWriter&) and publish the result
+     *
+     * Only call from a point where the state is not being modified.
+     */
+    template <typename Fill>
+    void stage(Fill&& fill) {
+        uint64_t epoch = requested_.load(std::memory_order_acquire);
+        back_.clear();
+        fill(back_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.swap(back_.bytes());
+            has_ready_ = true;
+        }
+        staged_.store(epoch, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Checkpointer: append name, size and the newest ready copy to out
+     * @return false (nothing appended) if the component has not staged anything yet
+     */
+    bool appendTo(CheckpointWriter& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!has_ready_) return false;
+        out.putString(name_);
+        out.put(static_cast<uint64_t>(ready_.size()));
+        out.putBytes(ready_.data(), ready_.size());
+        return true;
+    }
+};
+
+#endif // CHECKPOINT_STREAM_H
@@ -0,0 +1,175 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#define STOCK_SIMULATOR_HAS_TSC 1
+#endif
+
+// Clock layer for timestamps and latency measurement.
+//
+// CycleClock reads the CPU's cycle counter (rdtsc on x86, cntvct_el0 on
+// AArch64) and converts it to nanoseconds with a factor calibrated once at
+// startup, so a timestamp costs a few nanoseconds instead of a vDSO (or,
+// on some VMs, a real) clock_gettime call. It is only used when the counter
+// is invariant (constant rate, never stops); otherwise, or when asked to,
+// it falls back to std::chrono::steady_clock. Either way it is monotonic.
+//
+// CoarseClock is a wall clock the kernel caches (CLOCK_REALTIME_COARSE):
+// reading it is cheaper still, but it only moves once per scheduler tick
+// (1-4 ms), so it is for uptime and human-facing times, never latencies.
+//
+// Call CycleClock::init() once, before other threads read the clock.
+
+enum class ClockSource {
+    Auto,       // Cycle counter when invariant, else steady_clock
+    Steady      // Always std::chrono::steady_clock
+};
+
+namespace clock_detail {
+
+struct Calibration {
+    bool use_counter = false;       // false: CycleClock::now() reads steady_clock
+    uint64_t base_counter = 0;      // Counter value at base_ns
+    int64_t base_ns = 0;            // steady_clock nanoseconds at calibration
+    double ns_per_count = 0.0;
+};
+
+// Written by CycleClock::init() only; read-only afterwards
+inline Calibration g_calibration;
+
+inline int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint64_t readCounter() {
+#if defined(STOCK_SIMULATOR_HAS_TSC)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(steadyNanoseconds());
+#endif
+}
+
+// True if the counter ticks at a constant rate across power states
+inline bool counterInvariant() {
+#if defined(STOCK_SIMULATOR_HAS_TSC) && !defined(_MSC_VER)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+    return (edx >> 8) & 1;      // Invariant TSC
+#elif defined(__aarch64__)
+    return true;                // The generic timer runs at a fixed frequency
+#else
+    return false;
+#endif
+}
+
+}  // namespace clock_detail
+
+// Calibrated cycle-counter clock (std::chrono Clock requirements)
+class CycleClock {
+public:
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<CycleClock>;
+    static constexpr bool is_steady = true;
+    
+    /**
+     * @brief Calibrate the counter against steady_clock (spins ~calibration_ms)
+     *
+     * Until this runs, now() reads steady_clock. Times share steady_clock's
+     * epoch either way.
+     */
+    static void init(ClockSource source = ClockSource::Auto, int calibration_ms = 20) {
+        clock_detail::Calibration c;
+        if (source == ClockSource::Auto && clock_detail::counterInvariant()) {
+            // Bracket the interval so both ends pair a counter read with a steady read
+            uint64_t counter_start = clock_detail::readCounter();
+            int64_t ns_start = clock_detail::steadyNanoseconds();
+            int64_t ns_end = ns_start;
+            while (ns_end - ns_start < calibration_ms * 1000000LL) {
+                ns_end = clock_detail::steadyNanoseconds();
+            }
+            uint64_t counter_end = clock_detail::readCounter();
+            if (counter_end > counter_start) {
+                c.use_counter = true;
+                c.base_counter = counter_start;
+                c.base_ns = ns_start;
+                c.ns_per_count = static_cast<double>(ns_end - ns_start) /
+                                 static_cast<double>(counter_end - counter_start);
+            }
+        }
+        clock_detail::g_calibration = c;
+    }
+    
+    static time_point now() noexcept {
+        const clock_detail::Calibration& c = clock_detail::g_calibration;
+        if (!c.use_counter) {
+            return time_point(duration(clock_detail::steadyNanoseconds()));
+        }
+        auto elapsed = static_cast<int64_t>(clock_detail::readCounter() - c.base_counter);
+        return time_point(duration(c.base_ns + static_cast<int64_t>(elapsed * c.ns_per_count)));
+    }
+    
+    static bool usesCounter() { return clock_detail::g_calibration.use_counter; }
+    
+    // Counter frequency in GHz (0 when reading steady_clock)
+    static double counterGhz() {
+        const clock_detail::Calibration& c = clock_detail::g_calibration;
+        return c.use_counter ? 1.0 / c.ns_per_count : 0.0;
+    }
+    
+    static const char* name() {
+        if (!usesCounter()) return "steady_clock";
+#if defined(STOCK_SIMULATOR_HAS_TSC)
+        return "rdtsc";
+#else
+        return "cntvct_el0";
+#endif
+    }
+};
+
+// Kernel-cached wall clock: cheap, monotonic only in practice, 1-4 ms steps
+class CoarseClock {
+public:
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<CoarseClock>;
+    static constexpr bool is_steady = false;
+    
+    static time_point now() noexcept {
+#if defined(CLOCK_REALTIME_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return time_point(duration(static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec));
+#else
+        return time_point(std::chrono::duration_cast<duration>(
+            std::chrono::system_clock::now().time_since_epoch()));
+#endif
+    }
+    
+    static std::chrono::system_clock::time_point toSystem(time_point t) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(t.time_since_epoch()));
+    }
+};
+
+// Clock used for tick timestamps and latency measurement
+using TickClock = CycleClock;
+
+#endif // CLOCK_H
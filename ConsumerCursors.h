@@ -0,0 +1,129 @@
+#ifndef CONSUMER_CURSORS_H
+#define CONSUMER_CURSORS_H
+
+#include "SymbolRegistry.h"
+#include "ShardedCounter.h"
+#include "BarAggregator.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What SharedBuffer does when a consumer falls behind the producer.
+enum class OverloadPolicy {
+    DropOldest,         // Ring overwrites unread ticks; the consumer catches up on the rest (original)
+    ConflateLatest,     // Past the lag limit, skip straight to the newest tick
+    BlockProducer       // Producer waits until the consumer is back under the lag limit
+};
+
+inline const char* overloadPolicyName(OverloadPolicy policy) {
+    switch (policy) {
+        case OverloadPolicy::DropOldest: return "drop-oldest";
+        case OverloadPolicy::ConflateLatest: return "conflate";
+        case OverloadPolicy::BlockProducer: return "block";
+    }
+    return "?";
+}
+
+using ConsumerId = uint16_t;
+constexpr ConsumerId kNoConsumer = 0xFFFF;
+
+// One consumer's lag and loss, as SharedBuffer::getStats() reports it
+struct ConsumerStats {
+    std::string name;
+    OverloadPolicy policy = OverloadPolicy::DropOldest;
+    uint64_t lag_limit = 0;
+    BarResolution resolution = BarResolution::Tick;     // Unit of the counts below: ticks or bars
+    uint64_t lag = 0;           // Ticks published but not read yet, all symbols
+    uint64_t worst_lag = 0;     // Of those, the most on one symbol
+    uint64_t peak_lag = 0;      // Most ticks one read ever found waiting
+    uint64_t dropped = 0;       // Overwritten before they were read
+    uint64_t conflated = 0;     // Skipped on purpose (ConflateLatest)
+};
+
+// Read cursors of the buffer's registered consumers.
+//
+// Every consumer (an indicator calculator) gets one cursor per symbol: the
+// ring sequence number it has read up to. The consumer's worker stores it
+// after each read; producers only load it, to apply BlockProducer, and
+// getStats() loads it to report lag. Cursors of one consumer are packed:
+// the scheduler hands out runs of neighbouring symbols, so workers only
+// share a cursor line at the edges of their runs.
+//
+// Consumers are registered before any thread starts and never removed,
+// so the table is read without a lock.
+class ConsumerCursors {
+public:
+    struct Consumer {
+        std::string name;
+        OverloadPolicy policy = OverloadPolicy::DropOldest;
+        uint64_t lag_limit = 1;
+        BarResolution resolution = BarResolution::Tick;     // Cursors count bars unless Tick
+        std::unique_ptr<std::atomic<uint64_t>[]> cursors;  // Indexed by symbol ID
+        ShardedCounter dropped;
+        ShardedCounter conflated;
+        std::atomic<uint64_t> peak_lag{0};
+        
+        // Record a read that found lag ticks waiting (rarely writes)
+        void notePeak(uint64_t lag) {
+            uint64_t peak = peak_lag.load(std::memory_order_relaxed);
+            while (lag > peak && !peak_lag.compare_exchange_weak(peak, lag, std::memory_order_relaxed)) {
+            }
+        }
+    };
+
+private:
+    size_t symbols_;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+    std::vector<const Consumer*> blocking_;     // BlockProducer consumers only
+
+public:
+    explicit ConsumerCursors(size_t symbols) : symbols_(symbols) {}
+    
+    ConsumerId add(const std::string& name, BarResolution resolution, uint64_t lag_limit) {
+        auto consumer = std::make_unique<Consumer>();
+        consumer->name = name;
+        consumer->resolution = resolution;
+        consumer->lag_limit = lag_limit;
+        consumer->cursors = std::make_unique<std::atomic<uint64_t>[]>(symbols_);
+        for (size_t id = 0; id < symbols_; ++id) consumer->cursors[id].store(0, std::memory_order_relaxed);
+        consumers_.push_back(std::move(consumer));
+        return static_cast<ConsumerId>(consumers_.size() - 1);
+    }
+    
+    void setPolicy(ConsumerId id, OverloadPolicy policy, uint64_t lag_limit) {
+        Consumer& consumer = *consumers_[id];
+        consumer.policy = policy;
+        consumer.lag_limit = lag_limit;
+        blocking_.clear();
+        for (const auto& c : consumers_) {
+            if (c->policy == OverloadPolicy::BlockProducer) blocking_.push_back(c.get());
+        }
+    }
+    
+    bool contains(ConsumerId id) const { return id < consumers_.size(); }
+    size_t size() const { return consumers_.size(); }
+    
+    Consumer& operator[](ConsumerId id) { return *consumers_[id]; }
+    const Consumer& operator[](ConsumerId id) const { return *consumers_[id]; }
+    
+    bool anyBlocking() const { return !blocking_.empty(); }
+    
+    /**
+     * @brief True if the symbol's tick number sequence stays within every
+     *        blocking consumer's lag limit
+     */
+    bool hasRoom(SymbolId symbol, uint64_t sequence) const {
+        for (const Consumer* consumer : blocking_) {
+            uint64_t cursor = consumer->cursors[symbol].load(std::memory_order_acquire);
+            if (sequence > cursor && sequence - cursor > consumer->lag_limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // CONSUMER_CURSORS_H
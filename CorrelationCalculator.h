@@ -0,0 +1,268 @@
+#ifndef CORRELATION_CALCULATOR_H
+#define CORRELATION_CALCULATOR_H
+
+#include "PriceData.h"
+#include "SharedBuffer.h"
+#include "CorrelationMatrix.h"
+#include "WorkStealingExecutor.h"
+#include "ThreadPlacement.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Two symbols and the correlation of their returns
+struct CorrelatedPair {
+    SymbolId first = 0;
+    SymbolId second = 0;
+    double correlation = 0.0;
+};
+
+// Totals of a CorrelationCalculator, as getStats() reports them
+struct CorrelationStats {
+    size_t symbols = 0;
+    size_t window = 0;
+    size_t samples = 0;             // In the window now
+    uint64_t samples_added = 0;
+    uint64_t sweeps = 0;
+    uint64_t rebuilds = 0;
+    uint64_t sweep_ns_total = 0;    // Time in update(), all sweeps
+    uint64_t sweep_ns_max = 0;
+    size_t matrix_bytes = 0;
+};
+
+// Rolling correlation matrix of every symbol's returns, for a risk view
+// across the universe.
+//
+// Per-symbol indicators see each symbol's ticks on their own clock; a
+// cross-symbol matrix needs returns taken at the same time. So every
+// sample interval the calculator reads the latest-price board in one pass
+// and derives each symbol's simple return since the previous sample, as
+// VolatilityCalculator does between ticks. A symbol with no new tick in
+// the interval contributes a zero return (previous-tick sampling), which
+// also holds for delisted symbols: their correlations fade out of the
+// window instead of being reset.
+//
+// Each sample is one rank-1 update of a RollingCovariance over every
+// symbol slot (see CorrelationMatrix.h), swept in parallel on the
+// indicator executor when one is given. A sweep that overruns the
+// interval delays the next sample rather than queueing samples up.
+//
+// Reads the board only, not the history rings, so it has no cursor (and
+// no overload policy) in the buffer.
+class CorrelationCalculator {
+public:
+    static constexpr size_t kMaxMatrixBytes = size_t(1) << 30;
+
+private:
+    SharedBuffer& buffer_;                  // Reference to shared buffer
+    std::atomic<bool> running_;             // Thread-safe shutdown flag
+    std::thread thread_;                    // Worker thread
+    int sample_interval_ms_;
+    size_t log_every_ = 10;                 // Console line every n-th sample (0 = never)
+    
+    // Sampling scratch, indexed by symbol ID
+    std::vector<PriceData> latest_;
+    std::vector<uint64_t> versions_;
+    std::vector<double> previous_;          // Price at the previous sample (0 = none yet)
+    std::vector<double> returns_;
+    std::vector<double> inverse_stddev_;    // Scratch of strongestPairs()
+    SymbolTable::Reader listed_;            // Symbols strongestPairs() ranks (under matrix_mutex_)
+    
+    mutable std::mutex matrix_mutex_;       // Sampling thread vs. report readers
+    RollingCovariance matrix_;
+    uint64_t sweep_ns_total_ = 0;
+    uint64_t sweep_ns_max_ = 0;
+    
+    // Take one sample of every symbol slot and stage it
+    void sample() {
+        buffer_.snapshotLatest(latest_, versions_);
+        for (size_t id = 0; id < returns_.size(); ++id) {
+            double price = versions_[id] ? latest_[id].price : 0.0;
+            double prev = previous_[id];
+            returns_[id] = (prev > 0.0 && price > 0.0) ? (price - prev) / prev : 0.0;
+            if (price > 0.0) previous_[id] = price;
+        }
+        matrix_.add(returns_.data());
+    }
+
+public:
+    /**
+     * @param window Samples the matrix covers
+     * @param executor Pool that runs the sweeps' tile runs; nullptr sweeps
+     *                 on the calculator's own thread
+     */
+    CorrelationCalculator(SharedBuffer& buffer, size_t window = 100, int sample_interval_ms = 100,
+                          WorkStealingExecutor* executor = nullptr)
+        : buffer_(buffer), running_(false), sample_interval_ms_(sample_interval_ms),
+          previous_(buffer.registry().capacity(), 0.0), returns_(buffer.registry().capacity(), 0.0),
+          inverse_stddev_(buffer.registry().capacity(), 0.0), listed_(buffer.symbolTable()),
+          matrix_(buffer.registry().capacity(), window, executor) {}
+    
+    ~CorrelationCalculator() {
+        stop();
+    }
+    
+    CorrelationCalculator(const CorrelationCalculator&) = delete;
+    CorrelationCalculator& operator=(const CorrelationCalculator&) = delete;
+    
+    /**
+     * @brief Heap the matrix would take for buffer's symbol slots
+     *        (constructing one above kMaxMatrixBytes is refused by main)
+     */
+    static size_t memoryBytes(const SharedBuffer& buffer, size_t window) {
+        return RollingCovariance::memoryBytes(buffer.registry().capacity(), window);
+    }
+    
+    void start() {
+        bool expected = false;
+        if (running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&CorrelationCalculator::run, this);
+            std::cout << "[CorrelationCalculator] Started correlation thread (ID: " << thread_.get_id()
+                      << ") over " << matrix_.dims() << " symbol slots, window " << matrix_.window()
+                      << " samples every " << sample_interval_ms_ << " ms\n";
+        }
+    }
+    
+    void stop() {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+                std::cout << "[CorrelationCalculator] Correlation thread stopped\n";
+            }
+        }
+    }
+    
+    /**
+     * @brief Print every n-th sample's summary to the console (0 = never)
+     */
+    void setLogEvery(size_t n) { log_every_ = n; }
+    
+    /**
+     * @brief Take one sample now and apply it (the thread's loop body; for
+     *        driving the calculator without start())
+     */
+    void step() {
+        std::lock_guard<std::mutex> lock(matrix_mutex_);
+        sample();
+        
+        TRACE_SPAN("correlation");
+        auto sweep_start = std::chrono::steady_clock::now();
+        matrix_.update();
+        uint64_t sweep_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - sweep_start).count());
+        sweep_ns_total_ += sweep_ns;
+        sweep_ns_max_ = std::max(sweep_ns_max_, sweep_ns);
+    }
+    
+    double correlation(SymbolId a, SymbolId b) const {
+        std::lock_guard<std::mutex> lock(matrix_mutex_);
+        return matrix_.correlation(a, b);
+    }
+    
+    double covariance(SymbolId a, SymbolId b) const {
+        std::lock_guard<std::mutex> lock(matrix_mutex_);
+        return matrix_.covariance(a, b);
+    }
+    
+    /**
+     * @brief The count most correlated pairs of listed symbols, strongest
+     *        |correlation| first (one pass over the matrix)
+     */
+    void strongestPairs(size_t count, std::vector<CorrelatedPair>& out) {
+        out.clear();
+        if (count == 0) return;
+        
+        std::lock_guard<std::mutex> lock(matrix_mutex_);
+        listed_.refresh();
+        std::fill(inverse_stddev_.begin(), inverse_stddev_.end(), 0.0);
+        for (SymbolId id : listed_.symbols()) {
+            double variance = matrix_.variance(id);
+            if (variance > 0.0) inverse_stddev_[id] = 1.0 / std::sqrt(variance);
+        }
+        
+        // Delisted and flat symbols have no inverse deviation: correlation 0
+        auto weaker = [](const CorrelatedPair& a, const CorrelatedPair& b) {
+            return std::fabs(a.correlation) > std::fabs(b.correlation);
+        };
+        matrix_.forEachPair([&](size_t i, size_t j, double covariance) {
+            double scale = inverse_stddev_[i] * inverse_stddev_[j];
+            if (scale == 0.0) return;
+            double correlation = std::max(-1.0, std::min(1.0, covariance * scale));
+            if (out.size() == count && std::fabs(correlation) <= std::fabs(out.front().correlation)) return;
+            if (out.size() == count) {
+                std::pop_heap(out.begin(), out.end(), weaker);
+                out.pop_back();
+            }
+            out.push_back(CorrelatedPair{static_cast<SymbolId>(i), static_cast<SymbolId>(j), correlation});
+            std::push_heap(out.begin(), out.end(), weaker);
+        });
+        std::sort_heap(out.begin(), out.end(), weaker);
+    }
+    
+    CorrelationStats getStats() const {
+        std::lock_guard<std::mutex> lock(matrix_mutex_);
+        CorrelationStats stats;
+        stats.symbols = matrix_.dims();
+        stats.window = matrix_.window();
+        stats.samples = matrix_.samples();
+        stats.samples_added = matrix_.samplesAdded();
+        stats.sweeps = matrix_.sweeps();
+        stats.rebuilds = matrix_.rebuilds();
+        stats.sweep_ns_total = sweep_ns_total_;
+        stats.sweep_ns_max = sweep_ns_max_;
+        stats.matrix_bytes = RollingCovariance::memoryBytes(matrix_.dims(), matrix_.window());
+        return stats;
+    }
+
+private:
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "CorrelationCalculator");
+        std::cout << "[CorrelationCalculator] Correlation loop starting...\n";
+        
+        std::vector<CorrelatedPair> strongest;
+        strongest.reserve(1);
+        auto next_sample = std::chrono::steady_clock::now();
+        uint64_t samples = 0;
+        
+        while (running_.load()) {
+            // Fixed sample clock; a sweep that overran the interval is not made up for
+            next_sample += std::chrono::milliseconds(sample_interval_ms_);
+            auto now = std::chrono::steady_clock::now();
+            if (next_sample > now) {
+                std::this_thread::sleep_until(next_sample);
+            } else {
+                next_sample = now;
+            }
+            if (!running_.load() || buffer_.isShutdown()) break;
+            
+            step();
+            ++samples;
+            
+            if (log_every_ > 0 && samples % log_every_ == 0) {
+                strongestPairs(1, strongest);
+                CorrelationStats stats = getStats();
+                std::cout << "\n[CorrelationCalculator] " << stats.symbols << " symbols x " << stats.samples
+                          << " samples | sweep " << std::fixed << std::setprecision(2)
+                          << stats.sweep_ns_total / 1e6 / std::max<uint64_t>(stats.sweeps, 1) << " ms avg";
+                if (!strongest.empty()) {
+                    const SymbolRegistry& registry = buffer_.registry();
+                    std::cout << " | strongest: " << registry.name(strongest[0].first) << "/"
+                              << registry.name(strongest[0].second) << " " << std::showpos
+                              << strongest[0].correlation << std::noshowpos;
+                }
+                std::cout << "\n";
+            }
+        }
+        
+        std::cout << "\n[CorrelationCalculator] Correlation loop exited after " << samples << " samples\n";
+    }
+};
+
+#endif // CORRELATION_CALCULATOR_H
@@ -0,0 +1,278 @@
+#ifndef CORRELATION_MATRIX_H
+#define CORRELATION_MATRIX_H
+
+#include "AlignedArray.h"
+#include "SimdKernels.h"
+#include "WorkStealingExecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Rolling covariance (and correlation) matrix of N return series over the
+// last window samples.
+//
+// A sample is one return per series, all taken at the same time. The
+// matrix keeps running sums over the window, sum(r_i) and sum(r_i * r_j),
+// so a new sample is a rank-1 update of the cross sums (plus a rank-1
+// downdate for the sample leaving the window) instead of a recompute over
+// the whole window: O(N^2) per sample rather than O(N^2 * window).
+//
+// Only the upper triangle is stored, as kTile x kTile tiles packed row by
+// row, so one sweep streams each tile once and a tile (8 KB) stays in L1
+// while every staged sample is applied to it: with k samples staged, the
+// cross sums are read and written once instead of k times. Sweeps are
+// split into runs of tiles on a WorkStealingExecutor (or run inline), and
+// each tile row is updated by simd::rankUpdate.
+//
+// Adding and removing samples leaves rounding error in the sums; they are
+// rebuilt from the samples in the window every kRebuildWindows windows.
+//
+// Not thread-safe: one thread adds samples and reads results (the sweep's
+// executor tasks are internal).
+class RollingCovariance {
+public:
+    static constexpr size_t kTile = 32;             // Tile edge in doubles
+    static constexpr size_t kMaxStaged = 8;         // Samples applied per sweep
+    static constexpr size_t kTilesPerTask = 16;     // Executor task size (128 KB of sums)
+    static constexpr size_t kRebuildWindows = 64;
+
+private:
+    size_t dims_;
+    size_t padded_;                 // dims_ rounded up to kTile (padding stays 0)
+    size_t tiles_per_edge_;
+    size_t window_;
+    
+    // Ring of window_ + kMaxStaged samples, padded_ returns each: the window
+    // starts at head_, staged samples follow it
+    size_t ring_rows_;
+    AlignedArray<double> samples_;
+    size_t head_ = 0;
+    size_t count_ = 0;              // Samples in the sums (at most window_)
+    size_t staged_ = 0;
+    
+    AlignedArray<double> sums_;             // sum(r_i) over the window
+    AlignedArray<double> cross_;            // sum(r_i * r_j), packed upper-triangle tiles
+    std::vector<std::pair<uint32_t, uint32_t>> tiles_;     // Packed index -> (tile row, tile column)
+    
+    // The sweep being applied: rows added (+1) and removed (-1)
+    const double* sweep_rows_[2 * kMaxStaged];
+    double sweep_signs_[2 * kMaxStaged];
+    size_t sweep_size_ = 0;
+    
+    WorkStealingExecutor* executor_;
+    std::vector<ExecutorTask> tasks_;
+    TaskGroup group_;
+    
+    uint64_t samples_added_ = 0;
+    uint64_t sweeps_ = 0;
+    uint64_t rebuilds_ = 0;
+    size_t since_rebuild_ = 0;      // Samples applied since the sums were rebuilt
+    
+    double* row(size_t ring_row) { return samples_.data() + ring_row * padded_; }
+    
+    // Packed index of tile (tile_row, tile_col), tile_row <= tile_col
+    size_t tileIndex(size_t tile_row, size_t tile_col) const {
+        return tile_row * tiles_per_edge_ - tile_row * (tile_row - 1) / 2 + (tile_col - tile_row);
+    }
+    
+    // Apply the sweep to tiles [first, last) of the packed order
+    void sweepTiles(size_t first, size_t last) {
+        const double* rows[2 * kMaxStaged];
+        double coeffs[2 * kMaxStaged];
+        const size_t m = sweep_size_;
+        
+        for (size_t t = first; t < last; ++t) {
+            size_t tile_row = tiles_[t].first;
+            size_t tile_col = tiles_[t].second;
+            double* out = cross_.data() + t * kTile * kTile;
+            
+            for (size_t k = 0; k < m; ++k) rows[k] = sweep_rows_[k] + tile_col * kTile;
+            for (size_t r = 0; r < kTile; ++r) {
+                size_t i = tile_row * kTile + r;
+                for (size_t k = 0; k < m; ++k) coeffs[k] = sweep_signs_[k] * sweep_rows_[k][i];
+                simd::rankUpdate(out + r * kTile, kTile, rows, coeffs, m);
+            }
+        }
+    }
+    
+    static void runTask(void* context, size_t task) {
+        auto* self = static_cast<RollingCovariance*>(context);
+        size_t first = task * kTilesPerTask;
+        self->sweepTiles(first, std::min(first + kTilesPerTask, self->tiles_.size()));
+    }
+    
+    // Apply sweep_rows_ to sums_ and cross_
+    void sweep() {
+        simd::rankUpdate(sums_.data(), padded_, sweep_rows_, sweep_signs_, sweep_size_);
+        if (executor_ && tasks_.size() > 1) {
+            executor_->submit(tasks_.data(), tasks_.size());
+            executor_->wait(group_);
+        } else {
+            sweepTiles(0, tiles_.size());
+        }
+        ++sweeps_;
+    }
+
+public:
+    /**
+     * @param dims Number of series (symbols)
+     * @param window Samples the sums cover (at least 2)
+     * @param executor Runs a sweep's tile runs in parallel; nullptr sweeps
+     *                 on the calling thread
+     */
+    RollingCovariance(size_t dims, size_t window, WorkStealingExecutor* executor = nullptr)
+        : dims_(dims), padded_((dims + kTile - 1) / kTile * kTile), tiles_per_edge_(padded_ / kTile),
+          window_(std::max<size_t>(window, 2)), ring_rows_(window_ + kMaxStaged),
+          samples_(ring_rows_ * padded_), sums_(padded_),
+          cross_(tiles_per_edge_ * (tiles_per_edge_ + 1) / 2 * kTile * kTile),
+          executor_(executor) {
+        for (size_t tile_row = 0; tile_row < tiles_per_edge_; ++tile_row) {
+            for (size_t tile_col = tile_row; tile_col < tiles_per_edge_; ++tile_col) {
+                tiles_.emplace_back(static_cast<uint32_t>(tile_row), static_cast<uint32_t>(tile_col));
+            }
+        }
+        size_t task_count = (tiles_.size() + kTilesPerTask - 1) / kTilesPerTask;
+        for (size_t task = 0; task < task_count; ++task) {
+            tasks_.push_back(ExecutorTask{&RollingCovariance::runTask, this, task, &group_});
+        }
+    }
+    
+    RollingCovariance(const RollingCovariance&) = delete;
+    RollingCovariance& operator=(const RollingCovariance&) = delete;
+    
+    /**
+     * @brief Heap a matrix over dims series needs (sums and sample window)
+     */
+    static size_t memoryBytes(size_t dims, size_t window) {
+        size_t padded = (dims + kTile - 1) / kTile * kTile;
+        size_t edge = padded / kTile;
+        return (edge * (edge + 1) / 2 * kTile * kTile + (window + kMaxStaged + 1) * padded) * sizeof(double);
+    }
+    
+    size_t dims() const { return dims_; }
+    size_t window() const { return window_; }
+    size_t samples() const { return count_; }           // In the window, applied
+    uint64_t samplesAdded() const { return samples_added_; }
+    uint64_t sweeps() const { return sweeps_; }
+    uint64_t rebuilds() const { return rebuilds_; }
+    
+    /**
+     * @brief Stage one sample of dims() returns
+     *
+     * Staged samples count once update() applies them (which add() does
+     * itself once kMaxStaged are waiting).
+     */
+    void add(const double* returns) {
+        if (staged_ == kMaxStaged) update();
+        std::memcpy(row((head_ + count_ + staged_) % ring_rows_), returns, dims_ * sizeof(double));
+        ++staged_;
+        ++samples_added_;
+    }
+    
+    /**
+     * @brief Apply the staged samples in one sweep over the matrix
+     *
+     * Each one is added to the sums; once the window is full, the oldest
+     * sample is removed in the same sweep.
+     */
+    void update() {
+        if (staged_ == 0) return;
+        
+        sweep_size_ = 0;
+        size_t head = head_;
+        size_t count = count_;
+        for (size_t s = 0; s < staged_; ++s) {
+            sweep_rows_[sweep_size_] = row((head + count) % ring_rows_);
+            sweep_signs_[sweep_size_++] = 1.0;
+            if (count == window_) {
+                sweep_rows_[sweep_size_] = row(head);
+                sweep_signs_[sweep_size_++] = -1.0;
+                head = (head + 1) % ring_rows_;
+            } else {
+                ++count;
+            }
+        }
+        sweep();
+        
+        head_ = head;
+        count_ = count;
+        since_rebuild_ += staged_;
+        staged_ = 0;
+        if (since_rebuild_ >= kRebuildWindows * window_) rebuild();
+    }
+    
+    /**
+     * @brief Recompute the sums from the samples in the window
+     *
+     * What every update would cost without the running sums:
+     * O(N^2 * window).
+     */
+    void rebuild() {
+        update();
+        std::memset(sums_.data(), 0, sums_.size() * sizeof(double));
+        std::memset(cross_.data(), 0, cross_.size() * sizeof(double));
+        for (size_t s = 0; s < count_; ) {
+            sweep_size_ = 0;
+            for (; s < count_ && sweep_size_ < 2 * kMaxStaged; ++s) {
+                sweep_rows_[sweep_size_] = row((head_ + s) % ring_rows_);
+                sweep_signs_[sweep_size_++] = 1.0;
+            }
+            sweep();
+        }
+        since_rebuild_ = 0;
+        ++rebuilds_;
+    }
+    
+    /**
+     * @brief Sample covariance of series i and j over the window (0 before 2 samples)
+     */
+    double covariance(size_t i, size_t j) const {
+        if (count_ < 2) return 0.0;
+        if (i > j) std::swap(i, j);
+        const double* tile = cross_.data() + tileIndex(i / kTile, j / kTile) * kTile * kTile;
+        double cross = tile[(i % kTile) * kTile + j % kTile];
+        double n = static_cast<double>(count_);
+        return (cross - sums_[i] * sums_[j] / n) / (n - 1.0);
+    }
+    
+    double variance(size_t i) const { return covariance(i, i); }
+    
+    /**
+     * @brief Pearson correlation of series i and j, in [-1, 1]
+     *        (0 when either did not move over the window)
+     */
+    double correlation(size_t i, size_t j) const {
+        double scale = variance(i) * variance(j);
+        if (!(scale > 0.0)) return 0.0;
+        return std::max(-1.0, std::min(1.0, covariance(i, j) / std::sqrt(scale)));
+    }
+    
+    /**
+     * @brief Call visit(i, j, covariance) for every pair i < j < dims(), in
+     *        tile order (one pass over the sums; nothing if under 2 samples)
+     */
+    template <typename Visit>
+    void forEachPair(Visit visit) const {
+        if (count_ < 2) return;
+        const double n = static_cast<double>(count_);
+        for (size_t t = 0; t < tiles_.size(); ++t) {
+            size_t i0 = tiles_[t].first * kTile;
+            size_t j0 = tiles_[t].second * kTile;
+            const double* tile = cross_.data() + t * kTile * kTile;
+            for (size_t r = 0; r < kTile && i0 + r < dims_; ++r) {
+                size_t i = i0 + r;
+                size_t c = (i0 == j0) ? r + 1 : 0;     // Diagonal tiles: above the diagonal only
+                for (; c < kTile && j0 + c < dims_; ++c) {
+                    size_t j = j0 + c;
+                    visit(i, j, (tile[r * kTile + c] - sums_[i] * sums_[j] / n) / (n - 1.0));
+                }
+            }
+        }
+    }
+};
+
+#endif // CORRELATION_MATRIX_H
@@ -0,0 +1,107 @@
+#ifndef DISPLAY_RENDERER_H
+#define DISPLAY_RENDERER_H
+
+#include "PriceData.h"
+#include "SharedBuffer.h"
+#include "FastFormat.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Formats the latest price of every symbol into one console frame.
+//
+// Each render() takes a single snapshot of all latest ticks
+// (SharedBuffer::snapshotLatest) and re-formats only the rows, one per
+// symbol, whose ring sequence moved since the last frame. Unchanged rows
+// are copied from their cached text, and if no row changed there is no
+// frame at all. Numbers go through fastfmt, not iostreams, and every
+// buffer is reused, so steady-state rendering does not allocate.
+//
+// Only listed symbols are shown (SymbolTable); a listing change redraws
+// the frame with the new set of rows.
+//
+// A row reads e.g. "AAPL: $  187.34 UP  +0.42 | ".
+class DisplayRenderer {
+public:
+    static constexpr size_t kRowCapacity = 96;     // Bytes reserved per cached row
+
+private:
+    SharedBuffer& buffer_;
+    SymbolTable::Reader listed_;
+    std::vector<PriceData> latest_;             // Snapshot, by symbol ID
+    std::vector<uint64_t> sequences_;           // Sequence of each snapshot entry
+    std::vector<uint64_t> drawn_;               // Sequence each cached row shows
+    std::vector<char> rows_;                    // kRowCapacity bytes per symbol
+    std::vector<uint8_t> row_lengths_;
+    
+    size_t frames_ = 0;
+    size_t rows_formatted_ = 0;
+    
+    static size_t append(char* out, const char* text, size_t len) {
+        std::memcpy(out, text, len);
+        return len;
+    }
+    
+    // Format one row into its cache slot
+    void formatRow(SymbolId symbol) {
+        const PriceData& data = latest_[symbol];
+        const std::string& name = buffer_.registry().name(symbol);
+        char* out = rows_.data() + symbol * kRowCapacity;
+        
+        // Name, truncated so the numbers and separators always fit the slot
+        size_t limit = kRowCapacity - 2 * fastfmt::kMaxFixed - 10;
+        size_t n = append(out, name.data(), name.size() < limit ? name.size() : limit);
+        n += append(out + n, ": $", 3);
+        n += fastfmt::fixed(out + n, data.price, 2, 8);
+        // ASCII-only direction indicator for better Windows console compatibility
+        n += append(out + n, (data.change >= 0) ? " UP " : " DN ", 4);
+        n += fastfmt::fixed(out + n, data.change, 2, 6, true);
+        n += append(out + n, " | ", 3);
+        
+        row_lengths_[symbol] = static_cast<uint8_t>(n);
+        drawn_[symbol] = sequences_[symbol];
+        ++rows_formatted_;
+    }
+
+public:
+    explicit DisplayRenderer(SharedBuffer& buffer) : buffer_(buffer), listed_(buffer.symbolTable()) {
+        size_t symbols = buffer_.registry().capacity();
+        drawn_.assign(symbols, 0);
+        rows_.assign(symbols * kRowCapacity, ' ');
+        row_lengths_.assign(symbols, 0);
+    }
+    
+    /**
+     * @brief Render the current prices into frame (replacing its contents)
+     * @return false (frame left empty) if no symbol changed since the last frame
+     */
+    bool render(std::string& frame) {
+        frame.clear();
+        buffer_.snapshotLatest(latest_, sequences_);
+        
+        bool changed = listed_.refresh();
+        for (SymbolId id : listed_.symbols()) {
+            if (sequences_[id] != drawn_[id]) {
+                formatRow(id);
+                changed = true;
+            }
+        }
+        if (!changed) {
+            return false;
+        }
+        
+        frame.push_back('\r');  // Carriage return for in-place update
+        for (SymbolId id : listed_.symbols()) {
+            if (sequences_[id] != 0) {
+                frame.append(rows_.data() + id * kRowCapacity, row_lengths_[id]);
+            }
+        }
+        ++frames_;
+        return true;
+    }
+    
+    size_t frames() const { return frames_; }
+    size_t rowsFormatted() const { return rows_formatted_; }
+};
+
+#endif // DISPLAY_RENDERER_H
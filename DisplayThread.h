@@ -3,27 +3,41 @@
 
 #include "PriceData.h"
 #include "SharedBuffer.h"
+#include "DisplayRenderer.h"
+#include "AsyncConsoleWriter.h"
+#include "ThreadPlacement.h"
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
+#include <string>
 
 // Periodically prints the latest prices to the console.
+//
+// The display thread only renders: DisplayRenderer turns one snapshot of
+// the buffer into a frame, redrawing just the symbols that changed, and
+// AsyncConsoleWriter puts it on the terminal from a thread of its own, so
+// a slow terminal never holds up rendering (or the buffer).
 class DisplayThread {
 private:
     SharedBuffer& buffer_;                  // Reference to shared buffer
     std::atomic<bool> running_;             // Thread-safe shutdown flag
     std::thread thread_;                    // Worker thread
     int refresh_interval_ms_;               // Display refresh rate
+    
+    DisplayRenderer renderer_;
+    std::unique_ptr<AsyncConsoleWriter> writer_;    // Exists while running
+    std::string frame_;                     // Frame being rendered, reused
 
 public:
     DisplayThread(SharedBuffer& buffer, int refresh_interval_ms = 500)
-        : buffer_(buffer), running_(false), refresh_interval_ms_(refresh_interval_ms) {}
+        : buffer_(buffer), running_(false), refresh_interval_ms_(refresh_interval_ms),
+          renderer_(buffer) {}
     
     void start() {
         bool expected = false;
         if (running_.compare_exchange_strong(expected, true)) {
+            writer_ = std::make_unique<AsyncConsoleWriter>();
             thread_ = std::thread(&DisplayThread::run, this);
             std::cout << "[DisplayThread] Started display thread (ID: " 
                       << thread_.get_id() << ")\n";
@@ -34,8 +48,11 @@ public:
         if (running_.exchange(false)) {
             if (thread_.joinable()) {
                 thread_.join();
-                std::cout << "[DisplayThread] Display thread stopped\n";
             }
+            writer_->stop();    // Flushes the last frame
+            std::cout << "\n[DisplayThread] Display thread stopped (" << renderer_.frames()
+                      << " frames, " << writer_->coalesced() << " coalesced, "
+                      << renderer_.rowsFormatted() << " rows formatted)\n";
         }
     }
     
@@ -45,6 +62,7 @@ public:
 
 private:
     void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Display, "DisplayThread");
         std::cout << "[DisplayThread] Display loop starting...\n";
         std::cout << "\n========== REAL-TIME STOCK PRICE MONITOR ==========\n\n";
         
@@ -55,39 +73,19 @@ private:
             
             if (!running_.load()) break;
             
-            // Get all symbols being tracked
-            auto symbols = buffer_.getSymbols();
-            
-            if (symbols.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
+            // One snapshot, changed rows only; nothing to draw if no symbol moved
+            bool changed;
+            {
+                TRACE_SPAN("display render");
+                changed = renderer_.render(frame_);
             }
-            
-            // Build display output
-            std::stringstream output;
-            output << "\r";  // Carriage return for in-place update
-            output << std::fixed << std::setprecision(2);
-            
-            // Display each symbol's latest price
-            for (const auto& symbol : symbols) {
-                PriceData data;
-                
-                // Read from shared buffer (CRITICAL SECTION handled internally)
-                if (buffer_.getLatest(symbol, data)) {
-                    // ASCII-only direction indicator for better Windows console compatibility
-                    std::string indicator = (data.change >= 0) ? "UP" : "DN";
-                    
-                    output << symbol << ": $" << std::setw(8) << data.price 
-                           << " " << indicator << " " 
-                           << std::setw(6) << std::showpos << data.change 
-                           << std::noshowpos << " | ";
-                }
+            if (changed) {
+                // Hand the frame to the writer thread (never waits for the terminal)
+                writer_->submit(frame_);
             }
             
-            // Print to console (non-blocking write)
-            std::cout << output.str() << std::flush;
-            
             // Sleep to control refresh rate
+            TRACE_SPAN("sleep");
             std::this_thread::sleep_for(std::chrono::milliseconds(refresh_interval_ms_));
         }
         
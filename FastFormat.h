@@ -0,0 +1,78 @@
+#ifndef FAST_FORMAT_H
+#define FAST_FORMAT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Allocation- and locale-free number formatting for the display path.
+//
+// Produces the same text as printf("%*.*f") / "%+*.*f" for the values the
+// simulator shows (a value within rounding error of a tie in the last digit
+// may round the other way), using integer arithmetic instead of iostream or printf
+// format parsing. Values too large for the integer path (or NaN/inf) fall
+// back to snprintf.
+namespace fastfmt {
+
+constexpr size_t kMaxFixed = 32;                // Output never exceeds this many chars
+
+/**
+ * @brief Write value with exactly decimals (0-9) digits after the point
+ * @param out At least max(width, kMaxFixed) chars; not NUL-terminated
+ * @param width Minimum field width (right-aligned, space padded)
+ * @param plus Print '+' for non-negative values
+ * @return Number of chars written
+ */
+inline size_t fixed(char* out, double value, int decimals, int width = 0, bool plus = false) {
+    static const uint64_t kPow10[] = {1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+                                      1000000ull, 10000000ull, 100000000ull, 1000000000ull};
+    if (decimals < 0) decimals = 0;
+    if (decimals > 9) decimals = 9;
+    
+    double magnitude = std::fabs(value);
+    if (!(magnitude < 1e15)) {
+        // Out of range for the integer path (or NaN/inf)
+        char tmp[64];
+        int n = std::snprintf(tmp, sizeof(tmp), plus ? "%+*.*f" : "%*.*f", width, decimals, value);
+        size_t len = (n < 0) ? 0 : (static_cast<size_t>(n) < kMaxFixed ? static_cast<size_t>(n) : kMaxFixed);
+        std::memcpy(out, tmp, len);
+        return len;
+    }
+    
+    uint64_t scale = kPow10[decimals];
+    auto scaled = static_cast<uint64_t>(std::llround(magnitude * static_cast<double>(scale)));
+    uint64_t whole = scaled / scale;
+    uint64_t fraction = scaled % scale;
+    
+    // Digits right to left into a scratch buffer
+    char digits[kMaxFixed];
+    size_t pos = kMaxFixed;
+    for (int i = 0; i < decimals; ++i) {
+        digits[--pos] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    if (decimals > 0) digits[--pos] = '.';
+    do {
+        digits[--pos] = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole > 0);
+    
+    // Like printf, a negative value that rounds to zero keeps its '-'
+    if (std::signbit(value)) {
+        digits[--pos] = '-';
+    } else if (plus) {
+        digits[--pos] = '+';
+    }
+    
+    size_t len = kMaxFixed - pos;
+    size_t padding = (width > 0 && static_cast<size_t>(width) > len) ? static_cast<size_t>(width) - len : 0;
+    std::memset(out, ' ', padding);
+    std::memcpy(out + padding, digits + pos, len);
+    return padding + len;
+}
+
+}  // namespace fastfmt
+
+#endif // FAST_FORMAT_H
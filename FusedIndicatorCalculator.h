@@ -0,0 +1,322 @@
+#ifndef FUSED_INDICATOR_CALCULATOR_H
+#define FUSED_INDICATOR_CALCULATOR_H
+
+#include "PriceData.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "IndicatorTask.h"
+#include "IndicatorKernels.h"
+#include "CacheLine.h"
+#include "ThreadPlacement.h"
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+// Evaluates any number of IndicatorKernels per symbol in one fused pass.
+//
+// For each symbol the new ticks are read from the buffer once (readSince)
+// and walked once; every registered kernel folds each tick in during that
+// same walk. SMA, EMA, volatility, VWAP, RSI, ... therefore share one fetch
+// and one traversal instead of each calculator re-reading the history.
+//
+// Runs either on its own thread (start()) or as per-symbol tasks on an
+// IndicatorScheduler.
+class FusedIndicatorCalculator : public IndicatorTask {
+private:
+    // Per-symbol state shared by all kernels, on its own cache line(s):
+    // executor workers update neighbouring symbols at the same time
+    struct alignas(kCacheLineSize) SymbolState {
+        uint64_t cursor = 0;        // Buffer sequence consumed so far
+        PriceData latest;           // Most recent tick folded in
+        bool has_price = false;     // latest holds a real tick
+    };
+    
+    SharedBuffer& buffer_;                  // Reference to shared buffer
+    PerformanceMonitor& perf_monitor_;     // Performance tracking
+    std::atomic<bool> running_;             // Thread-safe shutdown flag
+    std::thread thread_;                    // Worker thread
+    
+    int calculation_interval_ms_;           // Time between calculations (Poll) / wait timeout (Notify)
+    ConsumerWakeMode wake_mode_;            // Fixed-interval polling or epoch notification
+    BarResolution resolution_;              // Ticks, or closed bars of one size
+    std::string name_;                      // "Indicators", or e.g. "Indicators 1m" on bars
+    
+    std::vector<std::unique_ptr<IndicatorKernel>> kernels_;
+    std::vector<OperationId> operation_ids_;    // Per kernel, for the performance report
+    IndicatorSink* sink_ = nullptr;             // Binary output (attachOutput), if any
+    std::vector<uint16_t> output_ids_;          // Per kernel, in the sink
+    std::vector<SymbolState> states_;           // Indexed by symbol ID
+    ConsumerId consumer_;                       // Cursor (and overload policy) in the buffer
+    
+    alignas(kCacheLineSize) std::atomic<size_t> calculation_count_;   // Bumped by every worker
+
+public:
+    FusedIndicatorCalculator(SharedBuffer& buffer,
+                             PerformanceMonitor& perf_monitor,
+                             int calculation_interval_ms = 1000,
+                             ConsumerWakeMode wake_mode = ConsumerWakeMode::Poll,
+                             BarResolution resolution = BarResolution::Tick)
+        : buffer_(buffer), perf_monitor_(perf_monitor), running_(false),
+          calculation_interval_ms_(calculation_interval_ms), wake_mode_(wake_mode),
+          resolution_(resolution), name_(indicatorName("Indicators", resolution)),
+          states_(buffer.registry().capacity()),
+          consumer_(buffer.registerConsumer(name_, resolution)),
+          calculation_count_(0) {}
+    
+    /**
+     * @brief Register a kernel (before start() or scheduling)
+     * @return The kernel, owned by this calculator
+     */
+    IndicatorKernel& addKernel(std::unique_ptr<IndicatorKernel> kernel) {
+        kernel->resize(buffer_.registry().capacity());
+        operation_ids_.push_back(perf_monitor_.registerOperation(indicatorName(kernel->name(), resolution_)));
+        kernels_.push_back(std::move(kernel));
+        return *kernels_.back();
+    }
+    
+    template <typename Kernel, typename... Args>
+    Kernel& add(Args&&... args) {
+        return static_cast<Kernel&>(addKernel(std::make_unique<Kernel>(std::forward<Args>(args)...)));
+    }
+    
+    size_t kernelCount() const { return kernels_.size(); }
+    
+    void start() {
+        bool expected = false;
+        if (running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&FusedIndicatorCalculator::run, this);
+            std::cout << "[FusedIndicatorCalculator] Started indicator thread (ID: "
+                      << thread_.get_id() << ") with " << kernels_.size() << " kernels\n";
+        }
+    }
+    
+    void stop() {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+                std::cout << "[FusedIndicatorCalculator] Indicator thread stopped\n";
+            }
+        }
+    }
+    
+    ~FusedIndicatorCalculator() override {
+        stop();
+    }
+    
+    const char* name() const override { return name_.c_str(); }
+    
+    ConsumerId consumerId() const override { return consumer_; }
+    
+    /**
+     * @brief Send every kernel's results to sink (after the kernels are added)
+     */
+    void attachOutput(IndicatorSink& sink) override {
+        output_ids_.clear();
+        for (const auto& kernel : kernels_) {
+            output_ids_.push_back(sink.registerIndicator(indicatorName(kernel->name(), resolution_)));
+        }
+        sink_ = &sink;
+    }
+    
+    bool hasNewData(SymbolId symbol) const override {
+        return buffer_.sequence(symbol, resolution_) != states_[symbol].cursor;
+    }
+    
+    /**
+     * @brief Fold one symbol's new ticks into every kernel in a single pass
+     * @return false if no kernel has enough data yet
+     *
+     * Safe to call concurrently for different symbols (see IndicatorTask).
+     */
+    bool calculateSymbol(SymbolId symbol) override {
+        // Per-thread scratch: executor workers may run different symbols at once
+        thread_local TickBatch new_ticks;
+        
+        // One read of everything published since the last pass...
+        SymbolState& state = states_[symbol];
+        state.cursor = buffer_.consume(consumer_, symbol, state.cursor, new_ticks);
+        
+        // ...and one walk over it feeding all kernels
+        if (!new_ticks.empty()) {
+            TRACE_SPAN("compute");
+            IndicatorInput input;
+            input.prev_price = state.latest.price;
+            input.has_prev = state.has_price;
+            for (size_t i = 0; i < new_ticks.size(); ++i) {
+                input.price = new_ticks.prices[i];
+                input.volume = new_ticks.volumes[i];
+                for (auto& kernel : kernels_) {
+                    kernel->update(symbol, input);
+                }
+                input.prev_price = input.price;
+                input.has_prev = true;
+            }
+            state.latest = new_ticks.back();
+            state.has_price = true;
+        }
+        
+        // Record performance: latency from generation to calculation, per kernel
+        auto generation_time = state.latest.timestamp;
+        auto processing_time = TickClock::now();
+        bool any_ready = false;
+        for (size_t k = 0; k < kernels_.size(); ++k) {
+            if (kernels_[k]->ready(symbol)) {
+                perf_monitor_.recordProcessing(symbol, operation_ids_[k], generation_time, processing_time);
+                if (sink_) {
+                    sink_->emit(symbol, output_ids_[k], kernels_[k]->value(symbol), state.latest.price,
+                                generation_time, processing_time, state.cursor);
+                }
+                any_ready = true;
+            }
+        }
+        if (!any_ready) {
+            return false;  // Not enough data yet
+        }
+        
+        size_t count = ++calculation_count_;
+        
+        // Log a sample of the results
+        if (logSample(count)) {
+            std::cout << "\n[FusedIndicatorCalculator] " << buffer_.registry().name(symbol)
+                      << " - Price: $" << std::fixed << std::setprecision(2) << state.latest.price;
+            for (const auto& kernel : kernels_) {
+                if (kernel->ready(symbol)) {
+                    std::cout << " | " << kernel->label() << ": " << kernel->value(symbol);
+                }
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Checkpoint: kernel labels, then per symbol the cursor, latest
+     *        tick and every kernel's state
+     */
+    void saveState(CheckpointWriter& out) const override {
+        out.put(static_cast<uint32_t>(states_.size()));
+        out.put(static_cast<uint32_t>(kernels_.size()));
+        for (const auto& kernel : kernels_) {
+            out.putString(kernel->label());
+        }
+        for (size_t id = 0; id < states_.size(); ++id) {
+            const SymbolState& state = states_[id];
+            out.put(state.cursor);
+            out.put(state.latest);
+            out.put(static_cast<uint8_t>(state.has_price));
+            for (const auto& kernel : kernels_) {
+                kernel->save(static_cast<SymbolId>(id), out);
+            }
+        }
+    }
+    
+    /**
+     * @brief Restore saveState() output; needs the same symbols and kernels (by label)
+     */
+    bool loadState(CheckpointReader& in, TickClock::duration clock_shift) override {
+        uint32_t symbols = 0, kernels = 0;
+        if (!in.get(symbols) || !in.get(kernels) ||
+            symbols != states_.size() || kernels != kernels_.size()) {
+            return false;
+        }
+        std::string label;
+        for (const auto& kernel : kernels_) {
+            if (!in.getString(label) || label != kernel->label()) return false;
+        }
+        
+        for (size_t id = 0; id < states_.size(); ++id) {
+            SymbolState& state = states_[id];
+            uint8_t has_price = 0;
+            bool ok = in.get(state.cursor) && in.get(state.latest) && in.get(has_price);
+            for (auto& kernel : kernels_) {
+                ok = ok && kernel->load(static_cast<SymbolId>(id), in);
+            }
+            if (!ok) {
+                resetState();
+                return false;
+            }
+            state.has_price = (has_price != 0);
+            state.latest.timestamp += clock_shift;
+            if (resolution_ != BarResolution::Tick) state.cursor = 0;   // Bars are not checkpointed
+        }
+        for (size_t id = 0; id < states_.size(); ++id) {
+            buffer_.restoreCursor(consumer_, static_cast<SymbolId>(id), states_[id].cursor);
+        }
+        return true;
+    }
+
+private:
+    // Back to the state of a freshly constructed calculator
+    void resetState() {
+        states_.assign(states_.size(), SymbolState());
+        for (auto& kernel : kernels_) {
+            kernel->resize(states_.size());
+        }
+    }
+    
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "FusedIndicatorCalculator");
+        std::cout << "[FusedIndicatorCalculator] Indicator loop starting...\n";
+        
+        const bool notify = (wake_mode_ == ConsumerWakeMode::Notify);
+        uint64_t seen_epoch = 0;
+        SymbolTable::Reader listed(buffer_.symbolTable());     // Listed symbols, read in place
+        
+        while (running_.load()) {
+            if (notify) {
+                // Sleep until a tick newer than the last pass is pushed
+                uint64_t epoch = buffer_.waitForUpdate(seen_epoch, calculation_interval_ms_);
+                if (!running_.load()) break;
+                if (epoch == seen_epoch) continue;  // Timed out, nothing new
+                seen_epoch = epoch;
+            } else {
+                // Wait for new data with condition variable
+                buffer_.waitForData(calculation_interval_ms_);
+                if (!running_.load()) break;
+            }
+            
+            // Symbols being tracked (a new list only after a listing change)
+            listed.refresh();
+            const std::vector<SymbolId>& symbols = listed.symbols();
+            
+            if (symbols.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            
+            auto calc_start = TickClock::now();
+            size_t pass_start_count = calculation_count_;
+            
+            for (SymbolId symbol : symbols) {
+                // Notify mode: skip symbols whose epoch did not move since our last pass
+                if (notify && !hasNewData(symbol)) {
+                    continue;
+                }
+                calculateSymbol(symbol);
+            }
+            passComplete();     // Between passes: safe point for a checkpoint copy
+            
+            auto calc_end = TickClock::now();
+            auto calc_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                calc_end - calc_start).count();
+            
+            // Log calculation performance (display in microseconds using ASCII)
+            if (calculation_count_ != pass_start_count && logSample(calculation_count_)) {
+                std::cout << " | Calc time: " << calc_time << " us\n";
+            }
+            
+            // Sleep to control calculation rate
+            if (!notify) {
+                TRACE_SPAN("sleep");
+                std::this_thread::sleep_for(std::chrono::milliseconds(calculation_interval_ms_));
+            }
+        }
+        
+        std::cout << "\n[FusedIndicatorCalculator] Indicator loop exited after "
+                  << calculation_count_ << " calculations\n";
+    }
+};
+
+#endif // FUSED_INDICATOR_CALCULATOR_H
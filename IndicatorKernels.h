@@ -0,0 +1,329 @@
+#ifndef INDICATOR_KERNELS_H
+#define INDICATOR_KERNELS_H
+
+#include "RollingWindow.h"
+#include "CheckpointStream.h"
+#include "SymbolRegistry.h"
+#include "CacheLine.h"
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One tick as seen by the indicator kernels
+struct IndicatorInput {
+    double price;
+    double volume;
+    double prev_price;      // Previous tick's price for this symbol
+    bool has_prev;          // prev_price is meaningful (not the first tick)
+};
+
+// A streaming indicator that keeps per-symbol state and folds ticks into it
+// one at a time. FusedIndicatorCalculator feeds every registered kernel from
+// a single read and a single pass over each symbol's new ticks, so adding a
+// kernel adds arithmetic, not another fetch and scan of the history.
+//
+// Like IndicatorTask, update() may run concurrently for different symbols
+// but never for the same symbol at once. Kernels therefore keep each
+// symbol's state on its own cache line(s), so workers updating neighbouring
+// symbols don't false-share.
+class IndicatorKernel {
+private:
+    std::string label_;
+
+protected:
+    explicit IndicatorKernel(std::string label) : label_(std::move(label)) {}
+
+public:
+    virtual ~IndicatorKernel() = default;
+    
+    // Operation name in the performance report, e.g. "SMA"
+    virtual const char* name() const = 0;
+    
+    // Short label for console output, e.g. "SMA(20)" (built once, so logging doesn't allocate)
+    const std::string& label() const { return label_; }
+    
+    // Allocate state for symbol IDs [0, symbols) (before any update)
+    virtual void resize(size_t symbols) = 0;
+    
+    virtual void update(SymbolId symbol, const IndicatorInput& tick) = 0;
+    
+    virtual bool ready(SymbolId symbol) const = 0;
+    virtual double value(SymbolId symbol) const = 0;
+    
+    // Checkpoint one symbol's state (never during an update of that symbol)
+    virtual void save(SymbolId symbol, CheckpointWriter& out) const = 0;
+    
+    // Restore what save() wrote for a kernel with the same label: false if truncated
+    virtual bool load(SymbolId symbol, CheckpointReader& in) = 0;
+};
+
+// The windowed kernels (SMA, volatility, VWAP) are templates over the
+// window size: N = kRuntimeWindow takes it from the constructor, any other
+// N fixes it at compile time (see BasicRollingWindow), storing each
+// symbol's samples inline. makeWindowKernel() picks the fixed version for
+// the common windows. Labels and checkpoints are the same either way.
+
+// Window size the kernel uses: N if fixed, else the argument (at least minimum)
+template <size_t N>
+constexpr size_t kernelWindow(size_t window, size_t minimum) {
+    if (N != kRuntimeWindow) return N;
+    return window >= minimum ? window : minimum;
+}
+
+// Simple moving average of the last window prices
+template <size_t N>
+class BasicSmaKernel : public IndicatorKernel {
+private:
+    using Window = BasicRollingWindow<N>;
+    
+    size_t window_;
+    std::vector<CachePadded<Window>> windows_;
+
+public:
+    // window is ignored when N fixes it
+    explicit BasicSmaKernel(size_t window = kernelWindow<N>(20, 1))
+        : IndicatorKernel("SMA(" + std::to_string(kernelWindow<N>(window, 1)) + ")"),
+          window_(kernelWindow<N>(window, 1)) {}
+    
+    const char* name() const override { return "SMA"; }
+    void resize(size_t symbols) override { windows_.assign(symbols, CachePadded<Window>(window_)); }
+    
+    void update(SymbolId symbol, const IndicatorInput& tick) override {
+        windows_[symbol]->push(tick.price);
+    }
+    
+    bool ready(SymbolId symbol) const override { return windows_[symbol]->size() >= 2; }
+    double value(SymbolId symbol) const override { return windows_[symbol]->mean(); }
+    
+    void save(SymbolId symbol, CheckpointWriter& out) const override { windows_[symbol]->save(out); }
+    bool load(SymbolId symbol, CheckpointReader& in) override { return windows_[symbol]->load(in); }
+};
+
+using SmaKernel = BasicSmaKernel<kRuntimeWindow>;
+
+// Exponential moving average, alpha = 2 / (period + 1), seeded with the
+// simple average of the first period prices
+class EmaKernel : public IndicatorKernel {
+private:
+    struct alignas(kCacheLineSize) State {
+        double ema = 0.0;
+        size_t count = 0;
+    };
+    
+    size_t period_;
+    double alpha_;
+    std::vector<State> states_;
+
+public:
+    explicit EmaKernel(size_t period = 20)
+        : IndicatorKernel("EMA(" + std::to_string(period > 0 ? period : 1) + ")"),
+          period_(period > 0 ? period : 1), alpha_(2.0 / (period_ + 1.0)) {}
+    
+    const char* name() const override { return "EMA"; }
+    void resize(size_t symbols) override { states_.assign(symbols, State()); }
+    
+    void update(SymbolId symbol, const IndicatorInput& tick) override {
+        State& s = states_[symbol];
+        if (s.count < period_) {
+            ++s.count;
+            s.ema += (tick.price - s.ema) / s.count;    // Running mean while seeding
+        } else {
+            s.ema += alpha_ * (tick.price - s.ema);
+        }
+    }
+    
+    bool ready(SymbolId symbol) const override { return states_[symbol].count >= period_; }
+    double value(SymbolId symbol) const override { return states_[symbol].ema; }
+    
+    void save(SymbolId symbol, CheckpointWriter& out) const override {
+        out.put(states_[symbol].ema);
+        out.put(static_cast<uint64_t>(states_[symbol].count));
+    }
+    
+    bool load(SymbolId symbol, CheckpointReader& in) override {
+        double ema = 0.0;
+        uint64_t count = 0;
+        if (!in.get(ema) || !in.get(count)) return false;
+        states_[symbol].ema = ema;
+        states_[symbol].count = static_cast<size_t>(count);
+        return true;
+    }
+};
+
+// Annualized volatility (%) of simple returns over the last window prices,
+// matching VolatilityCalculator
+template <size_t N>
+class BasicVolatilityKernel : public IndicatorKernel {
+private:
+    static_assert(N == kRuntimeWindow || N >= 2, "volatility window (prices)");
+    using Window = BasicRollingWindow<N == kRuntimeWindow ? kRuntimeWindow : N - 1>;
+    
+    size_t window_;
+    std::vector<CachePadded<Window>> returns_;
+
+public:
+    // window is ignored when N fixes it
+    explicit BasicVolatilityKernel(size_t window = kernelWindow<N>(20, 2))
+        : IndicatorKernel("Vol(" + std::to_string(kernelWindow<N>(window, 2)) + ")"),
+          window_(kernelWindow<N>(window, 2)) {}
+    
+    const char* name() const override { return "Volatility"; }
+    void resize(size_t symbols) override { returns_.assign(symbols, CachePadded<Window>(window_ - 1)); }
+    
+    void update(SymbolId symbol, const IndicatorInput& tick) override {
+        if (tick.has_prev) {
+            returns_[symbol]->push((tick.price - tick.prev_price) / tick.prev_price);
+        }
+    }
+    
+    bool ready(SymbolId symbol) const override { return returns_[symbol]->size() >= 2; }
+    
+    double value(SymbolId symbol) const override {
+        // Annualized (assuming 252 trading days), as a percentage
+        return std::sqrt(returns_[symbol]->variance()) * std::sqrt(252.0) * 100.0;
+    }
+    
+    void save(SymbolId symbol, CheckpointWriter& out) const override { returns_[symbol]->save(out); }
+    bool load(SymbolId symbol, CheckpointReader& in) override { return returns_[symbol]->load(in); }
+};
+
+using VolatilityKernel = BasicVolatilityKernel<kRuntimeWindow>;
+
+// Volume-weighted average price over the last window ticks
+template <size_t N>
+class BasicVwapKernel : public IndicatorKernel {
+private:
+    struct alignas(kCacheLineSize) State {
+        BasicRollingWindow<N> notional;     // price * volume
+        BasicRollingWindow<N> volume;
+        
+        explicit State(size_t window) : notional(window), volume(window) {}
+    };
+    
+    size_t window_;
+    std::vector<State> states_;
+
+public:
+    // window is ignored when N fixes it
+    explicit BasicVwapKernel(size_t window = kernelWindow<N>(20, 1))
+        : IndicatorKernel("VWAP(" + std::to_string(kernelWindow<N>(window, 1)) + ")"),
+          window_(kernelWindow<N>(window, 1)) {}
+    
+    const char* name() const override { return "VWAP"; }
+    void resize(size_t symbols) override { states_.assign(symbols, State(window_)); }
+    
+    void update(SymbolId symbol, const IndicatorInput& tick) override {
+        State& s = states_[symbol];
+        s.notional.push(tick.price * tick.volume);
+        s.volume.push(tick.volume);
+    }
+    
+    bool ready(SymbolId symbol) const override { return states_[symbol].volume.sum() > 0.0; }
+    
+    double value(SymbolId symbol) const override {
+        const State& s = states_[symbol];
+        return s.volume.sum() > 0.0 ? s.notional.sum() / s.volume.sum() : 0.0;
+    }
+    
+    void save(SymbolId symbol, CheckpointWriter& out) const override {
+        states_[symbol].notional.save(out);
+        states_[symbol].volume.save(out);
+    }
+    
+    bool load(SymbolId symbol, CheckpointReader& in) override {
+        return states_[symbol].notional.load(in) && states_[symbol].volume.load(in);
+    }
+};
+
+using VwapKernel = BasicVwapKernel<kRuntimeWindow>;
+
+// Relative strength index with Wilder smoothing over period price changes
+class RsiKernel : public IndicatorKernel {
+private:
+    struct alignas(kCacheLineSize) State {
+        double avg_gain = 0.0;
+        double avg_loss = 0.0;
+        size_t changes = 0;
+    };
+    
+    size_t period_;
+    std::vector<State> states_;
+
+public:
+    explicit RsiKernel(size_t period = 14)
+        : IndicatorKernel("RSI(" + std::to_string(period > 0 ? period : 1) + ")"),
+          period_(period > 0 ? period : 1) {}
+    
+    const char* name() const override { return "RSI"; }
+    void resize(size_t symbols) override { states_.assign(symbols, State()); }
+    
+    void update(SymbolId symbol, const IndicatorInput& tick) override {
+        if (!tick.has_prev) return;
+        
+        State& s = states_[symbol];
+        double change = tick.price - tick.prev_price;
+        double gain = change > 0.0 ? change : 0.0;
+        double loss = change < 0.0 ? -change : 0.0;
+        
+        if (s.changes < period_) {
+            // Seed with the simple average of the first period changes
+            ++s.changes;
+            s.avg_gain += (gain - s.avg_gain) / s.changes;
+            s.avg_loss += (loss - s.avg_loss) / s.changes;
+        } else {
+            s.avg_gain = (s.avg_gain * (period_ - 1) + gain) / period_;
+            s.avg_loss = (s.avg_loss * (period_ - 1) + loss) / period_;
+        }
+    }
+    
+    bool ready(SymbolId symbol) const override { return states_[symbol].changes >= period_; }
+    
+    double value(SymbolId symbol) const override {
+        const State& s = states_[symbol];
+        if (s.avg_loss == 0.0) return s.avg_gain > 0.0 ? 100.0 : 50.0;
+        double rs = s.avg_gain / s.avg_loss;
+        return 100.0 - 100.0 / (1.0 + rs);
+    }
+    
+    void save(SymbolId symbol, CheckpointWriter& out) const override {
+        const State& s = states_[symbol];
+        out.put(s.avg_gain);
+        out.put(s.avg_loss);
+        out.put(static_cast<uint64_t>(s.changes));
+    }
+    
+    bool load(SymbolId symbol, CheckpointReader& in) override {
+        double avg_gain = 0.0, avg_loss = 0.0;
+        uint64_t changes = 0;
+        if (!in.get(avg_gain) || !in.get(avg_loss) || !in.get(changes)) return false;
+        State& s = states_[symbol];
+        s.avg_gain = avg_gain;
+        s.avg_loss = avg_loss;
+        s.changes = static_cast<size_t>(changes);
+        return true;
+    }
+};
+
+/**
+ * @brief A windowed kernel (BasicSmaKernel, ...) for window
+ *
+ * 10, 20, 50 and 200 get the compile-time sized kernel; other windows, or
+ * specialized = false, the runtime-sized one.
+ */
+template <template <size_t> class Kernel>
+std::unique_ptr<IndicatorKernel> makeWindowKernel(size_t window, bool specialized = true) {
+    if (specialized) {
+        switch (window) {
+            case 10: return std::make_unique<Kernel<10>>();
+            case 20: return std::make_unique<Kernel<20>>();
+            case 50: return std::make_unique<Kernel<50>>();
+            case 200: return std::make_unique<Kernel<200>>();
+            default: break;
+        }
+    }
+    return std::make_unique<Kernel<kRuntimeWindow>>(window);
+}
+
+#endif // INDICATOR_KERNELS_H
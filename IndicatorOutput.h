@@ -0,0 +1,261 @@
+#ifndef INDICATOR_OUTPUT_H
+#define INDICATOR_OUTPUT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary formats for computed indicator values (written by IndicatorSink).
+//
+// Every result is one fixed-width IndicatorRecord. Two containers exist
+// (native byte order, like tick files):
+//
+// Stream file (--output=FILE), appended while the simulator runs:
+//
+//   IndicatorStreamHeader                  64 bytes
+//   symbol table                           symbol_count x kIndicatorNameBytes (one per symbol slot)
+//   indicator table                        indicator_count x kIndicatorNameBytes
+//   padding up to records_offset
+//   IndicatorRecord[...]                   48 bytes each, in drain order
+//
+// record_count is patched in when the file is closed; while it is being
+// written, (file size - records_offset) / 48 records are complete.
+//
+// The symbol table has a name for every slot of the symbol registry,
+// spare ones included. A slot's name is empty until a symbol is listed
+// into it at runtime; it is filled in before that symbol's first record.
+//
+// Shared-memory queue (--output-shm=PATH, e.g. under /dev/shm): the same
+// header and tables, then a ring of `capacity` records that the sink keeps
+// overwriting. Other processes map the file read-only (IndicatorQueueReader)
+// and read records in place; published counts records ever written, and a
+// record whose slot was (being) overwritten is detected and skipped. A
+// symbol listed after the reader mapped the queue is named by symbol().
+
+constexpr char kIndicatorStreamMagic[8] = {'S', 'T', 'K', 'I', 'N', 'D', 'S', '1'};
+constexpr char kIndicatorQueueMagic[8] = {'S', 'T', 'K', 'I', 'N', 'D', 'Q', '1'};
+constexpr uint32_t kIndicatorOutputVersion = 1;
+constexpr size_t kIndicatorNameBytes = 16;
+
+struct IndicatorRecord {
+    uint32_t symbol;            // Index into the symbol table (SymbolRegistry ID)
+    uint16_t indicator;         // Index into the indicator table
+    uint16_t reserved;
+    double value;               // The indicator's value
+    double price;               // Latest price folded in
+    int64_t tick_time_ns;       // TickClock time of that tick
+    int64_t computed_time_ns;   // TickClock time of the calculation
+    uint64_t sequence;          // Ticks of the symbol folded in so far
+};
+
+struct IndicatorStreamHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;       // sizeof(IndicatorRecord)
+    uint32_t symbol_count;
+    uint32_t indicator_count;
+    uint64_t records_offset;    // Byte offset of the first record (64-byte aligned)
+    uint64_t record_count;      // Stream: patched on close; queue: ring capacity (power of two)
+    uint64_t reserved[3];
+};
+
+// Queue files only: the two counters live on their own cache line after the header
+struct IndicatorQueueCounters {
+    alignas(64) std::atomic<uint64_t> claimed;      // Records whose slots may be being written
+    std::atomic<uint64_t> published;                // Records completely written
+};
+
+static_assert(sizeof(IndicatorRecord) == 48, "indicator record layout");
+static_assert(sizeof(IndicatorStreamHeader) == 64, "indicator stream header layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "queue counters are shared between processes");
+
+namespace indicator_output {
+
+// Header plus both name tables (NUL-padded, truncated to 15 characters)
+inline std::vector<char> encodePreamble(const char (&magic)[8],
+                                        const std::vector<std::string>& symbols,
+                                        const std::vector<std::string>& indicators,
+                                        uint64_t records_offset, uint64_t record_count) {
+    IndicatorStreamHeader header = {};
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = kIndicatorOutputVersion;
+    header.record_size = sizeof(IndicatorRecord);
+    header.symbol_count = static_cast<uint32_t>(symbols.size());
+    header.indicator_count = static_cast<uint32_t>(indicators.size());
+    header.records_offset = records_offset;
+    header.record_count = record_count;
+    
+    std::vector<char> out(sizeof(header) + (symbols.size() + indicators.size()) * kIndicatorNameBytes, '\0');
+    std::memcpy(out.data(), &header, sizeof(header));
+    char* name = out.data() + sizeof(header);
+    for (const auto* table : {&symbols, &indicators}) {
+        for (const auto& s : *table) {
+            std::memcpy(name, s.data(), std::min(s.size(), kIndicatorNameBytes - 1));
+            name += kIndicatorNameBytes;
+        }
+    }
+    return out;
+}
+
+// First 64-byte boundary after the name tables (and, for queues, the counters)
+inline uint64_t recordsOffset(size_t symbols, size_t indicators, bool queue) {
+    uint64_t end = sizeof(IndicatorStreamHeader) + (symbols + indicators) * kIndicatorNameBytes;
+    if (queue) end += sizeof(IndicatorQueueCounters);
+    return (end + 63) & ~uint64_t(63);
+}
+
+// Queue counters sit right after the name tables, 64-byte aligned
+inline uint64_t countersOffset(size_t symbols, size_t indicators) {
+    uint64_t end = sizeof(IndicatorStreamHeader) + (symbols + indicators) * kIndicatorNameBytes;
+    return (end + 63) & ~uint64_t(63);
+}
+
+}  // namespace indicator_output
+
+// Read-only view of a shared-memory indicator queue, for other processes.
+//
+// Records are read in place from the mapping. After reading record seq
+// through at(), check intact(seq): false means the writer lapped the
+// reader and the slot was (or is being) overwritten, so the copy must be
+// discarded. read() does both for a copy.
+class IndicatorQueueReader {
+private:
+    std::string path_;
+    void* base_;
+    size_t length_;
+    uint64_t capacity_;
+    uint64_t mask_;
+    const IndicatorQueueCounters* counters_;
+    const IndicatorRecord* records_;
+    std::vector<std::string> symbols_;
+    std::vector<std::string> indicators_;
+    
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("indicator queue " + path_ + ": " + what);
+    }
+
+public:
+    /**
+     * @brief Map and validate a queue created by the simulator
+     * @throws std::runtime_error if the file cannot be mapped or is not a queue
+     */
+    explicit IndicatorQueueReader(const std::string& path)
+        : path_(path), base_(nullptr), length_(0), capacity_(0), mask_(0),
+          counters_(nullptr), records_(nullptr) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(std::strerror(errno));
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(IndicatorStreamHeader)) {
+            ::close(fd);
+            fail("too small for a header");
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        base_ = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            fail(std::strerror(errno));
+        }
+        
+        const char* bytes = static_cast<const char*>(base_);
+        IndicatorStreamHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        try {
+            if (std::memcmp(header.magic, kIndicatorQueueMagic, sizeof(header.magic)) != 0) {
+                fail("bad magic (not an indicator queue)");
+            }
+            if (header.version != kIndicatorOutputVersion || header.record_size != sizeof(IndicatorRecord)) {
+                fail("unsupported version or record size");
+            }
+            capacity_ = header.record_count;
+            if (capacity_ == 0 || (capacity_ & (capacity_ - 1)) != 0 ||
+                header.records_offset != indicator_output::recordsOffset(header.symbol_count,
+                                                                         header.indicator_count, true) ||
+                header.records_offset + capacity_ * sizeof(IndicatorRecord) > length_) {
+                fail("bad layout");
+            }
+        } catch (...) {
+            ::munmap(base_, length_);
+            throw;
+        }
+        mask_ = capacity_ - 1;
+        counters_ = reinterpret_cast<const IndicatorQueueCounters*>(
+            bytes + indicator_output::countersOffset(header.symbol_count, header.indicator_count));
+        records_ = reinterpret_cast<const IndicatorRecord*>(bytes + header.records_offset);
+        
+        const char* name = bytes + sizeof(header);
+        for (uint32_t i = 0; i < header.symbol_count; ++i, name += kIndicatorNameBytes) {
+            symbols_.emplace_back(name, strnlen(name, kIndicatorNameBytes));
+        }
+        for (uint32_t i = 0; i < header.indicator_count; ++i, name += kIndicatorNameBytes) {
+            indicators_.emplace_back(name, strnlen(name, kIndicatorNameBytes));
+        }
+    }
+    
+    ~IndicatorQueueReader() {
+        if (base_) ::munmap(base_, length_);
+    }
+    
+    IndicatorQueueReader(const IndicatorQueueReader&) = delete;
+    IndicatorQueueReader& operator=(const IndicatorQueueReader&) = delete;
+    
+    // Symbol slot names as of opening (empty: not listed yet)
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const std::vector<std::string>& indicators() const { return indicators_; }
+    
+    /**
+     * @brief Name of a record's symbol, read from the live table (also
+     *        names symbols listed since opening; empty for an unknown ID)
+     *
+     * The writer names a slot before publishing its first record, so the
+     * name is complete for any record read below published().
+     */
+    std::string symbol(uint32_t id) const {
+        if (id >= symbols_.size()) return std::string();
+        if (!symbols_[id].empty()) return symbols_[id];
+        const char* name = static_cast<const char*>(base_) + sizeof(IndicatorStreamHeader) + id * kIndicatorNameBytes;
+        return std::string(name, strnlen(name, kIndicatorNameBytes));
+    }
+    uint64_t capacity() const { return capacity_; }
+    
+    // Records written so far; seq in [published() - capacity(), published()) may be read
+    uint64_t published() const { return counters_->published.load(std::memory_order_acquire); }
+    
+    // Oldest record still in the ring
+    uint64_t oldest() const {
+        uint64_t p = published();
+        return p > capacity_ ? p - capacity_ : 0;
+    }
+    
+    const IndicatorRecord& at(uint64_t seq) const { return records_[seq & mask_]; }
+    
+    /**
+     * @brief True if record seq was not overwritten while (or before) it was read
+     */
+    bool intact(uint64_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);    // Record reads before this check
+        return counters_->claimed.load(std::memory_order_relaxed) <= seq + capacity_;
+    }
+    
+    /**
+     * @brief Copy record seq (must be below published())
+     * @return false if it has been overwritten
+     */
+    bool read(uint64_t seq, IndicatorRecord& out) const {
+        std::memcpy(&out, &at(seq), sizeof(out));
+        return intact(seq);
+    }
+};
+
+#endif // INDICATOR_OUTPUT_H
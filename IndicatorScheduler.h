@@ -0,0 +1,219 @@
+#ifndef INDICATOR_SCHEDULER_H
+#define INDICATOR_SCHEDULER_H
+
+#include "SharedBuffer.h"
+#include "IndicatorTask.h"
+#include "WorkStealingExecutor.h"
+#include "ThreadPlacement.h"
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+
+// Runs registered indicators as symbol x indicator tasks on a shared
+// WorkStealingExecutor instead of one dedicated thread per indicator.
+//
+// Each pass the scheduler thread works out which (indicator, symbol) pairs
+// need an update, splits them into tasks of up to grain symbols, submits
+// them all at once and waits (helping) until they are done. Work therefore
+// spreads over however many workers the executor has, and adding an
+// indicator adds tasks, not threads.
+//
+// Wake modes match the dedicated calculators: Notify runs a pass whenever
+// the buffer's write epoch moves and only for symbols with new ticks; Poll
+// runs each indicator every interval_ms over every symbol.
+class IndicatorScheduler {
+private:
+    struct Entry {
+        IndicatorTask* task;
+        int interval_ms;                                    // Poll period / Notify wait timeout
+        std::chrono::steady_clock::time_point next_due;     // Poll mode only
+        std::vector<SymbolId> symbols;                      // This pass's work, reused
+    };
+    
+    // Symbols [symbols, symbols + count) of one indicator
+    struct Chunk {
+        IndicatorTask* task;
+        const SymbolId* symbols;
+        size_t count;
+    };
+    
+    SharedBuffer& buffer_;
+    WorkStealingExecutor& executor_;
+    ConsumerWakeMode wake_mode_;
+    size_t grain_;                          // Symbols per task
+    
+    std::vector<Entry> entries_;
+    std::vector<Chunk> chunks_;             // Current pass, reused
+    std::vector<ExecutorTask> tasks_;       // Current pass, reused
+    TaskGroup group_;
+    
+    std::atomic<bool> running_;
+    std::thread thread_;
+    
+    size_t passes_;
+    size_t symbol_updates_;                 // calculateSymbol() calls issued
+    
+    static void runChunk(void* context, size_t index) {
+        const Chunk& chunk = static_cast<IndicatorScheduler*>(context)->chunks_[index];
+        for (size_t i = 0; i < chunk.count; ++i) {
+            chunk.task->calculateSymbol(chunk.symbols[i]);
+        }
+    }
+    
+    int shortestInterval() const {
+        int shortest = 1000;
+        for (const auto& e : entries_) {
+            if (e.interval_ms < shortest) shortest = e.interval_ms;
+        }
+        return shortest > 0 ? shortest : 1;
+    }
+    
+    // Poll mode: sleep until the earliest indicator is due (waking to honor stop())
+    void sleepUntilDue() {
+        auto due = entries_.front().next_due;
+        for (const auto& e : entries_) {
+            if (e.next_due < due) due = e.next_due;
+        }
+        const auto slice = std::chrono::milliseconds(100);
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= due || !running_.load()) return;
+            auto left = due - now;
+            std::this_thread::sleep_for(left < slice ? left : slice);
+        }
+    }
+
+public:
+    /**
+     * @param grain Maximum symbols per executor task (1 = one task per symbol per indicator)
+     */
+    IndicatorScheduler(SharedBuffer& buffer,
+                       WorkStealingExecutor& executor,
+                       ConsumerWakeMode wake_mode = ConsumerWakeMode::Notify,
+                       size_t grain = 8)
+        : buffer_(buffer), executor_(executor), wake_mode_(wake_mode),
+          grain_(grain > 0 ? grain : 1), running_(false),
+          passes_(0), symbol_updates_(0) {}
+    
+    ~IndicatorScheduler() {
+        stop();
+    }
+    
+    /**
+     * @brief Add an indicator (before start()); the task must outlive the scheduler
+     * @param interval_ms Poll period, or the Notify wait timeout
+     */
+    void registerIndicator(IndicatorTask& task, int interval_ms) {
+        entries_.push_back(Entry{&task, interval_ms, std::chrono::steady_clock::time_point(), {}});
+    }
+    
+    void start() {
+        bool expected = false;
+        if (!entries_.empty() && running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&IndicatorScheduler::run, this);
+            std::cout << "[IndicatorScheduler] Started scheduler thread (ID: " << thread_.get_id()
+                      << ") for " << entries_.size() << " indicator(s) on "
+                      << executor_.workerCount() << " worker(s)\n";
+        }
+    }
+    
+    void stop() {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            std::cout << "[IndicatorScheduler] Scheduler thread stopped\n";
+        }
+    }
+
+private:
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "IndicatorScheduler");
+        std::cout << "[IndicatorScheduler] Scheduling loop starting...\n";
+        
+        const bool notify = (wake_mode_ == ConsumerWakeMode::Notify);
+        const int wait_ms = shortestInterval();
+        uint64_t seen_epoch = 0;
+        SymbolTable::Reader listed(buffer_.symbolTable());     // Listed symbols, read in place
+        
+        while (running_.load()) {
+            if (notify) {
+                // Sleep until a tick newer than the last pass is pushed
+                uint64_t epoch = buffer_.waitForUpdate(seen_epoch, wait_ms);
+                if (!running_.load()) break;
+                if (epoch == seen_epoch) continue;  // Timed out, nothing new
+                seen_epoch = epoch;
+            } else {
+                sleepUntilDue();
+                if (!running_.load()) break;
+            }
+            
+            listed.refresh();       // A new list only after a listing change
+            const std::vector<SymbolId>& symbols = listed.symbols();
+            if (symbols.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            
+            auto pass_start = std::chrono::steady_clock::now();
+            
+            // Collect (indicator, symbol) work for this pass
+            chunks_.clear();
+            size_t updates = 0;
+            for (auto& e : entries_) {
+                e.symbols.clear();
+                if (!notify) {
+                    if (pass_start < e.next_due) continue;   // This indicator is not due yet
+                    e.next_due = pass_start + std::chrono::milliseconds(e.interval_ms);
+                }
+                for (SymbolId symbol : symbols) {
+                    // Notify mode: skip symbols whose epoch did not move since the last pass
+                    if (!notify || e.task->hasNewData(symbol)) {
+                        e.symbols.push_back(symbol);
+                    }
+                }
+                for (size_t begin = 0; begin < e.symbols.size(); begin += grain_) {
+                    size_t count = std::min(grain_, e.symbols.size() - begin);
+                    chunks_.push_back(Chunk{e.task, e.symbols.data() + begin, count});
+                }
+                updates += e.symbols.size();
+            }
+            if (chunks_.empty()) continue;
+            
+            // chunks_ is complete, so tasks can refer to it by index
+            tasks_.clear();
+            for (size_t i = 0; i < chunks_.size(); ++i) {
+                tasks_.push_back(ExecutorTask{&IndicatorScheduler::runChunk, this, i, &group_});
+            }
+            executor_.submit(tasks_.data(), tasks_.size());
+            executor_.wait(group_);
+            
+            // Every task is idle until the next submit: checkpoint copies happen here
+            for (auto& e : entries_) {
+                e.task->passComplete();
+            }
+            
+            ++passes_;
+            symbol_updates_ += updates;
+            
+            // Log every 50 passes to avoid cluttering console
+            if (passes_ % 50 == 0) {
+                auto pass_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - pass_start).count();
+                std::cout << "\n[IndicatorScheduler] Pass " << passes_ << ": " << tasks_.size()
+                          << " tasks, " << updates << " symbol updates in " << pass_time << " us\n";
+            }
+        }
+        
+        size_t executed, stolen;
+        executor_.getStats(executed, stolen);
+        std::cout << "\n[IndicatorScheduler] Scheduling loop exited after " << passes_ << " passes ("
+                  << symbol_updates_ << " symbol updates; workers ran " << executed
+                  << " tasks, " << stolen << " stolen)\n";
+    }
+};
+
+#endif // INDICATOR_SCHEDULER_H
@@ -0,0 +1,497 @@
+#ifndef INDICATOR_SINK_H
+#define INDICATOR_SINK_H
+
+#include "IndicatorOutput.h"
+#include "SymbolRegistry.h"
+#include "CacheLine.h"
+#include "ThreadPlacement.h"
+#include "Clock.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Where an IndicatorSink's writer thread puts records (see IndicatorOutput.h).
+class IndicatorTarget {
+public:
+    virtual ~IndicatorTarget() = default;
+    
+    /**
+     * @brief Create the output (writer thread, before the first write())
+     * @throws std::runtime_error if it cannot be created
+     */
+    virtual void begin(const std::vector<std::string>& symbols, const std::vector<std::string>& indicators) = 0;
+    
+    // Fill in the name of a symbol slot listed after begin() (before its first record)
+    virtual void nameSymbol(SymbolId id, const std::string& name) = 0;
+    
+    // One drained batch, oldest first
+    virtual void write(const IndicatorRecord* records, size_t count) = 0;
+    
+    virtual void end() {}
+    
+    virtual std::string describe() const = 0;
+};
+
+// Appends records to a stream file with one write(2) per drained batch.
+class IndicatorFileTarget : public IndicatorTarget {
+private:
+    std::string path_;
+    int fd_ = -1;
+    uint64_t records_offset_ = 0;
+    uint64_t written_ = 0;
+    bool failed_ = false;
+    
+    bool writeAll(const void* data, size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t n = ::write(fd_, p, bytes);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+public:
+    explicit IndicatorFileTarget(std::string path) : path_(std::move(path)) {}
+    
+    ~IndicatorFileTarget() override {
+        end();
+    }
+    
+    void begin(const std::vector<std::string>& symbols, const std::vector<std::string>& indicators) override {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("indicator output " + path_ + ": " + std::strerror(errno));
+        }
+        records_offset_ = indicator_output::recordsOffset(symbols.size(), indicators.size(), false);
+        std::vector<char> preamble = indicator_output::encodePreamble(kIndicatorStreamMagic, symbols, indicators,
+                                                                      records_offset_, 0);
+        preamble.resize(static_cast<size_t>(records_offset_), '\0');
+        if (!writeAll(preamble.data(), preamble.size())) {
+            throw std::runtime_error("indicator output " + path_ + ": " + std::strerror(errno));
+        }
+    }
+    
+    void nameSymbol(SymbolId id, const std::string& name) override {
+        if (failed_) return;
+        char entry[kIndicatorNameBytes] = {};
+        std::memcpy(entry, name.data(), std::min(name.size(), kIndicatorNameBytes - 1));
+        off_t offset = static_cast<off_t>(sizeof(IndicatorStreamHeader) + id * kIndicatorNameBytes);
+        if (::pwrite(fd_, entry, sizeof(entry), offset) != static_cast<ssize_t>(sizeof(entry))) {
+            std::cerr << "[IndicatorSink] Cannot name symbol " << name << " in " << path_ << ": "
+                      << std::strerror(errno) << "\n";
+        }
+    }
+    
+    void write(const IndicatorRecord* records, size_t count) override {
+        if (failed_) return;
+        if (!writeAll(records, count * sizeof(IndicatorRecord))) {
+            std::cerr << "[IndicatorSink] Write to " << path_ << " failed: " << std::strerror(errno)
+                      << " (output stopped)\n";
+            failed_ = true;
+            return;
+        }
+        written_ += count;
+    }
+    
+    // Patch the record count into the header
+    void end() override {
+        if (fd_ < 0) return;
+        uint64_t count = written_;
+        if (::pwrite(fd_, &count, sizeof(count), offsetof(IndicatorStreamHeader, record_count)) < 0) {
+            std::cerr << "[IndicatorSink] Cannot finish " << path_ << ": " << std::strerror(errno) << "\n";
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+    
+    std::string describe() const override { return "file " + path_; }
+};
+
+// Publishes records into a shared-memory ring other processes map and read
+// in place (IndicatorQueueReader). The ring is overwritten once full: the
+// simulator never waits for a reader.
+class IndicatorQueueTarget : public IndicatorTarget {
+private:
+    std::string path_;
+    uint64_t capacity_;
+    uint64_t mask_;
+    void* base_ = nullptr;
+    size_t length_ = 0;
+    IndicatorQueueCounters* counters_ = nullptr;
+    char* symbol_names_ = nullptr;
+    IndicatorRecord* records_ = nullptr;
+    uint64_t published_ = 0;
+    
+    static uint64_t roundUpPow2(uint64_t n) {
+        uint64_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+    
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("indicator queue " + path_ + ": " + what);
+    }
+
+public:
+    /**
+     * @param capacity Records kept in the ring (rounded up to a power of two)
+     */
+    IndicatorQueueTarget(std::string path, size_t capacity)
+        : path_(std::move(path)), capacity_(roundUpPow2(capacity > 0 ? capacity : 1)), mask_(capacity_ - 1) {}
+    
+    ~IndicatorQueueTarget() override {
+        if (base_) ::munmap(base_, length_);
+    }
+    
+    void begin(const std::vector<std::string>& symbols, const std::vector<std::string>& indicators) override {
+        uint64_t records_offset = indicator_output::recordsOffset(symbols.size(), indicators.size(), true);
+        length_ = static_cast<size_t>(records_offset + capacity_ * sizeof(IndicatorRecord));
+        
+        int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail(std::strerror(errno));
+        if (::ftruncate(fd, static_cast<off_t>(length_)) != 0) {
+            ::close(fd);
+            fail(std::strerror(errno));
+        }
+        base_ = ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            fail(std::strerror(errno));
+        }
+        
+        char* bytes = static_cast<char*>(base_);
+        counters_ = new (bytes + indicator_output::countersOffset(symbols.size(), indicators.size()))
+            IndicatorQueueCounters();
+        counters_->claimed.store(0, std::memory_order_relaxed);
+        counters_->published.store(0, std::memory_order_relaxed);
+        symbol_names_ = bytes + sizeof(IndicatorStreamHeader);
+        records_ = reinterpret_cast<IndicatorRecord*>(bytes + records_offset);
+        
+        // Header last: a reader that sees the magic sees a complete layout
+        std::vector<char> preamble = indicator_output::encodePreamble(kIndicatorQueueMagic, symbols, indicators,
+                                                                      records_offset, capacity_);
+        std::memcpy(bytes + sizeof(kIndicatorQueueMagic), preamble.data() + sizeof(kIndicatorQueueMagic),
+                    preamble.size() - sizeof(kIndicatorQueueMagic));
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(bytes, preamble.data(), sizeof(kIndicatorQueueMagic));
+    }
+    
+    // Readers see the name once they see a record published after it
+    void nameSymbol(SymbolId id, const std::string& name) override {
+        char* entry = symbol_names_ + id * kIndicatorNameBytes;
+        std::memset(entry, 0, kIndicatorNameBytes);
+        std::memcpy(entry, name.data(), std::min(name.size(), kIndicatorNameBytes - 1));
+    }
+    
+    /**
+     * @brief Copy records into the ring: claim their slots, write, publish
+     *
+     * Readers compare claimed against the record they read (see
+     * IndicatorQueueReader::intact()), so a record overwritten mid-read is
+     * never mistaken for a good one.
+     */
+    void write(const IndicatorRecord* records, size_t count) override {
+        while (count > 0) {
+            size_t n = count < capacity_ ? count : static_cast<size_t>(capacity_);
+            counters_->claimed.store(published_ + n, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);    // Claim before the slot writes
+            for (size_t i = 0; i < n; ++i) {
+                records_[(published_ + i) & mask_] = records[i];
+            }
+            published_ += n;
+            counters_->published.store(published_, std::memory_order_release);
+            records += n;
+            count -= n;
+        }
+    }
+    
+    std::string describe() const override {
+        return "shared-memory queue " + path_ + " (" + std::to_string(capacity_) + " records)";
+    }
+};
+
+// Output stage for computed indicator values.
+//
+// Any indicator thread calls emit(); each thread appends to a ring of its
+// own (registered on first use, like PerformanceMonitor's tables), so the
+// record path is a few plain stores and one release store: no lock, no
+// formatting, no system call. One writer thread drains every ring in
+// batches into an IndicatorTarget. A ring that is full (the writer fell
+// behind) drops the record and counts it; emit() never waits.
+//
+// The output's symbol table covers every registry slot. Symbols listed at
+// runtime are named in it by the writer thread before the batch that may
+// carry their first record.
+class IndicatorSink {
+public:
+    static constexpr uint16_t kMaxIndicators = 64;
+
+private:
+    // Single-producer (its owner thread), single-consumer (the writer) ring
+    struct ThreadRing {
+        std::thread::id owner;
+        std::vector<IndicatorRecord> slots;
+        uint64_t mask;
+        alignas(kCacheLineSize) std::atomic<uint64_t> head{0};      // Written by owner
+        uint64_t dropped = 0;                                       // Owner only
+        std::atomic<uint64_t> dropped_total{0};                     // Published copy of dropped
+        alignas(kCacheLineSize) std::atomic<uint64_t> tail{0};      // Written by the writer
+        
+        ThreadRing(std::thread::id id, size_t capacity) : owner(id), slots(capacity), mask(capacity - 1) {}
+    };
+    
+    const SymbolRegistry& registry_;
+    std::unique_ptr<IndicatorTarget> target_;
+    const uint64_t instance_id_;        // Distinguishes sinks in the thread-local ring cache
+    const size_t ring_capacity_;
+    const size_t batch_records_;
+    const int drain_interval_ms_;
+    
+    std::vector<std::string> indicators_;   // indicator id -> name (registered before start())
+    
+    mutable std::mutex mutex_;              // Protects rings_ registration (not the emit path)
+    std::vector<std::unique_ptr<ThreadRing>> rings_;
+    
+    std::atomic<bool> running_;
+    std::thread thread_;
+    
+    // Writer thread only
+    std::vector<ThreadRing*> drain_list_;
+    std::vector<IndicatorRecord> batch_;
+    size_t named_ = 0;                      // Registry slots named in the output
+    std::atomic<uint64_t> written_{0};
+    
+    static uint64_t nextInstanceId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+    
+    ThreadRing& localRing() {
+        struct Cache {
+            uint64_t instance = 0;
+            ThreadRing* ring = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.instance == instance_id_) {
+            return *cache.ring;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::thread::id self = std::this_thread::get_id();
+        ThreadRing* ring = nullptr;
+        for (auto& r : rings_) {
+            if (r->owner == self) {
+                ring = r.get();
+                break;
+            }
+        }
+        if (!ring) {
+            rings_.push_back(std::make_unique<ThreadRing>(self, ring_capacity_));
+            ring = rings_.back().get();
+        }
+        cache.instance = instance_id_;
+        cache.ring = ring;
+        return *ring;
+    }
+    
+    // Move everything queued so far to the target; returns records moved
+    size_t drain() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            drain_list_.clear();
+            for (auto& r : rings_) drain_list_.push_back(r.get());
+        }
+        
+        size_t moved = 0;
+        for (ThreadRing* ring : drain_list_) {
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            while (tail != head) {
+                size_t n = static_cast<size_t>(head - tail);
+                size_t room = batch_records_ - batch_.size();
+                if (n > room) n = room;
+                for (size_t i = 0; i < n; ++i) {
+                    batch_.push_back(ring->slots[(tail + i) & ring->mask]);
+                }
+                tail += n;
+                ring->tail.store(tail, std::memory_order_release);
+                moved += n;
+                if (batch_.size() == batch_records_) flush();
+            }
+        }
+        flush();
+        return moved;
+    }
+    
+    void flush() {
+        if (batch_.empty()) return;
+        // A record's symbol was registered before it was emitted
+        size_t registered = registry_.size();
+        for (; named_ < registered; ++named_) {
+            target_->nameSymbol(static_cast<SymbolId>(named_), registry_.name(static_cast<SymbolId>(named_)));
+        }
+        target_->write(batch_.data(), batch_.size());
+        written_.fetch_add(batch_.size(), std::memory_order_relaxed);
+        batch_.clear();
+    }
+    
+    void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Background, "IndicatorSink");
+        std::cout << "[IndicatorSink] Writer loop starting (" << target_->describe() << ")...\n";
+        
+        while (running_.load()) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(drain_interval_ms_));
+            }
+        }
+        drain();    // Whatever the indicators emitted before they stopped
+        target_->end();
+        
+        std::cout << "[IndicatorSink] Writer loop exited after " << written_.load() << " records ("
+                  << dropped() << " dropped)\n";
+    }
+
+public:
+    /**
+     * @param target Where records go; begun on start()
+     * @param ring_capacity Records each emitting thread can queue before drops
+     * @param batch_records Records per target write
+     * @param drain_interval_ms Writer sleep when every ring was empty
+     */
+    IndicatorSink(const SymbolRegistry& registry,
+                  std::unique_ptr<IndicatorTarget> target,
+                  size_t ring_capacity = 16384,
+                  size_t batch_records = 4096,
+                  int drain_interval_ms = 2)
+        : registry_(registry), target_(std::move(target)), instance_id_(nextInstanceId()),
+          ring_capacity_(roundUpPow2(ring_capacity > 0 ? ring_capacity : 1)),
+          batch_records_(batch_records > 0 ? batch_records : 1),
+          drain_interval_ms_(drain_interval_ms > 0 ? drain_interval_ms : 1),
+          running_(false) {}
+    
+    ~IndicatorSink() {
+        stop();
+    }
+    
+    IndicatorSink(const IndicatorSink&) = delete;
+    IndicatorSink& operator=(const IndicatorSink&) = delete;
+    
+    /**
+     * @brief Register an indicator name (before start())
+     * @return Its ID for IndicatorRecord::indicator; the existing ID if already registered
+     * @throws std::length_error past kMaxIndicators
+     */
+    uint16_t registerIndicator(const std::string& name) {
+        for (size_t i = 0; i < indicators_.size(); ++i) {
+            if (indicators_[i] == name) return static_cast<uint16_t>(i);
+        }
+        if (indicators_.size() >= kMaxIndicators) {
+            throw std::length_error("IndicatorSink: too many indicators");
+        }
+        indicators_.push_back(name);
+        return static_cast<uint16_t>(indicators_.size() - 1);
+    }
+    
+    /**
+     * @brief Create the output and start the writer thread
+     * @throws std::runtime_error if the target cannot be created
+     */
+    void start() {
+        if (running_.load()) return;
+        named_ = registry_.size();
+        std::vector<std::string> symbols(registry_.capacity());
+        for (size_t id = 0; id < named_; ++id) {
+            symbols[id] = registry_.name(static_cast<SymbolId>(id));
+        }
+        target_->begin(symbols, indicators_);
+        batch_.reserve(batch_records_);
+        
+        running_.store(true);
+        thread_ = std::thread(&IndicatorSink::run, this);
+        std::cout << "[IndicatorSink] Started writer thread (ID: " << thread_.get_id() << ") for "
+                  << indicators_.size() << " indicator(s) -> " << target_->describe() << "\n";
+    }
+    
+    /**
+     * @brief Drain what is queued, finish the output and stop (after the indicators)
+     */
+    void stop() {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            std::cout << "[IndicatorSink] Writer thread stopped\n";
+        }
+    }
+    
+    /**
+     * @brief Queue one record from any thread (never blocks; drops if this thread's ring is full)
+     */
+    void emit(const IndicatorRecord& record) {
+        ThreadRing& ring = localRing();
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) > ring.mask) {
+            ring.dropped_total.store(++ring.dropped, std::memory_order_relaxed);
+            return;
+        }
+        ring.slots[head & ring.mask] = record;
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Convenience: build and queue a record
+     */
+    void emit(SymbolId symbol, uint16_t indicator, double value, double price,
+              TickClock::time_point tick_time, TickClock::time_point computed_time, uint64_t sequence) {
+        IndicatorRecord record;
+        record.symbol = symbol;
+        record.indicator = indicator;
+        record.reserved = 0;
+        record.value = value;
+        record.price = price;
+        record.tick_time_ns = tick_time.time_since_epoch().count();
+        record.computed_time_ns = computed_time.time_since_epoch().count();
+        record.sequence = sequence;
+        emit(record);
+    }
+    
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = 0;
+        for (const auto& r : rings_) total += r->dropped_total.load(std::memory_order_relaxed);
+        return total;
+    }
+    
+    std::string describe() const { return target_->describe(); }
+};
+
+#endif // INDICATOR_SINK_H
@@ -0,0 +1,114 @@
+#ifndef INDICATOR_TASK_H
+#define INDICATOR_TASK_H
+
+#include "SymbolRegistry.h"
+#include "CheckpointStream.h"
+#include "IndicatorSink.h"
+#include "ConsumerCursors.h"
+#include "BarAggregator.h"
+#include <string>
+#include "Clock.h"
+
+// Name of an indicator running at resolution: "SMA", or e.g. "SMA 1m" on bars
+inline std::string indicatorName(const std::string& base, BarResolution resolution) {
+    return resolution == BarResolution::Tick ? base : base + " " + barResolutionName(resolution);
+}
+
+// An indicator the IndicatorScheduler can run as per-symbol tasks.
+//
+// calculateSymbol() may run concurrently on different worker threads, but
+// never twice at once for the same symbol: the scheduler hands each symbol
+// to at most one task per pass and waits for the pass to finish before the
+// next one. Implementations therefore keep their state per symbol and use
+// thread-local (or per-call) scratch.
+//
+// Indicators with incremental state can also save and restore it, so a
+// restarted simulator continues from a checkpoint instead of warming up.
+//
+// Results go to an optional IndicatorSink as binary records; the console
+// only shows a sample of them (every logEvery()-th calculation).
+class IndicatorTask {
+public:
+    virtual ~IndicatorTask() = default;
+    
+    virtual const char* name() const = 0;
+    
+    /**
+     * @brief True if the symbol has ticks this indicator has not folded in yet
+     */
+    virtual bool hasNewData(SymbolId symbol) const = 0;
+    
+    /**
+     * @brief Bring one symbol's indicator up to date
+     * @return false if the symbol does not have enough data yet
+     */
+    virtual bool calculateSymbol(SymbolId symbol) = 0;
+    
+    /**
+     * @brief Serialize all per-symbol state for a checkpoint (see Checkpoint.h)
+     *
+     * Only called while no calculateSymbol() is running. The default
+     * (stateless indicator) writes nothing.
+     */
+    virtual void saveState(CheckpointWriter& out) const { (void)out; }
+    
+    /**
+     * @brief Restore state written by saveState(), before the first pass
+     * @param clock_shift Added to restored timestamps (the checkpoint was taken
+     *                    by an earlier process, see Checkpoint.h)
+     * @return false if the data does not fit this indicator (its state is then
+     *         left as constructed)
+     */
+    virtual bool loadState(CheckpointReader& in, TickClock::duration clock_shift) {
+        (void)in;
+        (void)clock_shift;
+        return false;
+    }
+    
+    /**
+     * @brief Attach the section a Checkpointer collects this indicator's state in
+     */
+    void attachCheckpoint(CheckpointSection* section) { checkpoint_ = section; }
+    
+    /**
+     * @brief Call after every pass, once no calculateSymbol() is running
+     *
+     * Hands a fresh copy of the state to the checkpointer when it has asked
+     * for one; otherwise costs two atomic loads.
+     */
+    void passComplete() {
+        if (checkpoint_ && checkpoint_->wanted()) {
+            checkpoint_->stage([this](CheckpointWriter& out) { saveState(out); });
+        }
+    }
+    
+    /**
+     * @brief Send every result to sink from now on (before the first pass)
+     *
+     * Implementations register their indicator names with the sink here.
+     * The default (an indicator without output) ignores it.
+     */
+    virtual void attachOutput(IndicatorSink& sink) { (void)sink; }
+    
+    /**
+     * @brief The indicator's cursor in the buffer (SharedBuffer::registerConsumer),
+     *        for choosing its overload policy; kNoConsumer if it has none
+     */
+    virtual ConsumerId consumerId() const { return kNoConsumer; }
+    
+    /**
+     * @brief Print every n-th result to the console (0 = never)
+     */
+    void setLogEvery(size_t n) { log_every_ = n; }
+    size_t logEvery() const { return log_every_; }
+
+protected:
+    // True if calculation number count is one the console shows
+    bool logSample(size_t count) const { return log_every_ > 0 && count % log_every_ == 0; }
+
+private:
+    CheckpointSection* checkpoint_ = nullptr;
+    size_t log_every_ = 20;
+};
+
+#endif // INDICATOR_TASK_H
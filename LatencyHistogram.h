@@ -0,0 +1,165 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "CacheLine.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+// Fixed-size, log-bucketed latency histogram (HDR-histogram style).
+//
+// Values are nanoseconds. Each power of two is split into kSubBuckets
+// linear sub-buckets, so any recorded value is reported within 1/kSubBuckets
+// (12.5%) of its true value, from 1 ns up to kMaxValue (about 18 minutes;
+// larger values land in the last bucket). Memory is constant no matter how
+// many samples are recorded.
+//
+// A histogram has a single writer (the thread that owns it) and any number
+// of readers. Counters are relaxed atomics: the writer publishes with plain
+// load+store (no read-modify-write), readers may see a sample in count()
+// before it shows up in its bucket, which is fine for reporting. Histograms
+// are cache-line aligned so two writers' histograms never share a line.
+class alignas(kCacheLineSize) LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxExponent) - 1;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+private:
+    std::array<std::atomic<uint32_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+    
+    static int log2Floor(uint64_t v) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(v);
+#else
+        int e = 0;
+        while (v >>= 1) ++e;
+        return e;
+#endif
+    }
+    
+    template <typename T>
+    static void bump(std::atomic<T>& a, T delta) {
+        a.store(a.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+public:
+    LatencyHistogram() : count_(0), sum_(0),
+                         min_(std::numeric_limits<uint64_t>::max()), max_(0) {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    }
+    
+    static size_t bucketIndex(uint64_t v) {
+        if (v > kMaxValue) v = kMaxValue;
+        if (v < kSubBuckets) return static_cast<size_t>(v);
+        int e = log2Floor(v);
+        uint64_t sub = (v >> (e - kSubBucketBits)) & (kSubBuckets - 1);
+        return static_cast<size_t>((e - kSubBucketBits + 1) * kSubBuckets + sub);
+    }
+    
+    // Smallest value that maps to bucket i
+    static uint64_t bucketLowerBound(size_t i) {
+        if (i < kSubBuckets) return i;
+        int e = static_cast<int>(i / kSubBuckets) + kSubBucketBits - 1;
+        uint64_t sub = i % kSubBuckets;
+        return (uint64_t(1) << e) + (sub << (e - kSubBucketBits));
+    }
+    
+    // Representative value reported for bucket i (its midpoint)
+    static uint64_t bucketValue(size_t i) {
+        if (i < kSubBuckets) return i;
+        int e = static_cast<int>(i / kSubBuckets) + kSubBucketBits - 1;
+        uint64_t width = uint64_t(1) << (e - kSubBucketBits);
+        return bucketLowerBound(i) + width / 2;
+    }
+    
+    /**
+     * @brief Owner thread only: record one sample
+     */
+    void record(uint64_t nanoseconds) {
+        bump(buckets_[bucketIndex(nanoseconds)], uint32_t(1));
+        bump(count_, uint64_t(1));
+        bump(sum_, nanoseconds);
+        if (nanoseconds < min_.load(std::memory_order_relaxed)) {
+            min_.store(nanoseconds, std::memory_order_relaxed);
+        }
+        if (nanoseconds > max_.load(std::memory_order_relaxed)) {
+            max_.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+    
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t min() const { return min_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    uint32_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+};
+
+// Plain (non-atomic) merge of several LatencyHistograms, built at report time.
+struct LatencySummary {
+    std::array<uint64_t, LatencyHistogram::kBucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = std::numeric_limits<uint64_t>::max();
+    uint64_t max = 0;
+    
+    void merge(const LatencyHistogram& h) {
+        uint64_t n = h.count();
+        if (n == 0) return;
+        for (size_t i = 0; i < buckets.size(); ++i) buckets[i] += h.bucket(i);
+        count += n;
+        sum += h.sum();
+        if (h.min() < min) min = h.min();
+        if (h.max() > max) max = h.max();
+    }
+    
+    void merge(const LatencySummary& other) {
+        if (other.count == 0) return;
+        for (size_t i = 0; i < buckets.size(); ++i) buckets[i] += other.buckets[i];
+        count += other.count;
+        sum += other.sum;
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+    }
+    
+    double mean() const {
+        return count ? static_cast<double>(sum) / count : 0.0;
+    }
+    
+    /**
+     * @brief Value at quantile q in [0, 1] (nanoseconds)
+     *
+     * Clamped to the exact observed [min, max], so p0/p100 are exact and
+     * small samples do not report values that were never seen.
+     */
+    uint64_t percentile(double q) const {
+        uint64_t total = 0;
+        for (uint64_t b : buckets) total += b;
+        if (total == 0) return 0;
+        
+        uint64_t rank = static_cast<uint64_t>(q * total + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > total) rank = total;
+        
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint64_t v = LatencyHistogram::bucketValue(i);
+                if (v < min) v = min;
+                if (v > max) v = max;
+                return v;
+            }
+        }
+        return max;
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,100 @@
+#ifndef LATEST_PRICE_BOARD_H
+#define LATEST_PRICE_BOARD_H
+
+#include "PriceData.h"
+#include "CacheLine.h"
+#include "Clock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// "Top of book": the latest price, change, volume and timestamp of every
+// symbol in a flat array indexed by symbol ID, one cache line per slot.
+//
+// Each slot is a seqlock owned by the producer that publishes the symbol
+// (producer shards own disjoint symbols, so every slot has one writer).
+// The writer makes the slot's version odd, writes the fields and makes it
+// even again; it never waits. A reader copies the fields between two loads
+// of the version and only retries when a write overlapped that copy, a
+// window of a few stores: in practice readers finish in one attempt and
+// never wait on a lock, the history rings or other readers.
+//
+// The board is separate from history storage, so latest-price readers
+// (display, future query clients) never touch ring columns the indicators
+// are streaming through.
+class LatestPriceBoard {
+private:
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<uint64_t> version{0};   // Odd while written; 2 x publishes
+        double price = 0.0;
+        double change = 0.0;
+        double volume = 0.0;
+        TickClock::rep timestamp = 0;
+    };
+    
+    std::unique_ptr<Slot[]> slots_;
+    size_t size_;
+
+public:
+    explicit LatestPriceBoard(size_t symbols)
+        : slots_(new Slot[symbols]), size_(symbols) {}
+    
+    LatestPriceBoard(const LatestPriceBoard&) = delete;
+    LatestPriceBoard& operator=(const LatestPriceBoard&) = delete;
+    
+    size_t size() const { return size_; }
+    
+    /**
+     * @brief Producer: publish data as its symbol's latest tick (one writer per symbol)
+     */
+    void publish(const PriceData& data) {
+        Slot& slot = slots_[data.symbol];
+        uint64_t version = slot.version.load(std::memory_order_relaxed);
+        slot.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);    // Odd version before the fields
+        
+        slot.price = data.price;
+        slot.change = data.change;
+        slot.volume = data.volume;
+        slot.timestamp = data.timestamp.time_since_epoch().count();
+        
+        slot.version.store(version + 2, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Changes with every publish of the symbol (0 = nothing published yet)
+     */
+    uint64_t version(SymbolId symbol) const {
+        return slots_[symbol].version.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Consumer: copy the symbol's latest tick
+     * @param version If given, receives the slot version read (see version())
+     * @return false if nothing was published for the symbol yet
+     */
+    bool read(SymbolId symbol, PriceData& out, uint64_t* version = nullptr) const {
+        const Slot& slot = slots_[symbol];
+        for (;;) {
+            uint64_t before = slot.version.load(std::memory_order_acquire);
+            if (before == 0) return false;
+            if (before & 1) continue;       // Write in progress (a few stores long)
+            
+            double price = slot.price;
+            double change = slot.change;
+            double volume = slot.volume;
+            TickClock::rep timestamp = slot.timestamp;
+            
+            std::atomic_thread_fence(std::memory_order_acquire);    // Fields before the re-check
+            if (slot.version.load(std::memory_order_relaxed) == before) {
+                out = PriceData(symbol, price, change, volume,
+                                TickClock::time_point(TickClock::duration(timestamp)));
+                if (version) *version = before;
+                return true;
+            }
+        }
+    }
+};
+
+#endif // LATEST_PRICE_BOARD_H
@@ -0,0 +1,471 @@
+#ifndef MULTICAST_FEED_H
+#define MULTICAST_FEED_H
+
+#include "PriceData.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "TickFile.h"
+#include "TickSource.h"
+#include "AlignedArray.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// Live market data over UDP (multicast or unicast).
+//
+// Every datagram is one packet (native byte order, like tick files):
+//
+//   FeedPacketHeader                       24 bytes
+//   TickFileRecord[record_count]           24 bytes each, at most kFeedMaxRecords
+//
+// so a packet fits one Ethernet frame. Record symbol ids are indexes into
+// the simulator's symbol list (the registry IDs: S1..SN are 0..N-1).
+// Packets of one feed are numbered 1, 2, 3, ...; a missing number is a
+// gap, an old one is late (dropped), and number 1 starts a new session
+// (publisher restart).
+
+constexpr char kFeedMagic[4] = {'S', 'T', 'K', 'F'};
+constexpr uint16_t kFeedVersion = 1;
+constexpr size_t kFeedMaxPacketBytes = 1472;    // UDP payload of a 1500-byte MTU frame
+
+struct FeedPacketHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_count;
+    uint64_t sequence;          // Packet number, from 1
+    int64_t send_time_ns;       // Publisher clock, informational
+};
+
+static_assert(sizeof(FeedPacketHeader) == 24, "feed packet header layout");
+
+constexpr size_t kFeedMaxRecords = (kFeedMaxPacketBytes - sizeof(FeedPacketHeader)) / sizeof(TickFileRecord);
+
+// Where a feed is received from / sent to: "GROUP:PORT", e.g. 239.255.0.1:30001
+struct FeedEndpoint {
+    in_addr group{};
+    uint16_t port = 0;
+    in_addr interface_address{};    // Local interface joining the group (INADDR_ANY: default route)
+    
+    bool multicast() const { return IN_MULTICAST(ntohl(group.s_addr)); }
+    
+    /**
+     * @return false if spec is not an IPv4 "address:port"
+     */
+    static bool parse(const std::string& spec, FeedEndpoint& out) {
+        size_t colon = spec.rfind(':');
+        if (colon == std::string::npos) return false;
+        try {
+            size_t pos = 0;
+            int port = std::stoi(spec.substr(colon + 1), &pos);
+            if (pos != spec.size() - colon - 1 || port < 1 || port > 65535) return false;
+            out.port = static_cast<uint16_t>(port);
+        } catch (...) {
+            return false;
+        }
+        return inet_pton(AF_INET, spec.substr(0, colon).c_str(), &out.group) == 1;
+    }
+    
+    std::string describe() const {
+        char text[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &group, text, sizeof(text));
+        return std::string(text) + ":" + std::to_string(port);
+    }
+};
+
+// Validates packets, tracks the sequence and turns records into ticks.
+//
+// Kept apart from the socket so benchmarks and tools can feed it packets
+// directly. Records are read in place from the packet bytes. Every symbol
+// is listed until setListed() says otherwise.
+class FeedDecoder {
+private:
+    size_t symbols_;
+    std::vector<double> last_prices_;   // Symbol ID -> previous price (for change)
+    std::vector<uint8_t> listed_;       // Symbol ID -> listed
+    uint64_t expected_ = 0;             // Next packet number (0: no packet yet)
+
+public:
+    explicit FeedDecoder(size_t symbols) : symbols_(symbols), last_prices_(symbols, 0.0), listed_(symbols, 1) {}
+    
+    uint64_t expectedSequence() const { return expected_; }
+    
+    /**
+     * @brief Publish ticks for these symbols only (a SymbolTable snapshot);
+     *        records for the others are counted as unlisted
+     */
+    void setListed(const std::vector<SymbolId>& listed) {
+        std::fill(listed_.begin(), listed_.end(), 0);
+        for (SymbolId id : listed) {
+            if (id < symbols_) listed_[id] = 1;
+        }
+    }
+    
+    /**
+     * @brief Append one packet's ticks to out, stamped with stamp
+     * @param stats Packet, gap, late and malformed counts, skipped records
+     *              and the ticks appended to out are added here
+     * @return false if the packet was dropped (malformed or late)
+     */
+    bool decode(const std::byte* packet, size_t length, TickClock::time_point stamp,
+                std::vector<PriceData>& out, FeedStats& stats) {
+        FeedPacketHeader header;
+        if (length < sizeof(header)) {
+            ++stats.malformed;
+            return false;
+        }
+        std::memcpy(&header, packet, sizeof(header));
+        if (std::memcmp(header.magic, kFeedMagic, sizeof(header.magic)) != 0 || header.version != kFeedVersion ||
+            header.record_count > kFeedMaxRecords ||
+            length != sizeof(header) + header.record_count * sizeof(TickFileRecord)) {
+            ++stats.malformed;
+            return false;
+        }
+        
+        ++stats.packets;
+        if (expected_ != 0 && header.sequence != 1) {
+            if (header.sequence < expected_) {
+                ++stats.late;
+                return false;
+            }
+            if (header.sequence > expected_) {
+                ++stats.gaps;
+                stats.missing += header.sequence - expected_;
+            }
+        }
+        expected_ = header.sequence + 1;
+        
+        const size_t first = out.size();
+        const std::byte* bytes = packet + sizeof(header);
+        for (uint16_t i = 0; i < header.record_count; ++i, bytes += sizeof(TickFileRecord)) {
+            TickFileRecord record;
+            std::memcpy(&record, bytes, sizeof(record));
+            if (record.symbol >= symbols_) {
+                ++stats.unknown_symbols;
+                continue;
+            }
+            if (!listed_[record.symbol]) {
+                ++stats.unlisted;
+                continue;
+            }
+            double& last = last_prices_[record.symbol];
+            double change = (last > 0.0) ? record.price - last : 0.0;
+            last = record.price;
+            out.emplace_back(static_cast<SymbolId>(record.symbol), record.price, change,
+                             static_cast<double>(record.size), stamp);
+        }
+        stats.ticks += out.size() - first;
+        return true;
+    }
+};
+
+namespace feed {
+
+/**
+ * @brief Encode up to kFeedMaxRecords records as one packet into out
+ * @return Packet length in bytes
+ */
+inline size_t encodePacket(const TickFileRecord* records, size_t count, uint64_t sequence,
+                           std::byte* out) {
+    FeedPacketHeader header = {};
+    std::memcpy(header.magic, kFeedMagic, sizeof(header.magic));
+    header.version = kFeedVersion;
+    header.record_count = static_cast<uint16_t>(std::min(count, kFeedMaxRecords));
+    header.sequence = sequence;
+    header.send_time_ns = TickClock::now().time_since_epoch().count();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), records, header.record_count * sizeof(TickFileRecord));
+    return sizeof(header) + header.record_count * sizeof(TickFileRecord);
+}
+
+[[noreturn]] inline void fail(const FeedEndpoint& endpoint, const std::string& what) {
+    throw std::runtime_error("feed " + endpoint.describe() + ": " + what + " (" + std::strerror(errno) + ")");
+}
+
+}  // namespace feed
+
+// Sends ticks as feed packets, several packets per sendmmsg() call (tools,
+// benchmarks, tests; the simulator only receives).
+class MulticastTickPublisher {
+private:
+    static constexpr size_t kBatch = 64;
+    
+    FeedEndpoint endpoint_;
+    int fd_;
+    sockaddr_in destination_;
+    uint64_t next_sequence_ = 1;
+    AlignedArray<std::byte> packets_;
+    iovec iov_[kBatch];
+    mmsghdr messages_[kBatch];
+
+public:
+    /**
+     * @param ttl Multicast hops (1 stays on the local network)
+     * @throws std::runtime_error if the socket cannot be set up
+     */
+    explicit MulticastTickPublisher(const FeedEndpoint& endpoint, int ttl = 1)
+        : endpoint_(endpoint), fd_(-1), destination_(), packets_(kBatch * kFeedMaxPacketBytes) {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) feed::fail(endpoint, "socket");
+        if (endpoint.multicast()) {
+            unsigned char hops = static_cast<unsigned char>(ttl);
+            unsigned char loop = 1;     // Receivers on this host get the feed too
+            if (::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops)) != 0 ||
+                ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+                (endpoint.interface_address.s_addr != INADDR_ANY &&
+                 ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &endpoint.interface_address,
+                              sizeof(endpoint.interface_address)) != 0)) {
+                ::close(fd_);
+                feed::fail(endpoint, "multicast options");
+            }
+        }
+        destination_.sin_family = AF_INET;
+        destination_.sin_port = htons(endpoint.port);
+        destination_.sin_addr = endpoint.group;
+        for (size_t i = 0; i < kBatch; ++i) {
+            iov_[i].iov_base = packets_.data() + i * kFeedMaxPacketBytes;
+            std::memset(&messages_[i], 0, sizeof(messages_[i]));
+            messages_[i].msg_hdr.msg_name = &destination_;
+            messages_[i].msg_hdr.msg_namelen = sizeof(destination_);
+            messages_[i].msg_hdr.msg_iov = &iov_[i];
+            messages_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+    
+    ~MulticastTickPublisher() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+    
+    MulticastTickPublisher(const MulticastTickPublisher&) = delete;
+    MulticastTickPublisher& operator=(const MulticastTickPublisher&) = delete;
+    
+    /**
+     * @brief Number the next packet next (e.g. to simulate a gap or a restart)
+     */
+    void setNextSequence(uint64_t next) { next_sequence_ = next; }
+    uint64_t nextSequence() const { return next_sequence_; }
+    
+    /**
+     * @brief Send records as consecutive packets of up to kFeedMaxRecords
+     * @return Packets sent (fewer than needed only if the socket failed)
+     */
+    size_t publish(const TickFileRecord* records, size_t count) {
+        size_t sent = 0;
+        while (count > 0) {
+            unsigned packets = 0;
+            while (count > 0 && packets < kBatch) {
+                size_t n = std::min(count, kFeedMaxRecords);
+                iov_[packets].iov_len = feed::encodePacket(records, n, next_sequence_ + packets,
+                                                           static_cast<std::byte*>(iov_[packets].iov_base));
+                records += n;
+                count -= n;
+                ++packets;
+            }
+            unsigned done = 0;
+            while (done < packets) {
+                int n = ::sendmmsg(fd_, messages_ + done, packets - done, 0);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    next_sequence_ += done;
+                    return sent + done;
+                }
+                done += static_cast<unsigned>(n);
+            }
+            next_sequence_ += packets;
+            sent += packets;
+        }
+        return sent;
+    }
+};
+
+// Producer fed by a UDP feed instead of a generator.
+//
+// One receive thread pulls up to kBatch datagrams per recvmmsg() call into
+// preallocated packet buffers, decodes every record in place and
+// publishes the whole call's ticks with a single pushBatch(). Consumers
+// see it as any other TickSource. Only listed symbols are published: the
+// thread checks its SymbolTable::Reader once per call and hands the
+// decoder the new listing when it changed. Ticks are stamped with the local receive
+// time, so PerformanceMonitor latencies measure our pipeline from the
+// socket on; feed gaps and late/malformed packets are counted there too.
+//
+// With busy_poll_us > 0 the socket gets SO_BUSY_POLL and the thread spins
+// on non-blocking receives instead of sleeping in the kernel (lowest
+// latency, one core at 100%). Otherwise receives block, waking every
+// 100 ms to honor stop().
+class MulticastTickReceiver : public TickSource {
+private:
+    static constexpr size_t kBatch = 64;                // Datagrams per recvmmsg()
+    static constexpr size_t kSlotBytes = 2048;          // Per datagram; larger ones are truncated (malformed)
+    static constexpr int kReceiveBufferBytes = 8 << 20;
+    
+    SharedBuffer& buffer_;
+    PerformanceMonitor& perf_monitor_;
+    FeedEndpoint endpoint_;
+    int busy_poll_us_;
+    int fd_;
+    
+    FeedDecoder decoder_;
+    AlignedArray<std::byte> packets_;
+    iovec iov_[kBatch];
+    mmsghdr messages_[kBatch];
+    std::vector<PriceData> batch_;                      // One recvmmsg() worth of ticks, reused
+    
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+public:
+    /**
+     * @param busy_poll_us SO_BUSY_POLL microseconds and spinning receives (0 = blocking)
+     * @throws std::runtime_error if the socket cannot be bound or the group joined
+     */
+    MulticastTickReceiver(SharedBuffer& buffer, PerformanceMonitor& perf_monitor,
+                          const FeedEndpoint& endpoint, int busy_poll_us = 0)
+        : buffer_(buffer), perf_monitor_(perf_monitor), endpoint_(endpoint),
+          busy_poll_us_(busy_poll_us > 0 ? busy_poll_us : 0), fd_(-1),
+          decoder_(buffer.registry().capacity()), packets_(kBatch * kSlotBytes), running_(false) {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) feed::fail(endpoint, "socket");
+        
+        int one = 1;
+        int receive_buffer = kReceiveBufferBytes;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));   // Best effort
+        
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(endpoint.port);
+        address.sin_addr.s_addr = endpoint.multicast() ? endpoint.group.s_addr : htonl(INADDR_ANY);
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd_);
+            feed::fail(endpoint, "bind");
+        }
+        if (endpoint.multicast()) {
+            ip_mreq membership = {};
+            membership.imr_multiaddr = endpoint.group;
+            membership.imr_interface = endpoint.interface_address;
+            if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+                ::close(fd_);
+                feed::fail(endpoint, "join group");
+            }
+        }
+        
+        if (busy_poll_us_ > 0) {
+#ifdef SO_BUSY_POLL
+            if (::setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us_, sizeof(busy_poll_us_)) != 0) {
+                std::cerr << "[MulticastTickReceiver] SO_BUSY_POLL refused (" << std::strerror(errno)
+                          << "); spinning on non-blocking receives only\n";
+            }
+#endif
+        } else {
+            timeval timeout = {0, 100000};
+            ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+        
+        for (size_t i = 0; i < kBatch; ++i) {
+            iov_[i].iov_base = packets_.data() + i * kSlotBytes;
+            iov_[i].iov_len = kSlotBytes;
+            std::memset(&messages_[i], 0, sizeof(messages_[i]));
+            messages_[i].msg_hdr.msg_iov = &iov_[i];
+            messages_[i].msg_hdr.msg_iovlen = 1;
+        }
+        batch_.reserve(kBatch * kFeedMaxRecords);
+    }
+    
+    ~MulticastTickReceiver() override {
+        stop();
+        if (fd_ >= 0) ::close(fd_);
+    }
+    
+    void start() override {
+        bool expected = false;
+        if (running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&MulticastTickReceiver::run, this);
+            std::cout << "[MulticastTickReceiver] Started receive thread (ID: " << thread_.get_id()
+                      << ") on " << endpoint_.describe()
+                      << (busy_poll_us_ > 0 ? " (busy polling)\n" : "\n");
+        }
+    }
+    
+    void stop() override {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            std::cout << "[MulticastTickReceiver] Receive thread stopped\n";
+        }
+    }
+
+private:
+    void run() {
+        std::vector<SymbolId> symbols;
+        for (size_t id = 0; id < buffer_.registry().capacity(); ++id) symbols.push_back(static_cast<SymbolId>(id));
+        placeProducerThread(buffer_, symbols, "MulticastTickReceiver");
+        SymbolTable::Reader listed(buffer_.symbolTable());
+        decoder_.setListed(listed.symbols());
+        std::cout << "[MulticastTickReceiver] Receive loop starting...\n";
+        
+        const bool spin = busy_poll_us_ > 0;
+        const int flags = spin ? MSG_DONTWAIT : MSG_WAITFORONE;
+        uint64_t calls = 0;
+        uint64_t datagrams = 0;
+        uint64_t published = 0;
+        
+        while (running_.load()) {
+            int n = ::recvmmsg(fd_, messages_, kBatch, flags, nullptr);
+            if (n <= 0) {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    std::cerr << "[MulticastTickReceiver] recvmmsg failed: " << std::strerror(errno) << "\n";
+                    break;
+                }
+                continue;   // Timeout (blocking) or nothing yet (spinning)
+            }
+            
+            if (listed.refresh()) decoder_.setListed(listed.symbols());
+            const auto stamp = TickClock::now();    // One clock read per call
+            FeedStats stats;
+            batch_.clear();
+            for (int i = 0; i < n; ++i) {
+                const msghdr& header = messages_[i].msg_hdr;
+                if (header.msg_flags & MSG_TRUNC) {
+                    ++stats.malformed;
+                    continue;
+                }
+                decoder_.decode(static_cast<const std::byte*>(iov_[i].iov_base), messages_[i].msg_len,
+                                stamp, batch_, stats);
+            }
+            
+            if (!batch_.empty()) {
+                buffer_.pushBatch(batch_);
+                perf_monitor_.recordGenerationBatch(batch_);
+                published += batch_.size();
+            }
+            perf_monitor_.recordFeed(stats);
+            ++calls;
+            datagrams += static_cast<uint64_t>(n);
+        }
+        
+        std::cout << "[MulticastTickReceiver] Receive loop exited after " << published << " ticks from "
+                  << datagrams << " datagrams in " << calls << " receive calls";
+        if (calls > 0) {
+            std::cout << " (" << std::fixed << std::setprecision(1)
+                      << static_cast<double>(datagrams) / calls << " per call)";
+        }
+        std::cout << "\n";
+    }
+};
+
+#endif // MULTICAST_FEED_H
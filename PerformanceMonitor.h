@@ -2,112 +2,351 @@
 #define PERFORMANCE_MONITOR_H
 
 #include "PriceData.h"
+#include "SymbolRegistry.h"
+#include "LatencyHistogram.h"
+#include "CacheLine.h"
+#include "ShardedCounter.h"
+#include "Trace.h"
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
-#include <map>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <iomanip>
-#include <numeric>
-#include <algorithm>
 
-// Collects simple latency and throughput stats for the simulator.
+// Dense handle for a measured operation ("SMA", "Volatility", ...).
+using OperationId = uint32_t;
+
+// Packet accounting of a network feed (MulticastFeed.h)
+struct FeedStats {
+    uint64_t packets = 0;           // Valid packets, late ones included
+    uint64_t ticks = 0;             // Records published as ticks
+    uint64_t gaps = 0;              // Jumps in the packet sequence
+    uint64_t missing = 0;           // Packets those jumps skipped
+    uint64_t late = 0;              // Older than the sequence already seen (dropped)
+    uint64_t malformed = 0;         // Truncated, wrong magic/version or bad length (dropped)
+    uint64_t unknown_symbols = 0;   // Records for a symbol ID outside the symbol list (skipped)
+    uint64_t unlisted = 0;          // Records for a delisted or not yet listed symbol (skipped)
+};
+
+// Collects latency and throughput stats for the simulator.
+//
+// Latencies go into fixed-size log-bucketed histograms (LatencyHistogram),
+// one per (symbol, operation) per recording thread, so memory stays bounded
+// however long the simulator runs and the record path takes no lock: each
+// thread only ever touches its own table. Reports merge the per-thread
+// histograms on demand.
 class PerformanceMonitor {
+public:
+    static constexpr size_t kMaxOperations = 8;
+
 private:
-    // Latency measurements per symbol and operation
-    struct LatencyRecord {
-        std::chrono::high_resolution_clock::time_point generation_time;
-        std::chrono::high_resolution_clock::time_point processing_time;
-        std::string operation;  // "SMA", "Volatility", etc.
-        double latency_microseconds;
+    // Histograms written by one recording thread, indexed by
+    // symbol * kMaxOperations + operation. Allocated lazily by the owner
+    // and published with a release store so reporters can read them.
+    struct ThreadTable {
+        std::thread::id owner;
+        std::vector<std::atomic<LatencyHistogram*>> histograms;
+        
+        ThreadTable(std::thread::id id, size_t slots) : owner(id), histograms(slots) {
+            for (auto& h : histograms) h.store(nullptr, std::memory_order_relaxed);
+        }
+        
+        ~ThreadTable() {
+            for (auto& h : histograms) delete h.load(std::memory_order_relaxed);
+        }
     };
     
-    std::map<std::string, std::vector<LatencyRecord>> latency_records_;  // symbol -> records
-    std::map<std::string, std::chrono::high_resolution_clock::time_point> generation_times_;  // symbol -> last gen time
+    // Symbol names are only looked up when printing the report
+    const SymbolRegistry& registry_;
+    const uint64_t instance_id_;  // Distinguishes monitors in the thread-local table cache
+    
+    std::array<std::string, kMaxOperations> operations_;    // operation id -> name
+    std::atomic<size_t> operation_count_;
+    
+    std::vector<std::unique_ptr<ThreadTable>> tables_;      // One per recording thread
+    // symbol id -> last gen time; padded, since neighbouring symbols are
+    // usually written by different producer shards
+    std::vector<CachePadded<std::atomic<TickClock::rep>>> generation_times_;
+    
+    mutable std::mutex mutex_;  // Protects operation and table registration (not the record path)
     
-    mutable std::mutex mutex_;  // Protects all shared data
+    // System start time for uptime calculation (coarse wall clock is plenty)
+    CoarseClock::time_point start_time_;
     
-    // System start time for uptime calculation
-    std::chrono::high_resolution_clock::time_point start_time_;
+    // Statistics (one slot per producer thread)
+    ShardedCounter total_generations_;
     
-    // Statistics
-    size_t total_generations_;
-    size_t total_calculations_;
+    // Feed packet counts, written by the receive thread once per receive call
+    struct FeedCounters {
+        std::atomic<uint64_t> packets{0}, ticks{0}, gaps{0}, missing{0}, late{0}, malformed{0}, unknown_symbols{0},
+            unlisted{0};
+    };
+    FeedCounters feed_;
+    
+    static uint64_t nextInstanceId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief The calling thread's histogram table (registered on first use)
+     */
+    ThreadTable& localTable() {
+        struct Cache {
+            uint64_t instance = 0;
+            ThreadTable* table = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.instance == instance_id_) {
+            return *cache.table;
+        }
+        
+        // Slow path: first record from this thread (or it last recorded to
+        // another monitor). Reuse the thread's table if it already has one.
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::thread::id self = std::this_thread::get_id();
+        ThreadTable* table = nullptr;
+        for (auto& t : tables_) {
+            if (t->owner == self) {
+                table = t.get();
+                break;
+            }
+        }
+        if (!table) {
+            tables_.push_back(std::make_unique<ThreadTable>(self, registry_.capacity() * kMaxOperations));
+            table = tables_.back().get();
+        }
+        cache.instance = instance_id_;
+        cache.table = table;
+        return *table;
+    }
+    
+    OperationId findOperationLocked(const std::string& operation) const {
+        size_t count = operation_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            if (operations_[i] == operation) return static_cast<OperationId>(i);
+        }
+        return static_cast<OperationId>(kMaxOperations);
+    }
+    
+    // Merge every thread's histogram for (symbol, operation); caller holds mutex_
+    void mergeLocked(SymbolId symbol, OperationId operation, LatencySummary& summary) const {
+        size_t slot = static_cast<size_t>(symbol) * kMaxOperations + operation;
+        for (const auto& table : tables_) {
+            const LatencyHistogram* h = table->histograms[slot].load(std::memory_order_acquire);
+            if (h) summary.merge(*h);
+        }
+    }
+    
+    size_t totalCalculationsLocked() const {
+        size_t total = 0;
+        for (const auto& table : tables_) {
+            for (const auto& slot : table->histograms) {
+                const LatencyHistogram* h = slot.load(std::memory_order_acquire);
+                if (h) total += h->count();
+            }
+        }
+        return total;
+    }
 
 public:
-    PerformanceMonitor() 
-        : start_time_(std::chrono::high_resolution_clock::now()),
-          total_generations_(0), total_calculations_(0) {}
+    explicit PerformanceMonitor(const SymbolRegistry& registry) 
+        : registry_(registry),
+          instance_id_(nextInstanceId()),
+          operation_count_(0),
+          generation_times_(registry.capacity()),
+          start_time_(CoarseClock::now()) {
+        for (auto& t : generation_times_) t->store(0, std::memory_order_relaxed);
+    }
     
-    void recordGeneration(const std::string& symbol, 
-                         const std::chrono::high_resolution_clock::time_point& timestamp) {
+    PerformanceMonitor(const PerformanceMonitor&) = delete;
+    PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
+    
+    /**
+     * @brief Register an operation name and get its ID (call at startup)
+     * @return The existing ID if the name is already registered
+     * @throws std::length_error if more than kMaxOperations are registered
+     */
+    OperationId registerOperation(const std::string& operation) {
         std::unique_lock<std::mutex> lock(mutex_);
-        generation_times_[symbol] = timestamp;
-        ++total_generations_;
+        OperationId id = findOperationLocked(operation);
+        if (id < kMaxOperations) return id;
+        
+        size_t count = operation_count_.load(std::memory_order_relaxed);
+        if (count >= kMaxOperations) {
+            throw std::length_error("PerformanceMonitor: too many operations");
+        }
+        operations_[count] = operation;
+        operation_count_.store(count + 1, std::memory_order_release);
+        return static_cast<OperationId>(count);
     }
     
-    void recordProcessing(const std::string& symbol,
-                         const std::string& operation,
-                         const std::chrono::high_resolution_clock::time_point& generation_time,
-                         const std::chrono::high_resolution_clock::time_point& processing_time) {
-        std::unique_lock<std::mutex> lock(mutex_);
+    void recordGeneration(SymbolId symbol, 
+                         const TickClock::time_point& timestamp) {
+        if (symbol < generation_times_.size()) {
+            generation_times_[symbol]->store(timestamp.time_since_epoch().count(),
+                                             std::memory_order_relaxed);
+        }
+        total_generations_.add();
+    }
+    
+    /**
+     * @brief Record a whole iteration's ticks with one counter update
+     */
+    void recordGenerationBatch(const PriceData* ticks, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (ticks[i].symbol < generation_times_.size()) {
+                generation_times_[ticks[i].symbol]->store(ticks[i].timestamp.time_since_epoch().count(),
+                                                          std::memory_order_relaxed);
+            }
+        }
+        total_generations_.add(count);
+    }
+    
+    void recordGenerationBatch(const std::vector<PriceData>& ticks) {
+        recordGenerationBatch(ticks.data(), ticks.size());
+    }
+    
+    /**
+     * @brief Add one receive call's packet accounting (see FeedDecoder)
+     */
+    void recordFeed(const FeedStats& delta) {
+        auto add = [](std::atomic<uint64_t>& counter, uint64_t n) {
+            if (n) counter.fetch_add(n, std::memory_order_relaxed);
+        };
+        add(feed_.packets, delta.packets);
+        add(feed_.ticks, delta.ticks);
+        add(feed_.gaps, delta.gaps);
+        add(feed_.missing, delta.missing);
+        add(feed_.late, delta.late);
+        add(feed_.malformed, delta.malformed);
+        add(feed_.unknown_symbols, delta.unknown_symbols);
+        add(feed_.unlisted, delta.unlisted);
+    }
+    
+    FeedStats getFeedStats() const {
+        FeedStats stats;
+        stats.packets = feed_.packets.load(std::memory_order_relaxed);
+        stats.ticks = feed_.ticks.load(std::memory_order_relaxed);
+        stats.gaps = feed_.gaps.load(std::memory_order_relaxed);
+        stats.missing = feed_.missing.load(std::memory_order_relaxed);
+        stats.late = feed_.late.load(std::memory_order_relaxed);
+        stats.malformed = feed_.malformed.load(std::memory_order_relaxed);
+        stats.unknown_symbols = feed_.unknown_symbols.load(std::memory_order_relaxed);
+        stats.unlisted = feed_.unlisted.load(std::memory_order_relaxed);
+        return stats;
+    }
+    
+    /**
+     * @brief Record one generation-to-processing latency (lock-free)
+     *
+     * Only the calling thread's own histogram is written.
+     */
+    void recordProcessing(SymbolId symbol,
+                         OperationId operation,
+                         const TickClock::time_point& generation_time,
+                         const TickClock::time_point& processing_time) {
+        if (symbol >= registry_.capacity() || operation >= kMaxOperations) {
+            return;
+        }
         
-        LatencyRecord record;
-        record.generation_time = generation_time;
-        record.processing_time = processing_time;
-        record.operation = operation;
+        TRACE_SPAN("record");
+        ThreadTable& table = localTable();
+        std::atomic<LatencyHistogram*>& slot =
+            table.histograms[static_cast<size_t>(symbol) * kMaxOperations + operation];
+        LatencyHistogram* histogram = slot.load(std::memory_order_relaxed);
+        if (!histogram) {
+            histogram = new LatencyHistogram();
+            slot.store(histogram, std::memory_order_release);
+        }
         
-        // Calculate latency in microseconds
-        record.latency_microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             processing_time - generation_time).count();
-        
-        latency_records_[symbol].push_back(record);
-        ++total_calculations_;
+        histogram->record(latency_ns > 0 ? static_cast<uint64_t>(latency_ns) : 0);
+    }
+    
+    /**
+     * @brief Name-based overload; registers the operation on first use
+     */
+    void recordProcessing(SymbolId symbol,
+                         const std::string& operation,
+                         const TickClock::time_point& generation_time,
+                         const TickClock::time_point& processing_time) {
+        recordProcessing(symbol, registerOperation(operation), generation_time, processing_time);
+    }
+    
+    /**
+     * @brief Merged latency distribution for one symbol and operation (nanoseconds)
+     */
+    LatencySummary getLatencySummary(SymbolId symbol, OperationId operation) const {
+        LatencySummary summary;
+        if (symbol >= registry_.capacity() || operation >= kMaxOperations) {
+            return summary;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        mergeLocked(symbol, operation, summary);
+        return summary;
+    }
+    
+    /**
+     * @brief Merged latency distribution over every symbol and operation (nanoseconds)
+     */
+    LatencySummary getTotalLatencySummary() const {
+        LatencySummary summary;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (const auto& table : tables_) {
+            for (const auto& slot : table->histograms) {
+                const LatencyHistogram* h = slot.load(std::memory_order_acquire);
+                if (h) summary.merge(*h);
+            }
+        }
+        return summary;
     }
     
-    void getLatencyStats(const std::string& symbol,
+    void getLatencyStats(SymbolId symbol,
                         const std::string& operation,
                         double& min_latency,
                         double& max_latency,
                         double& avg_latency,
                         size_t& sample_count) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        auto it = latency_records_.find(symbol);
-        if (it == latency_records_.end()) {
-            min_latency = max_latency = avg_latency = 0.0;
-            sample_count = 0;
-            return;
+        OperationId id;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            id = findOperationLocked(operation);
         }
         
-        // Filter records by operation
-        std::vector<double> latencies;
-        for (const auto& record : it->second) {
-            if (record.operation == operation) {
-                latencies.push_back(record.latency_microseconds);
-            }
-        }
-        
-        if (latencies.empty()) {
+        LatencySummary summary = getLatencySummary(symbol, id);
+        if (summary.count == 0) {
             min_latency = max_latency = avg_latency = 0.0;
             sample_count = 0;
             return;
         }
         
-        // Calculate statistics
-        min_latency = *std::min_element(latencies.begin(), latencies.end());
-        max_latency = *std::max_element(latencies.begin(), latencies.end());
-        avg_latency = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-        sample_count = latencies.size();
+        // Report in microseconds
+        min_latency = summary.min / 1000.0;
+        max_latency = summary.max / 1000.0;
+        avg_latency = summary.mean() / 1000.0;
+        sample_count = summary.count;
     }
     
-    void printReport() {
+    /**
+     * @brief Print totals and latency tables
+     * @param per_symbol Include one row per symbol and operation (off for large symbol sets)
+     */
+    void printReport(bool per_symbol = true) {
         std::unique_lock<std::mutex> lock(mutex_);
         
-        auto now = std::chrono::high_resolution_clock::now();
+        auto now = CoarseClock::now();
         auto uptime_seconds = std::chrono::duration_cast<std::chrono::seconds>(
             now - start_time_).count();
+        size_t total_generations = total_generations_.total();
+        size_t total_calculations = totalCalculationsLocked();
         
         std::cout << "\n\n";
         std::cout << "====================================================\n";
@@ -115,73 +354,107 @@ public:
         std::cout << "====================================================\n\n";
         
         std::cout << "System Uptime: " << uptime_seconds << " seconds\n";
-        std::cout << "Total Price Generations: " << total_generations_ << "\n";
-        std::cout << "Total Indicator Calculations: " << total_calculations_ << "\n";
+        std::cout << "Total Price Generations: " << total_generations << "\n";
+        std::cout << "Total Indicator Calculations: " << total_calculations << "\n";
         
         if (uptime_seconds > 0) {
-            double gen_per_sec = static_cast<double>(total_generations_) / uptime_seconds;
-            double calc_per_sec = static_cast<double>(total_calculations_) / uptime_seconds;
+            double gen_per_sec = static_cast<double>(total_generations) / uptime_seconds;
+            double calc_per_sec = static_cast<double>(total_calculations) / uptime_seconds;
             std::cout << "Generation Rate: " << std::fixed << std::setprecision(2) 
                       << gen_per_sec << " ops/sec\n";
             std::cout << "Calculation Rate: " << calc_per_sec << " ops/sec\n";
         }
         
-        std::cout << "\n--- Latency Statistics (microseconds) ---\n\n";
-        std::cout << std::setw(10) << "Symbol" 
-                  << std::setw(15) << "Operation" 
-                  << std::setw(12) << "Samples"
-              << std::setw(12) << "Min (us)"
-              << std::setw(12) << "Max (us)"
-              << std::setw(12) << "Avg (us)" << "\n";
-        std::cout << std::string(73, '-') << "\n";
-        
-        for (const auto& symbol_pair : latency_records_) {
-            const std::string& symbol = symbol_pair.first;
-            
-            // Get unique operations for this symbol
-            std::vector<std::string> operations;
-            for (const auto& record : symbol_pair.second) {
-                if (std::find(operations.begin(), operations.end(), record.operation) == operations.end()) {
-                    operations.push_back(record.operation);
-                }
+        FeedStats feed = getFeedStats();
+        if (feed.packets > 0 || feed.malformed > 0) {
+            uint64_t expected = feed.packets - feed.late + feed.missing;
+            std::cout << "\n--- Market Data Feed ---\n";
+            std::cout << "Packets: " << feed.packets << " (" << feed.ticks << " ticks)\n";
+            std::cout << "Gaps: " << feed.gaps << " (" << feed.missing << " packets missing";
+            if (expected > 0) {
+                std::cout << ", " << std::fixed << std::setprecision(3)
+                          << 100.0 * feed.missing / expected << "% loss";
+            }
+            std::cout << ")\n";
+            std::cout << "Late / Malformed: " << feed.late << " / " << feed.malformed << "\n";
+            if (feed.unknown_symbols > 0) {
+                std::cout << "Unknown Symbol Records: " << feed.unknown_symbols << "\n";
             }
+            if (feed.unlisted > 0) {
+                std::cout << "Unlisted Symbol Records: " << feed.unlisted << "\n";
+            }
+        }
+        
+        auto printHeader = [](const char* first) {
+            std::cout << std::setw(10) << first
+                      << std::setw(12) << "Operation"
+                      << std::setw(10) << "Samples"
+                      << std::setw(10) << "Min"
+                      << std::setw(10) << "Avg"
+                      << std::setw(10) << "p50"
+                      << std::setw(10) << "p90"
+                      << std::setw(10) << "p99"
+                      << std::setw(10) << "p99.9"
+                      << std::setw(10) << "Max" << "\n";
+            std::cout << std::string(102, '-') << "\n";
+        };
+        
+        auto printRow = [](const std::string& first, const std::string& op, const LatencySummary& s) {
+            std::cout << std::setw(10) << first
+                      << std::setw(12) << op
+                      << std::setw(10) << s.count
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(10) << s.min / 1000.0
+                      << std::setw(10) << s.mean() / 1000.0
+                      << std::setw(10) << s.percentile(0.50) / 1000.0
+                      << std::setw(10) << s.percentile(0.90) / 1000.0
+                      << std::setw(10) << s.percentile(0.99) / 1000.0
+                      << std::setw(10) << s.percentile(0.999) / 1000.0
+                      << std::setw(10) << s.max / 1000.0 << "\n";
+        };
+        
+        size_t operation_count = operation_count_.load(std::memory_order_acquire);
+        std::vector<LatencySummary> by_operation(operation_count);
+        
+        if (per_symbol) {
+            std::cout << "\n--- Latency Statistics (microseconds) ---\n\n";
+            printHeader("Symbol");
+        }
+        
+        for (size_t id = 0; id < registry_.size(); ++id) {
+            const std::string& symbol = registry_.name(static_cast<SymbolId>(id));
             
-            // Print stats for each operation
-            for (const auto& op : operations) {
-                std::vector<double> latencies;
-                for (const auto& record : symbol_pair.second) {
-                    if (record.operation == op) {
-                        latencies.push_back(record.latency_microseconds);
-                    }
-                }
+            // Print stats for each operation this symbol has samples for
+            for (size_t op = 0; op < operation_count; ++op) {
+                LatencySummary summary;
+                mergeLocked(static_cast<SymbolId>(id), static_cast<OperationId>(op), summary);
+                if (summary.count == 0) continue;
+                
+                if (per_symbol) printRow(symbol, operations_[op], summary);
                 
-                if (!latencies.empty()) {
-                    double min_lat = *std::min_element(latencies.begin(), latencies.end());
-                    double max_lat = *std::max_element(latencies.begin(), latencies.end());
-                    double avg_lat = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-                    
-                    std::cout << std::setw(10) << symbol
-                              << std::setw(15) << op
-                              << std::setw(12) << latencies.size()
-                              << std::setw(12) << std::fixed << std::setprecision(2) << min_lat
-                              << std::setw(12) << max_lat
-                              << std::setw(12) << avg_lat << "\n";
-                }
+                by_operation[op].merge(summary);  // Fold into the all-symbols distribution
             }
         }
         
+        std::cout << "\n--- Latency by Operation, All Symbols (microseconds) ---\n\n";
+        printHeader("");
+        for (size_t op = 0; op < operation_count; ++op) {
+            if (by_operation[op].count == 0) continue;
+            printRow("ALL", operations_[op], by_operation[op]);
+        }
+        
         std::cout << "\n====================================================\n\n";
     }
     
     void getSystemStats(size_t& generations, size_t& calculations, double& uptime_seconds) {
         std::unique_lock<std::mutex> lock(mutex_);
         
-        auto now = std::chrono::high_resolution_clock::now();
+        auto now = CoarseClock::now();
         uptime_seconds = std::chrono::duration_cast<std::chrono::seconds>(
             now - start_time_).count();
         
-        generations = total_generations_;
-        calculations = total_calculations_;
+        generations = total_generations_.total();
+        calculations = totalCalculationsLocked();
     }
 };
 
@@ -1,27 +1,35 @@
 #ifndef PRICE_DATA_H
 #define PRICE_DATA_H
 
+#include "SymbolRegistry.h"
+#include "Clock.h"
 #include <string>
 #include <chrono>
 
 // Represents a single price update with timestamp.
+// Trivially copyable: the symbol is an interned ID (see SymbolRegistry).
 struct PriceData {
-    std::string symbol;                                          // Stock symbol (e.g., "AAPL", "BTC")
+    SymbolId symbol;                                             // Interned stock symbol (e.g., "AAPL", "BTC")
     double price;                                                // Current price
     double change;                                               // Price change from previous tick
-    std::chrono::high_resolution_clock::time_point timestamp;    // High-precision timestamp for latency measurement
+    double volume;                                               // Traded size of this tick (0 if unknown)
+    TickClock::time_point timestamp;                             // High-precision timestamp for latency measurement
     
-    PriceData() : price(0.0), change(0.0) {}
+    PriceData() : symbol(kInvalidSymbolId), price(0.0), change(0.0), volume(0.0) {}
     
-    PriceData(const std::string& sym, double p, double c) 
-        : symbol(sym), price(p), change(c), 
-          timestamp(std::chrono::high_resolution_clock::now()) {}
+    PriceData(SymbolId sym, double p, double c, double v = 0.0) 
+        : symbol(sym), price(p), change(c), volume(v), 
+          timestamp(TickClock::now()) {}
+    
+    // With a timestamp taken once for a whole batch of ticks
+    PriceData(SymbolId sym, double p, double c, double v, TickClock::time_point ts)
+        : symbol(sym), price(p), change(c), volume(v), timestamp(ts) {}
 };
 
 // Captures basic timing info for one operation.
 struct PerformanceMetrics {
-    std::chrono::high_resolution_clock::time_point generation_time;  // When price was generated
-    std::chrono::high_resolution_clock::time_point processing_time;  // When indicator was calculated
+    TickClock::time_point generation_time;                            // When price was generated
+    TickClock::time_point processing_time;                            // When indicator was calculated
     std::string operation;                                            // Description of operation
     double latency_microseconds;                                      // Calculated latency
     
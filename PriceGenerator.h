@@ -4,101 +4,335 @@
 #include "PriceData.h"
 #include "SharedBuffer.h"
 #include "PerformanceMonitor.h"
+#include "TickSource.h"
+#include "CacheLine.h"
+#include "RandomKernels.h"
 #include <thread>
 #include <random>
 #include <atomic>
+#include <cmath>
 #include <vector>
+#include <memory>
 #include <iostream>
 
+// How symbols are split across producer shards.
+enum class SymbolPartition {
+    RoundRobin,     // symbol i -> shard i % shard_count (balances mixed universes)
+    Contiguous      // equal consecutive blocks of symbol IDs per shard
+};
+
+// How prices move from one tick to the next.
+enum class PriceModel {
+    RandomWalk,     // price += N(0, 0.5), floored at 1 (the original model)
+    Gbm             // Geometric Brownian motion with per-symbol drift and volatility
+};
+
+// GBM settings (annualized, 252 trading days of 6.5 hours)
+struct GbmParameters {
+    double drift = 0.05;            // mu
+    double volatility = 0.30;       // sigma
+    double spread = 0.5;            // Each symbol's sigma is volatility * U(1 - spread, 1 + spread)
+    double tick_seconds = 60.0;     // Trading time one tick represents
+};
+
 // Feeds the shared buffer with random price updates.
-class PriceGenerator {
+//
+// Symbols are split across shard_count producer threads. Each shard owns its
+// symbols' prices and its own random engine, and is the only writer of
+// those symbols' rings, so shards never contend with each other on the
+// buffer side and each ring keeps its single-writer guarantee.
+//
+// An iteration is generated a whole array at a time (RandomKernels.h): the
+// normals and uniforms for every symbol of the shard, then one vectorized
+// step of all prices (random walk or GBM), then the tick batch.
+//
+// Shards own symbol ID slots, not just the symbols registered today: the
+// registry's spare slots are split between them too, so a symbol listed
+// at runtime already has its writer. Each shard keeps state for all of its
+// slots and generates the listed ones (SymbolTable): when the table
+// version changes it compacts the listed slots into the arrays the
+// kernels run over, with no allocation, and otherwise never looks at the
+// table beyond one pointer load per iteration.
+class PriceGenerator : public TickSource {
 private:
+    static constexpr double kWalkStepStddev = 0.5;  // Random walk: price change stddev
+    static constexpr double kWalkFloor = 1.0;       // Random walk: lowest price
+    
+    // State owned by one producer thread, aligned so the tail of one shard
+    // (its engine state) never shares a line with the next shard's head
+    struct alignas(kCacheLineSize) Shard {
+        size_t index;
+        std::vector<SymbolId> owned;                // Symbol slots this shard writes (listed or not)
+        std::vector<double> owned_prices;           // Price of each slot while it is not being generated
+        std::vector<double> owned_drift;            // GBM terms of each slot
+        std::vector<double> owned_vol;
+        std::vector<uint32_t> active;               // Owned slot of each generated symbol
+        
+        std::vector<SymbolId> symbols;              // Listed symbols this shard generates
+        std::vector<double> current_prices;         // Current price for each of them
+        std::vector<PriceData> batch;               // One iteration's ticks, reused
+        
+        // Random number generation (thread-local to the shard)
+        rng::LaneState rng;
+        std::vector<double> normals;                // One iteration's draws, reused
+        std::vector<double> uniforms;               // Volume draws
+        std::vector<double> changes;
+        
+        // GBM terms per generated symbol: (mu - sigma^2 / 2) dt and sigma sqrt(dt)
+        std::vector<double> drift;
+        std::vector<double> vol;
+        
+        std::thread thread;                         // Worker thread
+        
+        Shard(size_t idx, uint64_t seed) : index(idx) { rng::seed(rng, seed); }
+    };
+    
     SharedBuffer& buffer_;                      // Reference to shared buffer (synchronization point)
     PerformanceMonitor& perf_monitor_;         // Performance tracking
-    std::vector<std::string> symbols_;          // Stock symbols to generate
-    std::vector<double> current_prices_;        // Current price for each symbol
+    std::vector<std::unique_ptr<Shard>> shards_;
+    
+    // Symbol ID -> owning shard and its slot there (kNotOwned: not generated)
+    static constexpr uint32_t kNotOwned = UINT32_MAX;
+    std::vector<uint32_t> shard_of_;
+    std::vector<uint32_t> slot_of_;
     
     std::atomic<bool> running_;                 // Thread-safe flag for shutdown
-    std::thread thread_;                        // Worker thread
     
     int update_interval_ms_;                    // Time between price updates
-    
-    // Random number generation (thread-local)
-    std::random_device rd_;
-    std::mt19937 gen_;
-    std::normal_distribution<> price_change_dist_;  // Normal distribution for realistic price changes
+    PriceModel model_;
+    GbmParameters gbm_;
 
 public:
+    /**
+     * @param symbols Symbol IDs to generate when listed (empty = every registry slot)
+     * @param update_interval_ms Sleep between iterations of each shard
+     * @param shard_count Number of producer threads (clamped to [1, symbols])
+     * @param partition How symbols are assigned to shards
+     */
     PriceGenerator(SharedBuffer& buffer, 
                    PerformanceMonitor& perf_monitor,
-                   const std::vector<std::string>& symbols = {"AAPL", "GOOGL", "MSFT", "AMZN", "BTC"},
-                   int update_interval_ms = 100)
-        : buffer_(buffer), perf_monitor_(perf_monitor), symbols_(symbols),
-          running_(false), update_interval_ms_(update_interval_ms),
-          gen_(rd_()), price_change_dist_(0.0, 0.5)  // Mean=0, StdDev=0.5 for price changes
+                   const std::vector<SymbolId>& symbols = {},
+                   int update_interval_ms = 100,
+                   size_t shard_count = 1,
+                   SymbolPartition partition = SymbolPartition::RoundRobin)
+        : buffer_(buffer), perf_monitor_(perf_monitor),
+          running_(false), update_interval_ms_(update_interval_ms), model_(PriceModel::RandomWalk)
     {
-        // Initialize starting prices
-        current_prices_.resize(symbols_.size());
-        std::uniform_real_distribution<> init_price_dist(100.0, 500.0);
-        for (auto& price : current_prices_) {
-            price = init_price_dist(gen_);
+        // Default: every symbol slot of the buffer (registered and spare)
+        size_t capacity = buffer_.registry().capacity();
+        std::vector<SymbolId> universe;
+        for (SymbolId id : symbols) {
+            if (id < capacity) universe.push_back(id);
+        }
+        if (symbols.empty()) {
+            for (size_t id = 0; id < capacity; ++id) {
+                universe.push_back(static_cast<SymbolId>(id));
+            }
+        }
+        
+        if (shard_count > universe.size()) shard_count = universe.size();
+        if (shard_count == 0) shard_count = 1;
+        
+        std::random_device rd;
+        for (size_t s = 0; s < shard_count; ++s) {
+            uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+            shards_.push_back(std::make_unique<Shard>(s, seed));
+        }
+        
+        // Assign symbol slots to shards
+        shard_of_.assign(capacity, kNotOwned);
+        slot_of_.assign(capacity, kNotOwned);
+        size_t block = (universe.size() + shard_count - 1) / shard_count;
+        for (size_t i = 0; i < universe.size(); ++i) {
+            size_t s = (partition == SymbolPartition::RoundRobin) ? i % shard_count : i / block;
+            shard_of_[universe[i]] = static_cast<uint32_t>(s);
+            slot_of_[universe[i]] = static_cast<uint32_t>(shards_[s]->owned.size());
+            shards_[s]->owned.push_back(universe[i]);
+        }
+        
+        // Initialize starting prices (continuing from the latest price when
+        // the buffer was restored from a checkpoint); every array is sized
+        // for all owned slots, so listing changes never reallocate
+        PriceData latest;
+        for (auto& shard : shards_) {
+            size_t n = shard->owned.size();
+            shard->owned_prices.resize(n);
+            shard->active.reserve(n);
+            shard->symbols.reserve(n);
+            shard->current_prices.reserve(n);
+            shard->batch.reserve(n);
+            shard->normals.resize(n);
+            shard->uniforms.resize(n);
+            shard->changes.resize(n);
+            
+            rng::fillUniform(shard->rng, shard->uniforms.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                shard->owned_prices[i] = buffer_.getLatest(shard->owned[i], latest)
+                                             ? latest.price : 100.0 + 400.0 * shard->uniforms[i];
+            }
+        }
+        
+        SymbolTable::Reader listed(buffer_.symbolTable());
+        for (auto& shard : shards_) {
+            syncListed(*shard, listed.symbols());
         }
     }
     
-    void start() {
+    size_t shardCount() const { return shards_.size(); }
+    
+    PriceModel model() const { return model_; }
+    
+    /**
+     * @brief Switch to GBM (before start()); each symbol gets its own volatility
+     *        around params.volatility (see GbmParameters::spread)
+     */
+    void useGbm(const GbmParameters& params) {
+        model_ = PriceModel::Gbm;
+        gbm_ = params;
+        for (auto& shard : shards_) {
+            size_t n = shard->owned.size();
+            shard->owned_drift.resize(n);
+            shard->owned_vol.resize(n);
+            shard->drift.resize(n);
+            shard->vol.resize(n);
+            rng::fillUniform(shard->rng, shard->uniforms.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                double sigma = params.volatility * (1.0 + params.spread * (2.0 * shard->uniforms[i] - 1.0));
+                setTerms(*shard, i, params.drift, sigma);
+            }
+            compactTerms(*shard);
+        }
+    }
+    
+    /**
+     * @brief Set one symbol's annual GBM drift and volatility (after useGbm(), before start())
+     * @return false if this generator does not produce the symbol
+     */
+    bool setSymbolGbm(SymbolId symbol, double drift, double volatility) {
+        if (symbol >= shard_of_.size() || shard_of_[symbol] == kNotOwned || model_ != PriceModel::Gbm) {
+            return false;
+        }
+        Shard& shard = *shards_[shard_of_[symbol]];
+        setTerms(shard, slot_of_[symbol], drift, volatility);
+        compactTerms(shard);
+        return true;
+    }
+    
+    void start() override {
         bool expected = false;
         if (running_.compare_exchange_strong(expected, true)) {
-            thread_ = std::thread(&PriceGenerator::run, this);
-            std::cout << "[PriceGenerator] Started producer thread (ID: " 
-                      << thread_.get_id() << ")\n";
+            for (auto& shard : shards_) {
+                shard->thread = std::thread(&PriceGenerator::run, this, shard.get());
+                std::cout << "[PriceGenerator] Started producer thread (ID: "
+                          << shard->thread.get_id() << ") for shard " << shard->index
+                          << " (" << shard->symbols.size() << " symbols)\n";
+            }
         }
     }
     
-    void stop() {
+    void stop() override {
         if (running_.exchange(false)) {
-            if (thread_.joinable()) {
-                thread_.join();
-                std::cout << "[PriceGenerator] Producer thread stopped\n";
+            for (auto& shard : shards_) {
+                if (shard->thread.joinable()) {
+                    shard->thread.join();
+                }
             }
+            std::cout << "[PriceGenerator] Producer threads stopped\n";
         }
     }
     
-    ~PriceGenerator() {
+    ~PriceGenerator() override {
         stop();
     }
 
 private:
-    void run() {
-        std::cout << "[PriceGenerator] Producer loop starting...\n";
+    // GBM terms of owned slot i
+    void setTerms(Shard& shard, size_t i, double drift, double volatility) {
+        constexpr double kTradingSecondsPerYear = 252.0 * 6.5 * 3600.0;
+        double dt = gbm_.tick_seconds / kTradingSecondsPerYear;
+        shard.owned_drift[i] = (drift - 0.5 * volatility * volatility) * dt;
+        shard.owned_vol[i] = volatility * std::sqrt(dt);
+    }
+    
+    void compactTerms(Shard& shard) {
+        if (model_ != PriceModel::Gbm) return;
+        for (size_t i = 0; i < shard.active.size(); ++i) {
+            shard.drift[i] = shard.owned_drift[shard.active[i]];
+            shard.vol[i] = shard.owned_vol[shard.active[i]];
+        }
+    }
+    
+    /**
+     * @brief Generate exactly the shard's listed symbols (the shard's thread,
+     *        or setup): park prices of the current ones, gather the new set
+     *
+     * listed is sorted, so the generated symbols keep ascending ID order.
+     */
+    void syncListed(Shard& shard, const std::vector<SymbolId>& listed) {
+        for (size_t i = 0; i < shard.active.size(); ++i) {
+            shard.owned_prices[shard.active[i]] = shard.current_prices[i];
+        }
+        shard.active.clear();
+        shard.symbols.clear();
+        shard.current_prices.clear();
+        for (SymbolId id : listed) {
+            if (id < shard_of_.size() && shard_of_[id] == shard.index) {
+                shard.active.push_back(slot_of_[id]);
+                shard.symbols.push_back(id);
+                shard.current_prices.push_back(shard.owned_prices[slot_of_[id]]);
+            }
+        }
+        compactTerms(shard);
+    }
+    
+    void run(Shard* shard) {
+        placeProducerThread(buffer_, shard->owned, "PriceGenerator shard " + std::to_string(shard->index));
+        std::cout << "[PriceGenerator] Producer loop starting (shard " << shard->index << ", "
+                  << (model_ == PriceModel::Gbm ? "GBM" : "random walk") << ", "
+                  << rng::activeIsa() << " batch RNG)...\n";
         
         size_t iteration = 0;
+        SymbolTable::Reader listed(buffer_.symbolTable());
+        syncListed(*shard, listed.symbols());
         
         while (running_.load()) {  // Check atomic flag
-            auto generation_start = std::chrono::high_resolution_clock::now();
+            if (listed.refresh()) {
+                syncListed(*shard, listed.symbols());   // Symbols listed or delisted
+            }
+            size_t n = shard->symbols.size();
+            auto generation_start = TickClock::now();
             
-            // Generate price updates for all symbols
-            for (size_t i = 0; i < symbols_.size(); ++i) {
-                // Generate random price change using normal distribution
-                double change = price_change_dist_(gen_);
-                current_prices_[i] += change;
-                
-                // Ensure price doesn't go negative
-                if (current_prices_[i] < 1.0) {
-                    current_prices_[i] = 1.0;
+            {
+                TRACE_SPAN("generate");
+                // Draw the whole iteration at once, then step every price
+                rng::fillNormal(shard->rng, shard->normals.data(), n);
+                rng::fillUniform(shard->rng, shard->uniforms.data(), n);
+                if (model_ == PriceModel::Gbm) {
+                    rng::gbmStep(shard->current_prices.data(), shard->normals.data(), shard->drift.data(),
+                                 shard->vol.data(), shard->changes.data(), n);
+                } else {
+                    rng::walkStep(shard->current_prices.data(), shard->normals.data(), kWalkStepStddev,
+                                  kWalkFloor, shard->changes.data(), n);
                 }
                 
-                // Create price data with high-resolution timestamp
-                PriceData data(symbols_[i], current_prices_[i], change);
-                
-                // Push to shared buffer (CRITICAL SECTION handled internally)
-                // This will acquire mutex, update buffer, release mutex, and notify consumers
-                buffer_.push(data);
-                
-                // Record performance metric
-                perf_monitor_.recordGeneration(symbols_[i], data.timestamp);
+                // Create price data; the whole iteration shares one timestamp
+                shard->batch.clear();
+                for (size_t i = 0; i < n; ++i) {
+                    double volume = 1.0 + static_cast<int>(shard->uniforms[i] * 1000.0);   // 1 to 1000 shares
+                    shard->batch.emplace_back(shard->symbols[i], shard->current_prices[i], shard->changes[i],
+                                              volume, generation_start);
+                }
             }
             
-            auto generation_end = std::chrono::high_resolution_clock::now();
+            // Publish the whole iteration at once: one critical section and
+            // one consumer wakeup instead of one per symbol.
+            // This shard is the only writer of these symbols' rings.
+            buffer_.pushBatch(shard->batch);
+            
+            // Record performance metrics
+            perf_monitor_.recordGenerationBatch(shard->batch);
+            
+            auto generation_end = TickClock::now();
             auto generation_time = std::chrono::duration_cast<std::chrono::microseconds>(
                 generation_end - generation_start).count();
             
@@ -106,15 +340,18 @@ private:
             
             // Log every 50 iterations to avoid cluttering console
             if (iteration % 50 == 0) {
-                std::cout << "[PriceGenerator] Iteration " << iteration 
+                std::cout << "[PriceGenerator] Shard " << shard->index << " iteration " << iteration
                           << " - Generation time: " << generation_time << " us\n";
             }
             
-            // Sleep to control update rate
-            std::this_thread::sleep_for(std::chrono::milliseconds(update_interval_ms_));
+            // Sleep to control update rate (an interval of 0 spins for maximum throughput)
+            if (update_interval_ms_ > 0) {
+                TRACE_SPAN("sleep");
+                std::this_thread::sleep_for(std::chrono::milliseconds(update_interval_ms_));
+            }
         }
         
-        std::cout << "[PriceGenerator] Producer loop exited after " 
+        std::cout << "[PriceGenerator] Producer loop (shard " << shard->index << ") exited after "
                   << iteration << " iterations\n";
     }
 };
@@ -0,0 +1,329 @@
+#ifndef PRICE_RING_H
+#define PRICE_RING_H
+
+#include "PriceData.h"
+#include "AlignedArray.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PriceRing;
+
+// One contiguous run of ticks in structure-of-arrays form.
+struct HistorySegment {
+    const double* prices = nullptr;
+    const double* changes = nullptr;
+    const double* volumes = nullptr;
+    const TickClock::rep* timestamps = nullptr;   // time_since_epoch().count()
+    size_t size = 0;
+};
+
+// Rebuild a PriceData from its SoA columns
+inline PriceData makeTick(SymbolId symbol, double price, double change, double volume,
+                          TickClock::rep timestamp) {
+    PriceData data;
+    data.symbol = symbol;
+    data.price = price;
+    data.change = change;
+    data.volume = volume;
+    data.timestamp = TickClock::time_point(TickClock::duration(timestamp));
+    return data;
+}
+
+// Read-only view over the newest ticks of one PriceRing, without copying.
+//
+// Ring storage wraps, so the ticks (oldest to newest) are split into at most
+// two contiguous segments: first then second. Each segment exposes the
+// price, change, volume and timestamp columns as plain arrays for vector kernels.
+// version is the ring sequence at the time the view was taken.
+//
+// The view points straight into ring memory the producer keeps writing to.
+// Iterate it, then call valid(): if it returns false the producer lapped
+// the viewed slots while they were being read and the results must be
+// discarded (take a new view and retry).
+struct HistoryView {
+    HistorySegment first;
+    HistorySegment second;
+    uint64_t version = 0;
+    SymbolId symbol = kInvalidSymbolId;
+    const PriceRing* ring = nullptr;
+    
+    size_t size() const { return first.size + second.size; }
+    bool empty() const { return size() == 0; }
+    
+    double price(size_t i) const {
+        return (i < first.size) ? first.prices[i] : second.prices[i - first.size];
+    }
+    
+    PriceData operator[](size_t i) const {
+        const HistorySegment& seg = (i < first.size) ? first : second;
+        size_t j = (i < first.size) ? i : i - first.size;
+        return makeTick(symbol, seg.prices[j], seg.changes[j], seg.volumes[j], seg.timestamps[j]);
+    }
+    
+    PriceData back() const { return (*this)[size() - 1]; }
+    
+    // Visit every tick, oldest to newest
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const HistorySegment* seg : {&first, &second}) {
+            for (size_t i = 0; i < seg->size; ++i) {
+                fn(makeTick(symbol, seg->prices[i], seg->changes[i], seg->volumes[i], seg->timestamps[i]));
+            }
+        }
+    }
+    
+    inline bool valid() const;
+};
+
+// Owned SoA copy of consecutive ticks for one symbol (see SharedBuffer::readSince).
+// The vectors keep their capacity across clear(), so a consumer that reuses
+// one batch stops allocating once it has seen its largest catch-up.
+struct TickBatch {
+    SymbolId symbol = kInvalidSymbolId;
+    std::vector<double> prices;
+    std::vector<double> changes;
+    std::vector<double> volumes;
+    std::vector<TickClock::rep> timestamps;
+    
+    size_t size() const { return prices.size(); }
+    bool empty() const { return prices.empty(); }
+    
+    void clear() {
+        prices.clear();
+        changes.clear();
+        volumes.clear();
+        timestamps.clear();
+    }
+    
+    void append(const HistorySegment& seg, size_t from, size_t count) {
+        prices.insert(prices.end(), seg.prices + from, seg.prices + from + count);
+        changes.insert(changes.end(), seg.changes + from, seg.changes + from + count);
+        volumes.insert(volumes.end(), seg.volumes + from, seg.volumes + from + count);
+        timestamps.insert(timestamps.end(), seg.timestamps + from, seg.timestamps + from + count);
+    }
+    
+    PriceData operator[](size_t i) const {
+        return makeTick(symbol, prices[i], changes[i], volumes[i], timestamps[i]);
+    }
+    
+    PriceData back() const { return (*this)[size() - 1]; }
+};
+
+// Fixed-capacity single-writer ring of ticks for one symbol.
+//
+// Storage is structure-of-arrays: prices, changes, volumes and timestamps
+// each live in their own cache-line-aligned column, so indicator kernels
+// stream over contiguous doubles instead of striding over whole ticks.
+// The four columns share one fixed block, normally a slice of the
+// SharedBuffer's TickArena, allocated once before the first tick.
+//
+// The producer publishes a tick by writing the next slot and then advancing
+// head_ (the symbol's sequence counter). Readers never take a lock: they
+// snapshot head_, read slots, and re-check head_ afterwards (seqlock-style).
+// If the writer lapped the slots they were reading, the read is retried.
+// The writer never waits for a reader.
+//
+// Storage holds at least twice the logical history so a reader looking at
+// the newest history_limit entries has a full history of slack before the
+// writer can reach the slots it is looking at.
+class PriceRing {
+private:
+    SymbolId symbol_;
+    size_t capacity_;                           // Power of two
+    size_t mask_;                               // capacity_ - 1
+    size_t history_limit_;                      // Logical history size (max_history_size_)
+    
+    AlignedArray<std::byte> owned_;             // Own storage when not given any
+    double* prices_;
+    double* changes_;
+    double* volumes_;
+    TickClock::rep* timestamps_;
+    
+    alignas(64) std::atomic<uint64_t> head_;    // Number of ticks ever published
+    
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+    
+    static size_t capacityFor(size_t history_limit) {
+        return roundUpPow2(2 * (history_limit > 0 ? history_limit : 1));
+    }
+    
+    // Bytes of one column, rounded up so every column starts on a cache line
+    static size_t columnBytes(size_t capacity) {
+        return (capacity * sizeof(double) + 63) & ~static_cast<size_t>(63);
+    }
+    
+    HistorySegment segment(size_t start, size_t n) const {
+        HistorySegment seg;
+        seg.prices = prices_ + start;
+        seg.changes = changes_ + start;
+        seg.volumes = volumes_ + start;
+        seg.timestamps = timestamps_ + start;
+        seg.size = n;
+        return seg;
+    }
+
+public:
+    /**
+     * @brief Bytes of column storage a ring with this history limit uses
+     */
+    static size_t storageBytes(size_t history_limit) {
+        return 4 * columnBytes(capacityFor(history_limit));
+    }
+    
+    /**
+     * @param storage storageBytes(history_limit) zeroed, 64-byte aligned bytes
+     *                that outlive the ring (e.g. a TickArena slice), or
+     *                nullptr to allocate them here
+     */
+    PriceRing(SymbolId symbol, size_t history_limit, std::byte* storage = nullptr)
+        : symbol_(symbol),
+          capacity_(capacityFor(history_limit)),
+          mask_(capacity_ - 1),
+          history_limit_(history_limit),
+          owned_(storage ? 0 : storageBytes(history_limit)),
+          head_(0) {
+        std::byte* base = storage ? storage : owned_.data();
+        size_t column = columnBytes(capacity_);
+        prices_ = reinterpret_cast<double*>(base);
+        changes_ = reinterpret_cast<double*>(base + column);
+        volumes_ = reinterpret_cast<double*>(base + 2 * column);
+        timestamps_ = reinterpret_cast<TickClock::rep*>(base + 3 * column);
+    }
+    
+    PriceRing(const PriceRing&) = delete;
+    PriceRing& operator=(const PriceRing&) = delete;
+    
+    /**
+     * @brief Producer: publish a new tick (single writer only, never blocks)
+     *
+     * The release fence orders the slot write after the previous head_ value,
+     * so a reader that observes any part of this write also observes that the
+     * writer has moved on and discards its copy.
+     */
+    void publish(const PriceData& data) {
+        uint64_t seq = head_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        size_t slot = static_cast<size_t>(seq & mask_);
+        prices_[slot] = data.price;
+        changes_[slot] = data.change;
+        volumes_[slot] = data.volume;
+        timestamps_[slot] = data.timestamp.time_since_epoch().count();
+        
+        head_.store(seq + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Refill a ring nothing has been published to yet (e.g. from a checkpoint)
+     *
+     * The n ticks (oldest to newest) become the newest entries and the
+     * sequence continues from sequence, so cursors saved alongside them
+     * still line up. At most history_limit ticks are kept. Call before the
+     * producer and any reader start.
+     */
+    void restore(uint64_t sequence, const double* prices, const double* changes,
+                 const double* volumes, const TickClock::rep* timestamps, size_t n) {
+        if (n > sequence) n = static_cast<size_t>(sequence);
+        size_t skip = (n > history_limit_) ? n - history_limit_ : 0;
+        for (size_t i = skip; i < n; ++i) {
+            size_t slot = static_cast<size_t>((sequence - n + i) & mask_);
+            prices_[slot] = prices[i];
+            changes_[slot] = changes[i];
+            volumes_[slot] = volumes[i];
+            timestamps_[slot] = timestamps[i];
+        }
+        head_.store(sequence, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Number of ticks published so far (acquire)
+     */
+    uint64_t sequence() const {
+        return head_.load(std::memory_order_acquire);
+    }
+    
+    SymbolId symbol() const { return symbol_; }
+    size_t historyLimit() const { return history_limit_; }
+    
+    /**
+     * @brief Consumer: view up to count most recent ticks (oldest to newest)
+     *
+     * Never covers more than history_limit entries, matching the behavior
+     * of the deque-backed history. Check HistoryView::valid() after use.
+     */
+    HistoryView view(size_t count) const {
+        if (count > history_limit_) count = history_limit_;
+        
+        HistoryView v;
+        v.ring = this;
+        v.symbol = symbol_;
+        v.version = head_.load(std::memory_order_acquire);
+        
+        size_t n = (v.version < count) ? static_cast<size_t>(v.version) : count;
+        if (n == 0) return v;
+        
+        size_t start = static_cast<size_t>((v.version - n) & mask_);
+        size_t until_wrap = capacity_ - start;
+        size_t first_size = (n < until_wrap) ? n : until_wrap;
+        
+        v.first = segment(start, first_size);
+        v.second = segment(0, n - first_size);
+        return v;
+    }
+    
+    /**
+     * @brief True if none of the view's slots was overwritten since it was taken
+     *
+     * The writer is at most writing slot index head_ right now; that slot
+     * aliases one of the viewed ones only once it is a full capacity past
+     * the oldest viewed tick.
+     */
+    bool intact(const HistoryView& v) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t writer = head_.load(std::memory_order_relaxed);
+        uint64_t oldest = v.version - v.size();
+        return writer < oldest + capacity_;
+    }
+    
+    /**
+     * @brief Consumer: copy the most recent tick
+     * @param sequence Optional output: the sequence number out was published as
+     * @return false if nothing has been published yet
+     */
+    bool readLatest(PriceData& out, uint64_t* sequence = nullptr) const {
+        for (;;) {
+            HistoryView v = view(1);
+            if (v.empty()) return false;
+            out = v.back();
+            if (intact(v)) {
+                if (sequence) *sequence = v.version;
+                return true;
+            }
+        }
+    }
+    
+    /**
+     * @brief Consumer: copy up to count most recent ticks (oldest to newest)
+     * @return Number of ticks copied into out
+     */
+    size_t readRecent(size_t count, std::vector<PriceData>& out) const {
+        for (;;) {
+            HistoryView v = view(count);
+            out.clear();
+            v.forEach([&out](const PriceData& data) { out.push_back(data); });
+            if (intact(v)) return out.size();
+        }
+    }
+};
+
+inline bool HistoryView::valid() const {
+    return ring == nullptr || ring->intact(*this);
+}
+
+#endif // PRICE_RING_H
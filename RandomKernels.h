@@ -0,0 +1,379 @@
+#ifndef RANDOM_KERNELS_H
+#define RANDOM_KERNELS_H
+
+#include "SimdKernels.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+// Batch random numbers and price steps for PriceGenerator.
+//
+// The generator is xoshiro256+ run as four independent lanes (a LaneState
+// holds each of the four state words for all lanes side by side), so one
+// step yields four 64-bit outputs and maps directly onto AVX2 registers.
+// Normals come from the Box-Muller transform: two uniforms give two
+// normals, computed four lanes at a time with polynomial log and sin/cos.
+//
+// Like SimdKernels.h, the implementation is picked once at first use:
+// AVX2 on x86 CPUs that support it, otherwise a portable scalar loop over
+// the same lanes. Both produce the same uniforms; normals differ only in
+// the last bits (the scalar path uses std::log / std::cos).
+namespace rng {
+
+constexpr size_t kLanes = 4;
+
+struct alignas(32) LaneState {
+    uint64_t s[4][kLanes];      // s[word][lane]
+};
+
+inline uint64_t splitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Seed all lanes from one value (splitmix64, as the xoshiro authors recommend)
+inline void seed(LaneState& state, uint64_t value) {
+    for (auto& word : state.s) {
+        for (auto& lane : word) lane = splitMix64(value);
+    }
+}
+
+// ------------------------------------------------------------
+// Scalar fallback
+// ------------------------------------------------------------
+
+inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// One xoshiro256+ step of every lane
+inline void nextScalar(LaneState& st, uint64_t out[kLanes]) {
+    for (size_t l = 0; l < kLanes; ++l) {
+        out[l] = st.s[0][l] + st.s[3][l];
+        uint64_t t = st.s[1][l] << 17;
+        st.s[2][l] ^= st.s[0][l];
+        st.s[3][l] ^= st.s[1][l];
+        st.s[1][l] ^= st.s[2][l];
+        st.s[0][l] ^= st.s[3][l];
+        st.s[2][l] ^= t;
+        st.s[3][l] = rotl(st.s[3][l], 45);
+    }
+}
+
+// Top 52 bits as a double in [1, 2), minus one: [0, 1)
+inline double toUnit(uint64_t x) {
+    uint64_t bits = (x >> 12) | 0x3FF0000000000000ull;
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+inline void fillUniformScalar(LaneState& st, double* out, size_t n) {
+    uint64_t r[kLanes];
+    for (size_t i = 0; i < n; i += kLanes) {
+        nextScalar(st, r);
+        for (size_t l = 0; l < kLanes && i + l < n; ++l) out[i + l] = toUnit(r[l]);
+    }
+}
+
+inline void fillNormalScalar(LaneState& st, double* out, size_t n) {
+    constexpr double kTwoPi = 6.283185307179586476925286766559;
+    uint64_t r1[kLanes], r2[kLanes];
+    double z[2 * kLanes];
+    for (size_t i = 0; i < n; i += 2 * kLanes) {
+        nextScalar(st, r1);
+        nextScalar(st, r2);
+        for (size_t l = 0; l < kLanes; ++l) {
+            double radius = std::sqrt(-2.0 * std::log(1.0 - toUnit(r1[l])));    // 1 - u is in (0, 1]
+            double theta = kTwoPi * toUnit(r2[l]);
+            z[l] = radius * std::cos(theta);
+            z[l + kLanes] = radius * std::sin(theta);
+        }
+        size_t count = n - i < 2 * kLanes ? n - i : 2 * kLanes;
+        std::memcpy(out + i, z, count * sizeof(double));
+    }
+}
+
+// Arithmetic random walk: change = stddev * z, price floored at floor
+inline void walkStepScalar(double* prices, const double* normals, double stddev, double floor,
+                           double* changes, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double change = stddev * normals[i];
+        double price = prices[i] + change;
+        prices[i] = price < floor ? floor : price;
+        changes[i] = change;
+    }
+}
+
+// Geometric Brownian motion: price *= exp(drift + vol * z) with per-symbol
+// drift ((mu - sigma^2 / 2) dt) and vol (sigma sqrt(dt)); change = new - old
+inline void gbmStepScalar(double* prices, const double* normals, const double* drift, const double* vol,
+                          double* changes, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double price = prices[i] * std::exp(drift[i] + vol[i] * normals[i]);
+        changes[i] = price - prices[i];
+        prices[i] = price;
+    }
+}
+
+// ------------------------------------------------------------
+// AVX2 (x86, selected at runtime)
+// ------------------------------------------------------------
+
+#if defined(SIMD_KERNELS_X86)
+
+struct Avx2State {
+    __m256i s0, s1, s2, s3;
+};
+
+__attribute__((target("avx2")))
+inline Avx2State loadState(const LaneState& st) {
+    return {_mm256_load_si256(reinterpret_cast<const __m256i*>(st.s[0])),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(st.s[1])),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(st.s[2])),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(st.s[3]))};
+}
+
+__attribute__((target("avx2")))
+inline void storeState(LaneState& st, const Avx2State& v) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(st.s[0]), v.s0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(st.s[1]), v.s1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(st.s[2]), v.s2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(st.s[3]), v.s3);
+}
+
+__attribute__((target("avx2")))
+inline __m256i nextAvx2(Avx2State& v) {
+    __m256i result = _mm256_add_epi64(v.s0, v.s3);
+    __m256i t = _mm256_slli_epi64(v.s1, 17);
+    v.s2 = _mm256_xor_si256(v.s2, v.s0);
+    v.s3 = _mm256_xor_si256(v.s3, v.s1);
+    v.s1 = _mm256_xor_si256(v.s1, v.s2);
+    v.s0 = _mm256_xor_si256(v.s0, v.s3);
+    v.s2 = _mm256_xor_si256(v.s2, t);
+    v.s3 = _mm256_or_si256(_mm256_slli_epi64(v.s3, 45), _mm256_srli_epi64(v.s3, 19));
+    return result;
+}
+
+__attribute__((target("avx2")))
+inline __m256d toUnitAvx2(__m256i x) {
+    __m256i bits = _mm256_or_si256(_mm256_srli_epi64(x, 12), _mm256_set1_epi64x(0x3FF0000000000000ll));
+    return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+// Natural log of x in (0, 1] (positive, normal): x = m * 2^e with m in
+// [sqrt(1/2), sqrt(2)), log(m) = 2 atanh((m - 1) / (m + 1)) as a series
+__attribute__((target("avx2")))
+inline __m256d logAvx2(__m256d x) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256i bits = _mm256_castpd_si256(x);
+    
+    // Biased exponent as a double: plant it in the mantissa of 2^52
+    __m256i biased = _mm256_srli_epi64(bits, 52);
+    __m256d e = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(biased, _mm256_set1_epi64x(0x4330000000000000ll))),
+        _mm256_set1_pd(4503599627370496.0 + 1023.0));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)), _mm256_set1_epi64x(0x3FF0000000000000ll)));
+    
+    __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(1.4142135623730951), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, one));
+    
+    __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    __m256d z = _mm256_mul_pd(s, s);
+    // 1 + z/3 + z^2/5 + ... + z^10/21 (|s| < 0.172, so the next term is below 1e-17)
+    __m256d p = _mm256_set1_pd(1.0 / 21.0);
+    for (double k : {19.0, 17.0, 15.0, 13.0, 11.0, 9.0, 7.0, 5.0, 3.0, 1.0}) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1.0 / k));
+    }
+    __m256d log_m = _mm256_mul_pd(_mm256_add_pd(s, s), p);
+    
+    const __m256d ln2_hi = _mm256_set1_pd(6.93147180369123816490e-01);
+    const __m256d ln2_lo = _mm256_set1_pd(1.90821492927058770002e-10);
+    return _mm256_add_pd(_mm256_mul_pd(e, ln2_hi), _mm256_add_pd(log_m, _mm256_mul_pd(e, ln2_lo)));
+}
+
+// cos and sin of 2 pi u for u in [0, 1): reduce to a quarter turn q plus
+// an angle in [-pi/4, pi/4], evaluate both Taylor series there, and rotate
+__attribute__((target("avx2")))
+inline void sinCosTurnsAvx2(__m256d u, __m256d& cos_out, __m256d& sin_out) {
+    __m256d t = _mm256_mul_pd(u, _mm256_set1_pd(4.0));
+    __m256d q = _mm256_round_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d a = _mm256_mul_pd(_mm256_sub_pd(t, q), _mm256_set1_pd(1.5707963267948966192));
+    __m256d a2 = _mm256_mul_pd(a, a);
+    
+    // sin a = a (1 - a^2/3! + ... + a^16/17!), cos a = 1 - a^2/2! + ... + a^16/16!
+    __m256d sp = _mm256_set1_pd(1.0 / 355687428096000.0);
+    for (double f : {-1.0 / 1307674368000.0, 1.0 / 6227020800.0, -1.0 / 39916800.0, 1.0 / 362880.0,
+                     -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0}) {
+        sp = _mm256_add_pd(_mm256_mul_pd(sp, a2), _mm256_set1_pd(f));
+    }
+    __m256d sin_a = _mm256_mul_pd(sp, a);
+    __m256d cp = _mm256_set1_pd(1.0 / 20922789888000.0);
+    for (double f : {-1.0 / 87178291200.0, 1.0 / 479001600.0, -1.0 / 3628800.0, 1.0 / 40320.0,
+                     -1.0 / 720.0, 1.0 / 24.0, -1.0 / 2.0, 1.0}) {
+        cp = _mm256_add_pd(_mm256_mul_pd(cp, a2), _mm256_set1_pd(f));
+    }
+    __m256d cos_a = cp;
+    
+    // Quarter turns q mod 4: 0 (c, s), 1 (-s, c), 2 (-c, -s), 3 (s, -c)
+    __m256i quarter = _mm256_cvtepi32_epi64(_mm_and_si128(_mm256_cvtpd_epi32(q), _mm_set1_epi32(3)));
+    __m256i bit0 = _mm256_and_si256(quarter, _mm256_set1_epi64x(1));
+    __m256i bit1 = _mm256_srli_epi64(quarter, 1);
+    __m256d odd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(bit0, _mm256_set1_epi64x(1)));
+    __m256d c = _mm256_blendv_pd(cos_a, sin_a, odd);
+    __m256d s = _mm256_blendv_pd(sin_a, cos_a, odd);
+    cos_out = _mm256_xor_pd(c, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_xor_si256(bit0, bit1), 63)));
+    sin_out = _mm256_xor_pd(s, _mm256_castsi256_pd(_mm256_slli_epi64(bit1, 63)));
+}
+
+// e^x for |x| < 700: x = k ln2 + r with |r| <= ln2/2, e^r as a Taylor series
+__attribute__((target("avx2")))
+inline __m256d expAvx2(__m256d x) {
+    x = _mm256_max_pd(_mm256_min_pd(x, _mm256_set1_pd(700.0)), _mm256_set1_pd(-700.0));
+    __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634074)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(6.93147180369123816490e-01)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(1.90821492927058770002e-10)));
+    
+    __m256d p = _mm256_set1_pd(1.0 / 6227020800.0);     // 1/13!
+    for (double f : {1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0,
+                     1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0}) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(f));
+    }
+    
+    // 2^k: k + 1023 into the exponent field
+    __m256i exponent = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k)), _mm256_set1_epi64x(1023));
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52)));
+}
+
+__attribute__((target("avx2")))
+inline void fillUniformAvx2(LaneState& st, double* out, size_t n) {
+    Avx2State v = loadState(st);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        _mm256_storeu_pd(out + i, toUnitAvx2(nextAvx2(v)));
+    }
+    if (i < n) {
+        alignas(32) double tail[kLanes];
+        _mm256_store_pd(tail, toUnitAvx2(nextAvx2(v)));
+        std::memcpy(out + i, tail, (n - i) * sizeof(double));
+    }
+    storeState(st, v);
+}
+
+__attribute__((target("avx2")))
+inline void fillNormalAvx2(LaneState& st, double* out, size_t n) {
+    Avx2State v = loadState(st);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d minus_two = _mm256_set1_pd(-2.0);
+    for (size_t i = 0; i < n; i += 2 * kLanes) {
+        __m256d u1 = _mm256_sub_pd(one, toUnitAvx2(nextAvx2(v)));   // (0, 1]
+        __m256d u2 = toUnitAvx2(nextAvx2(v));
+        __m256d radius = _mm256_sqrt_pd(_mm256_mul_pd(minus_two, logAvx2(u1)));
+        __m256d c, s;
+        sinCosTurnsAvx2(u2, c, s);
+        __m256d z0 = _mm256_mul_pd(radius, c);
+        __m256d z1 = _mm256_mul_pd(radius, s);
+        if (i + 2 * kLanes <= n) {
+            _mm256_storeu_pd(out + i, z0);
+            _mm256_storeu_pd(out + i + kLanes, z1);
+        } else {
+            alignas(32) double tail[2 * kLanes];
+            _mm256_store_pd(tail, z0);
+            _mm256_store_pd(tail + kLanes, z1);
+            std::memcpy(out + i, tail, (n - i) * sizeof(double));
+        }
+    }
+    storeState(st, v);
+}
+
+__attribute__((target("avx2")))
+inline void walkStepAvx2(double* prices, const double* normals, double stddev, double floor,
+                         double* changes, size_t n) {
+    const __m256d sd = _mm256_set1_pd(stddev);
+    const __m256d lo = _mm256_set1_pd(floor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d change = _mm256_mul_pd(sd, _mm256_loadu_pd(normals + i));
+        __m256d price = _mm256_max_pd(_mm256_add_pd(_mm256_loadu_pd(prices + i), change), lo);
+        _mm256_storeu_pd(prices + i, price);
+        _mm256_storeu_pd(changes + i, change);
+    }
+    walkStepScalar(prices + i, normals + i, stddev, floor, changes + i, n - i);
+}
+
+__attribute__((target("avx2")))
+inline void gbmStepAvx2(double* prices, const double* normals, const double* drift, const double* vol,
+                        double* changes, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d exponent = _mm256_add_pd(_mm256_loadu_pd(drift + i),
+                                         _mm256_mul_pd(_mm256_loadu_pd(vol + i), _mm256_loadu_pd(normals + i)));
+        __m256d old_price = _mm256_loadu_pd(prices + i);
+        __m256d price = _mm256_mul_pd(old_price, expAvx2(exponent));
+        _mm256_storeu_pd(prices + i, price);
+        _mm256_storeu_pd(changes + i, _mm256_sub_pd(price, old_price));
+    }
+    gbmStepScalar(prices + i, normals + i, drift + i, vol + i, changes + i, n - i);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// ------------------------------------------------------------
+// Runtime dispatch
+// ------------------------------------------------------------
+
+struct RandomKernelTable {
+    const char* isa;
+    void (*fillUniform)(LaneState&, double*, size_t);
+    void (*fillNormal)(LaneState&, double*, size_t);
+    void (*walkStep)(double*, const double*, double, double, double*, size_t);
+    void (*gbmStep)(double*, const double*, const double*, const double*, double*, size_t);
+};
+
+inline RandomKernelTable selectKernels() {
+#if defined(SIMD_KERNELS_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", fillUniformAvx2, fillNormalAvx2, walkStepAvx2, gbmStepAvx2};
+    }
+#endif
+    return {"scalar", fillUniformScalar, fillNormalScalar, walkStepScalar, gbmStepScalar};
+}
+
+inline const RandomKernelTable& kernels() {
+    static const RandomKernelTable table = selectKernels();
+    return table;
+}
+
+// Name of the selected implementation ("avx2" or "scalar")
+inline const char* activeIsa() { return kernels().isa; }
+
+// out[0..n) = uniform doubles in [0, 1)
+inline void fillUniform(LaneState& state, double* out, size_t n) {
+    kernels().fillUniform(state, out, n);
+}
+
+// out[0..n) = standard normal samples
+inline void fillNormal(LaneState& state, double* out, size_t n) {
+    kernels().fillNormal(state, out, n);
+}
+
+// See walkStepScalar()
+inline void walkStep(double* prices, const double* normals, double stddev, double floor,
+                     double* changes, size_t n) {
+    kernels().walkStep(prices, normals, stddev, floor, changes, n);
+}
+
+// See gbmStepScalar()
+inline void gbmStep(double* prices, const double* normals, const double* drift, const double* vol,
+                    double* changes, size_t n) {
+    kernels().gbmStep(prices, normals, drift, vol, changes, n);
+}
+
+} // namespace rng
+
+#endif // RANDOM_KERNELS_H
@@ -0,0 +1,226 @@
+#ifndef ROLLING_WINDOW_H
+#define ROLLING_WINDOW_H
+
+#include "SimdKernels.h"
+#include "CheckpointStream.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size sliding window of samples with O(1) mean and variance.
+//
+// Each push() adds the new sample and evicts the oldest one once the window
+// is full, updating:
+// - a Kahan-compensated running sum (mean / SMA), and
+// - a Welford-style sum of squared deviations (variance), using the
+//   add/replace form so no pass over the window is needed.
+//
+// Both accumulators are recomputed exactly from the stored samples (with the
+// SIMD kernels) once per window's worth of evictions, which bounds
+// floating-point drift on long runs while keeping the amortized cost per
+// push O(1). pushBatch() rebuilds the window the same way when a batch is
+// at least a whole window long.
+//
+// N fixes the capacity at compile time (BasicRollingWindow<20>): the ring is
+// a std::array stored inline, wrap-around and eviction compare against a
+// constant, and the resync loops have a known trip count, so the compiler
+// unrolls and vectorizes them. N = kRuntimeWindow (RollingWindow) takes the
+// capacity at run time instead, for any other window size. Both behave the
+// same and checkpoint to the same format.
+constexpr size_t kRuntimeWindow = 0;
+
+template <size_t N>
+class BasicRollingWindow {
+private:
+    using Storage = std::conditional_t<N == kRuntimeWindow, std::vector<double>, std::array<double, N>>;
+    
+    Storage values_;                // Ring of the last capacity samples
+    size_t count_;                  // Samples currently in the window
+    size_t next_;                   // Slot the next sample goes into
+    
+    double sum_;                    // Kahan running sum
+    double compensation_;           // Kahan low-order bits
+    double mean_;                   // Welford mean
+    double m2_;                     // Sum of squared deviations from mean_
+    
+    size_t evictions_since_resync_;
+    
+    void kahanAdd(double x) {
+        double y = x - compensation_;
+        double t = sum_ + y;
+        compensation_ = (t - sum_) - y;
+        sum_ = t;
+    }
+    
+    // Order of samples does not matter for the sums, so the stored ring
+    // can be reduced as one contiguous array.
+    void resync() {
+        if constexpr (N != kRuntimeWindow) {
+            if (count_ == N) {
+                sum_ = simd::sumFixed<N>(values_.data());
+                compensation_ = 0.0;
+                mean_ = sum_ / N;
+                m2_ = simd::sumSquaredDeviationsFixed<N>(values_.data(), mean_);
+                evictions_since_resync_ = 0;
+                return;
+            }
+        }
+        sum_ = simd::sum(values_.data(), count_);
+        compensation_ = 0.0;
+        mean_ = sum_ / count_;
+        m2_ = simd::sumSquaredDeviations(values_.data(), count_, mean_);
+        evictions_since_resync_ = 0;
+    }
+    
+    static Storage makeStorage(size_t capacity) {
+        if constexpr (N == kRuntimeWindow) {
+            return Storage(capacity > 0 ? capacity : 1);
+        } else {
+            (void)capacity;
+            return Storage{};
+        }
+    }
+
+public:
+    // capacity is ignored when N fixes it
+    explicit BasicRollingWindow(size_t capacity = N != kRuntimeWindow ? N : 20)
+        : values_(makeStorage(capacity)), count_(0), next_(0),
+          sum_(0.0), compensation_(0.0), mean_(0.0), m2_(0.0),
+          evictions_since_resync_(0) {}
+    
+    /**
+     * @brief Add a sample, evicting the oldest one if the window is full
+     */
+    void push(double x) {
+        if (count_ < capacity()) {
+            // Growing: plain Welford update
+            values_[next_] = x;
+            ++count_;
+            kahanAdd(x);
+            double delta = x - mean_;
+            mean_ += delta / count_;
+            m2_ += delta * (x - mean_);
+        } else {
+            // Full: replace the oldest sample
+            double old = values_[next_];
+            values_[next_] = x;
+            kahanAdd(x);
+            kahanAdd(-old);
+            double delta = x - old;
+            double old_mean = mean_;
+            mean_ += delta / capacity();
+            m2_ += delta * (x - mean_ + old - old_mean);
+            if (m2_ < 0.0) m2_ = 0.0;
+            
+            if (++evictions_since_resync_ >= capacity()) {
+                ++next_;
+                if (next_ == capacity()) next_ = 0;
+                resync();
+                return;
+            }
+        }
+        
+        ++next_;
+        if (next_ == capacity()) next_ = 0;
+    }
+    
+    /**
+     * @brief Add n samples (oldest first)
+     *
+     * A batch covering the whole window replaces it outright and is reduced
+     * with the vector kernels instead of n incremental updates.
+     */
+    void pushBatch(const double* xs, size_t n) {
+        if (n < capacity()) {
+            for (size_t i = 0; i < n; ++i) push(xs[i]);
+            return;
+        }
+        
+        const double* tail = xs + (n - capacity());
+        for (size_t i = 0; i < capacity(); ++i) values_[i] = tail[i];
+        count_ = capacity();
+        next_ = 0;
+        resync();
+    }
+    
+    void clear() {
+        count_ = next_ = 0;
+        sum_ = compensation_ = mean_ = m2_ = 0.0;
+        evictions_since_resync_ = 0;
+    }
+    
+    /**
+     * @brief Serialize the window (samples and accumulators) for a checkpoint
+     */
+    void save(CheckpointWriter& out) const {
+        out.put(static_cast<uint64_t>(capacity()));
+        out.put(static_cast<uint64_t>(count_));
+        out.put(static_cast<uint64_t>(next_));
+        out.put(static_cast<uint64_t>(evictions_since_resync_));
+        out.put(sum_);
+        out.put(compensation_);
+        out.put(mean_);
+        out.put(m2_);
+        out.putArray(values_.data(), values_.size());
+    }
+    
+    /**
+     * @brief Restore a window written by save()
+     * @return false (window unchanged) if the data is truncated or was saved
+     *         with a different capacity
+     */
+    bool load(CheckpointReader& in) {
+        uint64_t capacity = 0, count = 0, next = 0, evictions = 0;
+        double sum = 0.0, compensation = 0.0, mean = 0.0, m2 = 0.0;
+        in.get(capacity);
+        in.get(count);
+        in.get(next);
+        in.get(evictions);
+        in.get(sum);
+        in.get(compensation);
+        in.get(mean);
+        in.get(m2);
+        if (!in.ok() || capacity != this->capacity() || count > capacity || next >= capacity) {
+            return false;
+        }
+        if (!in.getArray(values_.data(), values_.size())) return false;
+        count_ = static_cast<size_t>(count);
+        next_ = static_cast<size_t>(next);
+        evictions_since_resync_ = static_cast<size_t>(evictions);
+        sum_ = sum;
+        compensation_ = compensation;
+        mean_ = mean;
+        m2_ = m2;
+        return true;
+    }
+    
+    size_t size() const { return count_; }
+    
+    size_t capacity() const {
+        if constexpr (N != kRuntimeWindow) {
+            return N;
+        } else {
+            return values_.size();
+        }
+    }
+    
+    bool full() const { return count_ == capacity(); }
+    
+    double sum() const { return sum_; }
+    
+    // Simple moving average over the samples in the window
+    double mean() const { return count_ ? sum_ / count_ : 0.0; }
+    
+    // Population variance (divides by N, like the original calculators)
+    double variance() const { return count_ ? m2_ / count_ : 0.0; }
+};
+
+// Capacity chosen at run time (any window size)
+using RollingWindow = BasicRollingWindow<kRuntimeWindow>;
+
+// Capacity fixed at compile time: SMA<N> is mean(), RollingVariance<N> variance()
+template <size_t N>
+using FixedRollingWindow = BasicRollingWindow<N>;
+
+#endif // ROLLING_WINDOW_H
@@ -4,6 +4,10 @@
 #include "PriceData.h"
 #include "SharedBuffer.h"
 #include "PerformanceMonitor.h"
+#include "RollingWindow.h"
+#include "IndicatorTask.h"
+#include "CacheLine.h"
+#include "ThreadPlacement.h"
 #include <thread>
 #include <atomic>
 #include <iostream>
@@ -11,23 +15,58 @@
 #include <iomanip>
 
 // Background thread that keeps a rolling SMA per symbol.
-class SMACalculator {
+//
+// Each symbol's window is updated incrementally from the ticks published
+// since the last pass, so reading the SMA is O(1) regardless of window size
+// (and the window may be longer than the buffer's history).
+//
+// Runs either on its own thread (start()) or as per-symbol tasks on an
+// IndicatorScheduler.
+class SMACalculator : public IndicatorTask {
 private:
+    // Streaming state for one symbol, on its own cache line(s): executor
+    // workers update neighbouring symbols at the same time
+    struct alignas(kCacheLineSize) SymbolState {
+        uint64_t cursor;            // Buffer sequence consumed so far
+        RollingWindow window;       // Last window_size_ prices
+        PriceData latest;           // Most recent tick folded in
+        
+        explicit SymbolState(size_t window_size) : cursor(0), window(window_size) {}
+    };
+    
     SharedBuffer& buffer_;                  // Reference to shared buffer
     PerformanceMonitor& perf_monitor_;     // Performance tracking
     std::atomic<bool> running_;             // Thread-safe shutdown flag
     std::thread thread_;                    // Worker thread
     
-    int calculation_interval_ms_;           // Time between calculations
+    int calculation_interval_ms_;           // Time between calculations (Poll) / wait timeout (Notify)
     size_t window_size_;                    // SMA window size (e.g., 20 periods)
+    ConsumerWakeMode wake_mode_;            // Fixed-interval polling or epoch notification
+    BarResolution resolution_;              // Ticks, or closed bars of one size
+    std::string name_;                      // "SMA", or e.g. "SMA 1m" on bars
+    
+    std::vector<SymbolState> states_;       // Indexed by symbol ID
+    OperationId operation_id_;              // "SMA" in the performance report
+    IndicatorSink* sink_ = nullptr;         // Binary output (attachOutput), if any
+    uint16_t output_id_ = 0;
+    ConsumerId consumer_;                   // Cursor (and overload policy) in the buffer
+    
+    alignas(kCacheLineSize) std::atomic<size_t> calculation_count_;   // Bumped by every worker
 
 public:
     SMACalculator(SharedBuffer& buffer, 
                   PerformanceMonitor& perf_monitor,
                   size_t window_size = 20,
-                  int calculation_interval_ms = 1000)
+                  int calculation_interval_ms = 1000,
+                  ConsumerWakeMode wake_mode = ConsumerWakeMode::Poll,
+                  BarResolution resolution = BarResolution::Tick)
         : buffer_(buffer), perf_monitor_(perf_monitor), running_(false),
-          calculation_interval_ms_(calculation_interval_ms), window_size_(window_size) {}
+          calculation_interval_ms_(calculation_interval_ms), window_size_(window_size),
+          wake_mode_(wake_mode), resolution_(resolution), name_(indicatorName("SMA", resolution)),
+          states_(buffer.registry().capacity(), SymbolState(window_size)),
+          operation_id_(perf_monitor.registerOperation(name_)),
+          consumer_(buffer.registerConsumer(name_, resolution)),
+          calculation_count_(0) {}
     
     void start() {
         bool expected = false;
@@ -47,83 +86,174 @@ public:
         }
     }
     
-    ~SMACalculator() {
+    ~SMACalculator() override {
         stop();
     }
+    
+    const char* name() const override { return name_.c_str(); }
+    
+    ConsumerId consumerId() const override { return consumer_; }
+    
+    void attachOutput(IndicatorSink& sink) override {
+        output_id_ = sink.registerIndicator(name_);
+        sink_ = &sink;
+    }
+    
+    bool hasNewData(SymbolId symbol) const override {
+        return buffer_.sequence(symbol, resolution_) != states_[symbol].cursor;
+    }
+    
+    /**
+     * @brief Fold new ticks for one symbol into its window and report the SMA
+     * @return false if the symbol does not have enough data yet
+     *
+     * Safe to call concurrently for different symbols (see IndicatorTask).
+     */
+    bool calculateSymbol(SymbolId symbol) override {
+        // Per-thread scratch: executor workers may run different symbols at once
+        thread_local TickBatch new_ticks;
+        
+        // Fold ticks published since the last pass into the window
+        SymbolState& state = states_[symbol];
+        state.cursor = buffer_.consume(consumer_, symbol, state.cursor, new_ticks);
+        {
+            TRACE_SPAN("compute");
+            state.window.pushBatch(new_ticks.prices.data(), new_ticks.size());
+            if (!new_ticks.empty()) {
+                state.latest = new_ticks.back();
+            }
+        }
+        
+        if (state.window.size() < 2) {
+            return false;  // Not enough data yet
+        }
+        
+        // Simple Moving Average: O(1) read of the running sum
+        double sma = state.window.mean();
+        
+        // Get latest price for comparison
+        double latest_price = state.latest.price;
+        double deviation = ((latest_price - sma) / sma) * 100.0;
+        
+        // Record performance: latency from generation to calculation
+        auto generation_time = state.latest.timestamp;
+        auto processing_time = TickClock::now();
+        perf_monitor_.recordProcessing(symbol, operation_id_, generation_time, processing_time);
+        
+        if (sink_) {
+            sink_->emit(symbol, output_id_, sma, latest_price, generation_time, processing_time, state.cursor);
+        }
+        
+        size_t count = ++calculation_count_;
+        
+        // Log a sample of the results
+        if (logSample(count)) {
+            std::cout << "\n[SMACalculator] " << buffer_.registry().name(symbol) 
+                      << " - Price: $" << std::fixed << std::setprecision(2) << latest_price
+                      << " | SMA(" << state.window.size() << "): $" << sma
+                      << " | Deviation: " << std::showpos << deviation << "%" << std::noshowpos;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Checkpoint: window size, then per symbol the cursor, latest tick and window
+     */
+    void saveState(CheckpointWriter& out) const override {
+        out.put(static_cast<uint32_t>(states_.size()));
+        out.put(static_cast<uint64_t>(window_size_));
+        for (const SymbolState& state : states_) {
+            out.put(state.cursor);
+            out.put(state.latest);
+            state.window.save(out);
+        }
+    }
+    
+    /**
+     * @brief Restore saveState() output; needs the same symbols and window size
+     */
+    bool loadState(CheckpointReader& in, TickClock::duration clock_shift) override {
+        uint32_t symbols = 0;
+        uint64_t window = 0;
+        if (!in.get(symbols) || !in.get(window) ||
+            symbols != states_.size() || window != window_size_) {
+            return false;
+        }
+        for (SymbolState& state : states_) {
+            if (!(in.get(state.cursor) && in.get(state.latest) && state.window.load(in))) {
+                states_.assign(states_.size(), SymbolState(window_size_));
+                return false;
+            }
+            state.latest.timestamp += clock_shift;
+            if (resolution_ != BarResolution::Tick) state.cursor = 0;   // Bars are not checkpointed
+        }
+        for (size_t id = 0; id < states_.size(); ++id) {
+            buffer_.restoreCursor(consumer_, static_cast<SymbolId>(id), states_[id].cursor);
+        }
+        return true;
+    }
 
 private:
     void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "SMACalculator");
         std::cout << "[SMACalculator] SMA calculation loop starting...\n";
         
-        size_t calculation_count = 0;
+        const bool notify = (wake_mode_ == ConsumerWakeMode::Notify);
+        uint64_t seen_epoch = 0;
+        SymbolTable::Reader listed(buffer_.symbolTable());     // Listed symbols, read in place
         
         while (running_.load()) {
-            // Wait for new data with condition variable
-            buffer_.waitForData(calculation_interval_ms_);
-            
-            if (!running_.load()) break;
+            if (notify) {
+                // Sleep until a tick newer than the last pass is pushed
+                uint64_t epoch = buffer_.waitForUpdate(seen_epoch, calculation_interval_ms_);
+                if (!running_.load()) break;
+                if (epoch == seen_epoch) continue;  // Timed out, nothing new
+                seen_epoch = epoch;
+            } else {
+                // Wait for new data with condition variable
+                buffer_.waitForData(calculation_interval_ms_);
+                if (!running_.load()) break;
+            }
             
-            // Get all symbols being tracked
-            auto symbols = buffer_.getSymbols();
+            // Symbols being tracked (a new list only after a listing change)
+            listed.refresh();
+            const std::vector<SymbolId>& symbols = listed.symbols();
             
             if (symbols.empty()) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 continue;
             }
             
-            auto calc_start = std::chrono::high_resolution_clock::now();
+            auto calc_start = TickClock::now();
+            size_t pass_start_count = calculation_count_;
             
             // Calculate SMA for each symbol
-            for (const auto& symbol : symbols) {
-                // Read price history (CRITICAL SECTION handled internally)
-                auto history = buffer_.getHistory(symbol, window_size_);
-                
-                if (history.size() < 2) {
-                    continue;  // Not enough data yet
-                }
-                
-                // Calculate Simple Moving Average
-                double sum = 0.0;
-                for (const auto& data : history) {
-                    sum += data.price;
-                }
-                double sma = sum / history.size();
-                
-                // Get latest price for comparison
-                double latest_price = history.back().price;
-                double deviation = ((latest_price - sma) / sma) * 100.0;
-                
-                // Record performance: latency from generation to calculation
-                auto generation_time = history.back().timestamp;
-                auto processing_time = std::chrono::high_resolution_clock::now();
-                perf_monitor_.recordProcessing(symbol, "SMA", generation_time, processing_time);
-                
-                ++calculation_count;
-                
-                // Log results periodically
-                if (calculation_count % 20 == 0) {
-                    std::cout << "\n[SMACalculator] " << symbol 
-                              << " - Price: $" << std::fixed << std::setprecision(2) << latest_price
-                              << " | SMA(" << history.size() << "): $" << sma
-                              << " | Deviation: " << std::showpos << deviation << "%" << std::noshowpos;
+            for (SymbolId symbol : symbols) {
+                // Notify mode: skip symbols whose epoch did not move since our last pass
+                if (notify && !hasNewData(symbol)) {
+                    continue;
                 }
+                calculateSymbol(symbol);
             }
+            passComplete();     // Between passes: safe point for a checkpoint copy
             
-            auto calc_end = std::chrono::high_resolution_clock::now();
+            auto calc_end = TickClock::now();
             auto calc_time = std::chrono::duration_cast<std::chrono::microseconds>(
                 calc_end - calc_start).count();
             
             // Log calculation performance (display in microseconds using ASCII)
-            if (calculation_count % 20 == 0) {
+            if (calculation_count_ != pass_start_count && logSample(calculation_count_)) {
                 std::cout << " | Calc time: " << calc_time << " us\n";
             }
             
             // Sleep to control calculation rate
-            std::this_thread::sleep_for(std::chrono::milliseconds(calculation_interval_ms_));
+            if (!notify) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(calculation_interval_ms_));
+            }
         }
         
         std::cout << "\n[SMACalculator] SMA calculation loop exited after " 
-                  << calculation_count << " calculations\n";
+                  << calculation_count_ << " calculations\n";
     }
 };
 
@@ -0,0 +1,48 @@
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include "CacheLine.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Statistics counter that many threads bump without sharing a cache line.
+//
+// Each thread adds to its own padded slot (threads are dealt slots in the
+// order they first count, so up to kSlots threads never share one), and
+// total() sums the slots. Adds are as cheap as on an uncontended atomic;
+// total() is for reporting, not the hot path, and may miss adds that are
+// in flight while it runs.
+class ShardedCounter {
+public:
+    static constexpr size_t kSlots = 16;
+
+private:
+    CachePadded<std::atomic<uint64_t>> slots_[kSlots];
+    
+    static size_t threadSlot() {
+        static std::atomic<size_t> next_thread{0};
+        thread_local size_t slot = next_thread.fetch_add(1, std::memory_order_relaxed) % kSlots;
+        return slot;
+    }
+
+public:
+    ShardedCounter() {
+        for (auto& slot : slots_) slot->store(0, std::memory_order_relaxed);
+    }
+    
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+    
+    void add(uint64_t n = 1) {
+        slots_[threadSlot()]->fetch_add(n, std::memory_order_relaxed);
+    }
+    
+    uint64_t total() const {
+        uint64_t sum = 0;
+        for (const auto& slot : slots_) sum += slot->load(std::memory_order_relaxed);
+        return sum;
+    }
+};
+
+#endif // SHARDED_COUNTER_H
@@ -2,121 +2,770 @@
 #define SHARED_BUFFER_H
 
 #include "PriceData.h"
+#include "PriceRing.h"
+#include "TickArena.h"
+#include "LatestPriceBoard.h"
+#include "CacheLine.h"
+#include "ShardedCounter.h"
+#include "SymbolRegistry.h"
+#include "SymbolTable.h"
+#include "ConsumerCursors.h"
+#include "BarAggregator.h"
+#include "Trace.h"
 #include <vector>
+#include <algorithm>
+#include <string>
 #include <mutex>
 #include <condition_variable>
-#include <map>
-#include <deque>
+#include <memory>
+#include <atomic>
+
+// Synchronization strategy used by SharedBuffer.
+// Both modes store history in one PriceRing per symbol.
+enum class BufferMode {
+    Mutex,      // Single mutex serializes every push and read (original design)
+    LockFree    // Single-writer rings read with seqlock semantics, no lock
+};
+
+// How a consumer thread decides when to run its next pass.
+enum class ConsumerWakeMode {
+    Poll,       // waitForData() + fixed sleep between passes (original design)
+    Notify      // waitForUpdate() on the write epoch; process changed symbols only
+};
+
+// Buffer-wide counters plus every registered consumer's lag (see getStats)
+struct BufferStats {
+    size_t writes = 0;
+    size_t reads = 0;
+    uint64_t producer_waits = 0;        // Times a producer blocked on a slow consumer
+    int64_t producer_wait_ns = 0;       // Total time spent blocked
+    uint64_t unlisted_dropped = 0;      // Ticks pushed for delisted (or not yet listed) symbols
+    std::vector<ConsumerStats> consumers;
+    uint64_t bars_closed[kBarLevels] = {};  // Per level, all symbols (0 without bars)
+};
 
 // Simple thread-safe buffer that stores recent prices per symbol.
 class SharedBuffer {
 private:
-    // Map of symbol -> deque of price history (circular buffer per symbol)
-    std::map<std::string, std::deque<PriceData>> price_history_;
+    // Symbol names <-> dense IDs; grows into its spare slots as symbols are listed
+    SymbolRegistry& registry_;
+    
+    // Storage for every ring's ticks, sized from max_history_size_ up front
+    TickArena arena_;
+    
+    // Ring (circular buffer) per symbol ID slot (the registry's capacity).
+    // Built once in the constructor and never resized afterwards, so
+    // concurrent indexing needs no lock.
+    std::vector<std::unique_ptr<PriceRing>> rings_;
+    
+    // Latest tick per symbol, published next to the ring; getLatest() and
+    // snapshotLatest() read only this, never the rings or mutex_
+    LatestPriceBoard board_;
     
     // Maximum history size per symbol (circular buffer constraint)
     const size_t max_history_size_;
     
-    // Synchronization primitives
-    mutable std::mutex mutex_;              // Protects all shared data
-    std::condition_variable cv_data_ready_; // Notifies consumers when new data arrives
+    // 1s/1m/5m/1h OHLCV bars, updated on every push (null: bars disabled)
+    std::unique_ptr<BarAggregator> bars_;
+    
+    const BufferMode mode_;
+    
+    // Registered consumers' read cursors and overload policies (filled
+    // before any thread starts)
+    ConsumerCursors consumers_;
     
-    // Shutdown flag for graceful termination
-    bool shutdown_;
+    // Listed symbols, RCU-published (listSymbol / delistSymbol)
+    SymbolTable symbols_;
+    
+    // Shutdown flag for graceful termination (written once, read by every wait)
+    std::atomic<bool> shutdown_;
+    
+    // Everything above is read-mostly; each write-hot member below gets a
+    // cache line of its own, so e.g. the producer bumping total_writes_
+    // doesn't invalidate the line consumers read rings_ and mode_ from.
+    
+    // Synchronization primitives (consumers' wait path)
+    alignas(kCacheLineSize) mutable std::mutex mutex_;  // Serializes ring access (Mutex mode)
+    std::condition_variable cv_data_ready_; // Notifies consumers when new data arrives
     
     // Statistics
-    size_t total_writes_;
-    size_t total_reads_;
+    alignas(kCacheLineSize) std::atomic<size_t> total_writes_;  // Also the global write epoch
+    ShardedCounter total_reads_;            // Per reader thread, summed in getStats()
+    
+    // Consumers currently blocked on cv_data_ready_. The producer only pays
+    // for a wakeup (mutex handoff + notify) when someone is actually waiting.
+    alignas(kCacheLineSize) std::atomic<int> waiters_;
+    
+    // Backpressure (BlockProducer consumers): producers wait on cv_room_
+    // until a consumer's cursor moves; consumers only notify when one does
+    alignas(kCacheLineSize) std::atomic<int> blocked_producers_;
+    std::mutex room_mutex_;
+    std::condition_variable cv_room_;
+    ShardedCounter producer_waits_;
+    ShardedCounter producer_wait_ns_;
+    ShardedCounter unlisted_dropped_;
+    
+    // Registers a consumer in waiters_ for the duration of a wait
+    struct WaiterScope {
+        std::atomic<int>& count;
+        explicit WaiterScope(std::atomic<int>& c) : count(c) { ++count; }
+        ~WaiterScope() { --count; }
+    };
+    
+    // Wake blocked consumers after a write. Both sides use seq_cst: either
+    // the waiter sees the new epoch in its predicate, or this sees the
+    // waiter and takes mutex_ so the notify cannot land between the
+    // waiter's predicate check and its sleep.
+    void notifyConsumers() {
+        if (waiters_.load() == 0) {
+            return;
+        }
+        { std::lock_guard<std::mutex> handoff(mutex_); }
+        cv_data_ready_.notify_all();
+    }
+    
+    // Locks mutex_ in Mutex mode only
+    std::unique_lock<std::mutex> modeLock() const {
+        if (mode_ != BufferMode::Mutex) {
+            return std::unique_lock<std::mutex>();
+        }
+        TRACE_SPAN("lock wait");
+        return std::unique_lock<std::mutex>(mutex_);
+    }
+    
+    /**
+     * @brief Producer: wait until every blocking consumer has room for
+     *        symbol's next tick (BlockProducer)
+     * 
+     * Before sleeping, the ticks of the batch published so far
+     * (published) are made visible to waitForUpdate() and consumers are
+     * woken, and mutex_ (Mutex mode) is released, so the consumers being
+     * waited for can run. Shutdown ends the wait, and so does a delisting
+     * of symbol: consumers stop reading a delisted symbol, so its cursors
+     * would never move.
+     * @return false if symbol was delisted meanwhile (drop the tick)
+     */
+    bool waitForRoom(SymbolId symbol, uint64_t next, std::unique_lock<std::mutex>& lock, size_t& published) {
+        if (consumers_.hasRoom(symbol, next) || shutdown_.load()) {
+            return true;
+        }
+        
+        bool relock = lock.owns_lock();
+        if (relock) lock.unlock();
+        if (published > 0) {
+            total_writes_ += published;
+            published = 0;
+            notifyConsumers();
+        }
+        
+        TRACE_SPAN("backpressure");
+        auto wait_start = TickClock::now();
+        {
+            WaiterScope waiting(blocked_producers_);
+            std::unique_lock<std::mutex> room_lock(room_mutex_);
+            while (!shutdown_ && !consumers_.hasRoom(symbol, next) && symbols_.listed(symbol)) {
+                cv_room_.wait_for(room_lock, std::chrono::milliseconds(10));
+            }
+        }
+        producer_waits_.add();
+        producer_wait_ns_.add(static_cast<uint64_t>((TickClock::now() - wait_start).count()));
+        
+        if (relock) lock.lock();
+        return symbols_.listed(symbol);
+    }
+    
+    static std::vector<SymbolId> allRegistered(const SymbolRegistry& registry) {
+        std::vector<SymbolId> ids;
+        for (size_t id = 0; id < registry.size(); ++id) ids.push_back(static_cast<SymbolId>(id));
+        return ids;
+    }
+    
+    // Consumer: wake producers blocked on a cursor that just moved
+    void notifyProducers() {
+        if (blocked_producers_.load() == 0) {
+            return;
+        }
+        { std::lock_guard<std::mutex> handoff(room_mutex_); }
+        cv_room_.notify_all();
+    }
 
 public:
-    explicit SharedBuffer(size_t max_size = 100) 
-        : max_history_size_(max_size), shutdown_(false), 
-          total_writes_(0), total_reads_(0) {}
+    /**
+     * @param registry Symbol universe: its symbols start listed, and its
+     *                 spare slots (capacity) take symbols listed later.
+     *                 Pushes for IDs outside the registry, or not listed,
+     *                 are dropped.
+     * @param max_size Maximum history size per symbol
+     * @param mode Synchronization strategy (see BufferMode)
+     * @param bar_history Closed OHLCV bars kept per symbol and resolution
+     *                    (0 = no bars; see BarAggregator)
+     */
+    explicit SharedBuffer(SymbolRegistry& registry,
+                          size_t max_size = 100,
+                          BufferMode mode = BufferMode::Mutex,
+                          size_t bar_history = 0)
+        : registry_(registry), arena_(registry.capacity(), PriceRing::storageBytes(max_size)),
+          board_(registry.capacity()), max_history_size_(max_size),
+          bars_(bar_history > 0 ? std::make_unique<BarAggregator>(registry.capacity(), bar_history) : nullptr),
+          mode_(mode),
+          consumers_(registry.capacity()), symbols_(registry.capacity(), allRegistered(registry)),
+          shutdown_(false), total_writes_(0), waiters_(0), blocked_producers_(0) {
+        rings_.reserve(registry_.capacity());
+        for (size_t id = 0; id < registry_.capacity(); ++id) {
+            rings_.push_back(std::make_unique<PriceRing>(static_cast<SymbolId>(id), max_history_size_,
+                                                         arena_.slice(id)));
+        }
+    }
+    
+    BufferMode mode() const { return mode_; }
+    
+    const SymbolRegistry& registry() const { return registry_; }
+    
+    /**
+     * @brief Listed symbols: consumers hold a SymbolTable::Reader on it
+     */
+    const SymbolTable& symbolTable() const { return symbols_; }
+    
+    /**
+     * @brief List symbols by name and delist others by ID, as one new table version
+     * 
+     * New names take spare registry slots; a name listed before gets its
+     * old ID (and history) back. Thread-safe, any time.
+     * @param listed_ids If not null, receives the IDs listed (kInvalidSymbolId:
+     *                   no spare slot was left)
+     * @return Symbols whose listing changed
+     */
+    size_t updateListings(const std::vector<std::string>& list, const std::vector<SymbolId>& delist,
+                          std::vector<SymbolId>* listed_ids = nullptr) {
+        std::vector<SymbolId> ids;
+        ids.reserve(list.size());
+        for (const auto& name : list) ids.push_back(registry_.tryIntern(name));
+        size_t changed = symbols_.update(ids, delist);
+        if (listed_ids) *listed_ids = std::move(ids);
+        return changed;
+    }
+    
+    /**
+     * @return The symbol's ID, or kInvalidSymbolId if the registry is full
+     */
+    SymbolId listSymbol(const std::string& name) {
+        std::vector<SymbolId> ids;
+        updateListings({name}, {}, &ids);
+        return ids[0];
+    }
+    
+    bool delistSymbol(SymbolId symbol) {
+        return updateListings({}, {symbol}) > 0;
+    }
+    
+    SymbolTable::Stats getListingStats() { return symbols_.getStats(); }
+    
+    /**
+     * @brief Bytes of preallocated tick (and bar) storage across all symbols
+     */
+    size_t storageBytes() const { return arena_.bytes() + (bars_ ? bars_->storageBytes() : 0); }
+    
+    bool hasBars() const { return bars_ != nullptr; }
+    size_t barHistoryLimit() const { return bars_ ? bars_->historyLimit() : 0; }
+    
+    /**
+     * @brief Bind the tick storage of symbols to a NUMA node (called by a pinned producer)
+     * 
+     * Runs of consecutive IDs are bound with one call each, so contiguous
+     * partitions bind in a few calls. Storage is page-granular: with
+     * round-robin partitions, neighbouring symbols of other shards may
+     * share (and move with) a page.
+     * @return Bytes bound; 0 with error set if the system refused
+     */
+    size_t bindHistory(const std::vector<SymbolId>& symbols, int node, std::string& error) {
+        size_t bound = 0;
+        for (size_t i = 0; i < symbols.size();) {
+            size_t j = i + 1;
+            while (j < symbols.size() && symbols[j] == symbols[j - 1] + 1) ++j;
+            if (symbols[i] < arena_.sliceCount()) {
+                size_t count = std::min<size_t>(j - i, arena_.sliceCount() - symbols[i]);
+                if (!arena_.bindSlices(symbols[i], count, node, error)) return 0;
+                bound += count * arena_.sliceBytes();
+            }
+            i = j;
+        }
+        return bound;
+    }
     
     /**
      * @brief Producer: Add new price data (thread-safe)
      * 
-     * Critical Section protected by mutex_:
-     * - Modifies price_history_ (shared resource)
+     * Critical Section protected by mutex_ (Mutex mode):
+     * - Modifies the symbol's ring (shared resource)
      * - Updates statistics
      * 
      * Notifies all waiting consumer threads via condition variable
      * after data is written (Producer-Consumer pattern).
      * 
+     * In LockFree mode the tick is published to the symbol's ring without
+     * taking mutex_; the producer never waits for a consumer.
+     * 
+     * Ticks for symbols that are not listed are dropped (and counted in
+     * BufferStats::unlisted_dropped), so a delisted symbol's history and
+     * cursors stay as they were whatever the producer sends.
+     * 
      * @param data Price data to add
      */
     void push(const PriceData& data) {
+        if (!registry_.contains(data.symbol)) {
+            return;  // Unknown symbol (not registered at construction)
+        }
+        if (!symbols_.listed(data.symbol)) {
+            unlisted_dropped_.add();
+            return;
+        }
+        
+        TRACE_SPAN("push");
         {
-            std::unique_lock<std::mutex> lock(mutex_);  // RAII lock acquisition
+            auto lock = modeLock();  // RAII lock acquisition (Mutex mode)
             
-            // Add to history for this symbol
-            auto& history = price_history_[data.symbol];
-            history.push_back(data);
-            
-            // Maintain circular buffer: remove oldest if exceeds max size
-            if (history.size() > max_history_size_) {
-                history.pop_front();
+            if (consumers_.anyBlocking()) {
+                size_t published = 0;
+                if (!waitForRoom(data.symbol, rings_[data.symbol]->sequence() + 1, lock, published)) {
+                    unlisted_dropped_.add();
+                    return;
+                }
             }
             
+            // Ring overwrites the oldest entry once max_history_size_ is exceeded
+            rings_[data.symbol]->publish(data);
+            board_.publish(data);
+            if (bars_) bars_->add(data);
+            
             ++total_writes_;
         }  // Lock released here automatically (RAII)
         
         // Notify ALL waiting consumer threads that new data is available
         // This is done OUTSIDE the lock to avoid unnecessary blocking
-        cv_data_ready_.notify_all();
+        notifyConsumers();
+    }
+    
+    /**
+     * @brief Producer: Add a whole batch of ticks in one publication step (thread-safe)
+     * 
+     * Equivalent to push() for each tick, but takes mutex_ (Mutex mode) once,
+     * advances the write epoch once and wakes consumers once for the whole
+     * batch. Consumers waiting in waitForUpdate() see the batch as a single
+     * epoch step; each tick is still visible per symbol as soon as its ring
+     * is published.
+     * 
+     * With a BlockProducer consumer registered, a tick that would take
+     * that consumer past its lag limit waits for it first (the ticks
+     * before it are published and announced meanwhile).
+     * 
+     * @param ticks Ticks to add (ticks for unknown or unlisted symbols are dropped)
+     * @param count Number of ticks
+     */
+    void pushBatch(const PriceData* ticks, size_t count) {
+        TRACE_SPAN("push");
+        size_t published = 0;
+        uint64_t unlisted = 0;
+        {
+            auto lock = modeLock();  // One critical section for the batch (Mutex mode)
+            bool backpressure = consumers_.anyBlocking();
+            
+            for (size_t i = 0; i < count; ++i) {
+                const PriceData& data = ticks[i];
+                if (!registry_.contains(data.symbol)) {
+                    continue;
+                }
+                bool listed = symbols_.listed(data.symbol);
+                if (listed && backpressure) {
+                    listed = waitForRoom(data.symbol, rings_[data.symbol]->sequence() + 1, lock, published);
+                }
+                if (!listed) {
+                    ++unlisted;
+                    continue;
+                }
+                rings_[data.symbol]->publish(data);
+                board_.publish(data);
+                if (bars_) bars_->add(data);
+                ++published;
+            }
+            
+            total_writes_ += published;
+        }
+        if (unlisted > 0) unlisted_dropped_.add(unlisted);
+        
+        if (published > 0) {
+            notifyConsumers();
+        }
+    }
+    
+    /**
+     * @brief Setup only: register a consumer that reads through consume()
+     * 
+     * Call before any thread starts. The consumer starts as DropOldest with
+     * a lag limit of half the history, and caught up with what the buffer
+     * already holds (e.g. history restored from a checkpoint); restoreCursor()
+     * moves it back to where a restored indicator actually is.
+     * @param resolution What it reads: ticks, or closed bars of one size
+     */
+    ConsumerId registerConsumer(const std::string& name, BarResolution resolution = BarResolution::Tick) {
+        ConsumerId id = consumers_.add(name, resolution, defaultLagLimit());
+        ConsumerCursors::Consumer& consumer = consumers_[id];
+        for (size_t symbol = 0; symbol < registry_.capacity(); ++symbol) {
+            consumer.cursors[symbol].store(sequence(static_cast<SymbolId>(symbol), resolution),
+                                           std::memory_order_relaxed);
+        }
+        return id;
+    }
+    
+    /**
+     * @brief Startup only: set the buffer's copy of a consumer's cursor to the
+     *        one its restored state continues from (see IndicatorTask::loadState)
+     * 
+     * Clamped to the symbol's sequence. Without it a blocking consumer would
+     * look as far behind as the restored cursor is, and hold the producer.
+     */
+    void restoreCursor(ConsumerId consumer, SymbolId symbol, uint64_t cursor) {
+        if (!consumers_.contains(consumer) || !registry_.contains(symbol)) {
+            return;
+        }
+        ConsumerCursors::Consumer& c = consumers_[consumer];
+        uint64_t published = sequence(symbol, c.resolution);
+        c.cursors[symbol].store(cursor < published ? cursor : published, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Setup only: choose what happens when the consumer falls behind
+     * Bar consumers always drop the oldest: bars arrive slowly and are
+     * derived from ticks the producer has already published.
+     * @param lag_limit Unread ticks per symbol tolerated before conflating
+     *                  or blocking (0 = half the history); at most the history,
+     *                  so a blocking consumer never loses a tick
+     */
+    void setOverloadPolicy(ConsumerId consumer, OverloadPolicy policy, uint64_t lag_limit = 0) {
+        if (!consumers_.contains(consumer) || consumers_[consumer].resolution != BarResolution::Tick) {
+            return;
+        }
+        if (lag_limit == 0) lag_limit = defaultLagLimit();
+        if (lag_limit > max_history_size_) lag_limit = max_history_size_;
+        consumers_.setPolicy(consumer, policy, lag_limit);
+    }
+    
+    uint64_t defaultLagLimit() const {
+        return max_history_size_ > 1 ? max_history_size_ / 2 : 1;
+    }
+    
+    void pushBatch(const std::vector<PriceData>& ticks) {
+        pushBatch(ticks.data(), ticks.size());
     }
     
     /**
      * @brief Consumer: Get latest price for a symbol (thread-safe)
      * 
-     * Critical Section protected by mutex_:
-     * - Reads price_history_ (shared resource)
+     * Reads the latest-price board: no lock in either mode, no history access.
      * 
-     * @param symbol Stock symbol to query
+     * @param symbol Stock symbol ID to query
      * @param data Output parameter for price data
      * @return true if data found, false otherwise
      */
-    bool getLatest(const std::string& symbol, PriceData& data) {
-        std::unique_lock<std::mutex> lock(mutex_);
+    bool getLatest(SymbolId symbol, PriceData& data) {
+        if (!registry_.contains(symbol)) {
+            return false;
+        }
         
-        auto it = price_history_.find(symbol);
-        if (it != price_history_.end() && !it->second.empty()) {
-            data = it->second.back();  // Get most recent
-            ++total_reads_;
-            return true;
+        if (!board_.read(symbol, data)) {
+            return false;
         }
-        return false;
+        total_reads_.add();
+        return true;
     }
     
     /**
-     * @brief Consumer: Get price history for indicator calculations (thread-safe)
+     * @brief Consumer: Latest tick of every symbol in one call (thread-safe)
      * 
-     * Critical Section protected by mutex_:
-     * - Reads price_history_ (shared resource)
+     * Reads the latest-price board, without a lock in either mode. Each
+     * entry is a consistent tick, but different symbols may be read a few
+     * ticks apart.
      * 
-     * @param symbol Stock symbol to query
-     * @param count Number of recent prices to retrieve
-     * @return Vector of recent prices (oldest to newest)
+     * @param latest Indexed by symbol ID; untouched where sequences[id] is 0
+     * @param sequences Indexed by symbol ID: the board version at the read
+     *                  (0 = no data yet; changes with every tick), so callers
+     *                  can skip unchanged symbols
      */
-    std::vector<PriceData> getHistory(const std::string& symbol, size_t count) {
-        std::unique_lock<std::mutex> lock(mutex_);
+    void snapshotLatest(std::vector<PriceData>& latest, std::vector<uint64_t>& sequences) {
+        latest.resize(board_.size());
+        sequences.resize(board_.size());
         
-        std::vector<PriceData> result;
-        auto it = price_history_.find(symbol);
+        for (size_t id = 0; id < board_.size(); ++id) {
+            SymbolId symbol = static_cast<SymbolId>(id);
+            if (board_.version(symbol) == sequences[id]) {
+                continue;  // Caller already holds this tick
+            }
+            if (!board_.read(symbol, latest[id], &sequences[id])) {
+                sequences[id] = 0;
+            }
+        }
+        total_reads_.add();
+    }
+    
+    /**
+     * @brief Consumer: Zero-copy view of recent history (thread-safe)
+     * 
+     * Returns up to count most recent ticks as (at most) two contiguous
+     * segments pointing into ring storage, plus the ring's version stamp.
+     * Nothing is copied and no lock is held while the caller iterates.
+     * 
+     * The producer may keep writing meanwhile: after using the view, call
+     * view.valid() and retry if it returns false. Views stay usable while
+     * the buffer is alive.
+     * 
+     * @param symbol Stock symbol ID to query
+     * @param count Number of recent prices to view
+     * @return View of recent prices (oldest to newest); empty if unknown
+     */
+    HistoryView getHistoryView(SymbolId symbol, size_t count) {
+        if (!registry_.contains(symbol)) {
+            return HistoryView();
+        }
         
-        if (it != price_history_.end()) {
-            const auto& history = it->second;
-            size_t start = (history.size() > count) ? (history.size() - count) : 0;
+        TRACE_SPAN("history fetch");
+        auto lock = modeLock();
+        total_reads_.add();
+        return rings_[symbol]->view(count);
+    }
+    
+    /**
+     * @brief Consumer: Copy ticks published after a consumer's cursor (thread-safe)
+     * 
+     * Lets streaming consumers fold each tick into their state exactly once.
+     * At most max_history_size_ ticks are returned; if the consumer fell
+     * further behind, the older ticks are gone and counted in missed.
+     * 
+     * @param symbol Stock symbol ID to query
+     * @param cursor Sequence number the consumer has consumed up to
+     * @param out New ticks (oldest to newest, SoA), replaced on each call
+     * @param missed Optional output: ticks overwritten before they were read
+     * @return New cursor value (the ring's sequence number)
+     */
+    uint64_t readSince(SymbolId symbol, uint64_t cursor,
+                       TickBatch& out, uint64_t* missed = nullptr) {
+        out.clear();
+        out.symbol = symbol;
+        if (missed) *missed = 0;
+        
+        if (!registry_.contains(symbol)) {
+            return cursor;
+        }
+        
+        TRACE_SPAN("history fetch");
+        auto lock = modeLock();
+        const PriceRing& ring = *rings_[symbol];
+        for (;;) {
+            HistoryView view = ring.view(max_history_size_);
+            if (view.version <= cursor) {
+                return cursor;  // Nothing new
+            }
             
-            for (size_t i = start; i < history.size(); ++i) {
-                result.push_back(history[i]);
+            // Copy the unseen tail of the view, segment by segment
+            uint64_t fresh = view.version - cursor;
+            size_t skip = (fresh < view.size()) ? view.size() - static_cast<size_t>(fresh) : 0;
+            out.clear();
+            if (skip < view.first.size) {
+                out.append(view.first, skip, view.first.size - skip);
+                out.append(view.second, 0, view.second.size);
+            } else {
+                size_t from = skip - view.first.size;
+                out.append(view.second, from, view.second.size - from);
             }
-            ++total_reads_;
+            
+            if (view.valid()) {
+                if (missed) *missed = fresh - out.size();
+                total_reads_.add();
+                return view.version;
+            }
+        }
+    }
+    
+    /**
+     * @brief Consumer: readSince() through a registered consumer's cursor and policy
+     * 
+     * The buffer tracks where the consumer is, so it can report its lag and
+     * the ticks it lost (see getStats()):
+     * - DropOldest: same as readSince(); overwritten ticks count as dropped.
+     * - ConflateLatest: more than the lag limit behind, only the newest
+     *   tick is returned and the skipped ones count as conflated.
+     * - BlockProducer: same as readSince(); the producer waited instead of
+     *   overwriting, so nothing is dropped. Blocked producers are woken.
+     * 
+     * 
+     * A consumer registered for a bar resolution reads closed bars instead
+     * (see readBarsSince()); overwritten bars count as dropped.
+     * 
+     * @param cursor The consumer's own cursor for symbol (restored state may
+     *               start ahead of the buffer's copy)
+     * @return New cursor value
+     */
+    uint64_t consume(ConsumerId consumer, SymbolId symbol, uint64_t cursor, TickBatch& out) {
+        if (!consumers_.contains(consumer) || !registry_.contains(symbol)) {
+            return readSince(symbol, cursor, out);
+        }
+        
+        ConsumerCursors::Consumer& c = consumers_[consumer];
+        if (c.resolution != BarResolution::Tick) {
+            uint64_t missed = 0;
+            uint64_t next = readBarsSince(symbol, c.resolution, cursor, out, &missed);
+            c.notePeak(next - cursor);
+            if (missed > 0) c.dropped.add(missed);
+            c.cursors[symbol].store(next, std::memory_order_release);
+            return next;
+        }
+        
+        uint64_t sequence = rings_[symbol]->sequence();
+        uint64_t lag = sequence > cursor ? sequence - cursor : 0;
+        c.notePeak(lag);
+        if (c.policy == OverloadPolicy::ConflateLatest && lag > c.lag_limit) {
+            c.conflated.add(lag - 1);
+            cursor += lag - 1;
         }
         
+        uint64_t missed = 0;
+        uint64_t next = readSince(symbol, cursor, out, &missed);
+        if (missed > 0) c.dropped.add(missed);
+        
+        c.cursors[symbol].store(next, std::memory_order_release);
+        if (c.policy == OverloadPolicy::BlockProducer) {
+            notifyProducers();
+        }
+        return next;
+    }
+    
+    /**
+     * @brief Consumer: copy the bars closed after a cursor, as ticks (thread-safe)
+     * 
+     * Each bar becomes one entry of out: price = close, change = close - open,
+     * volume = bar volume, timestamp = its closing tick. This lets the tick
+     * calculators run unchanged on bars of any resolution. At most
+     * barHistoryLimit() bars are returned; older ones count in missed.
+     * 
+     * @param resolution Second, Minute, FiveMinutes or Hour (Tick reads ticks)
+     * @param cursor Bars of this symbol and resolution consumed so far
+     * @return New cursor value (bars closed so far)
+     */
+    uint64_t readBarsSince(SymbolId symbol, BarResolution resolution, uint64_t cursor,
+                           TickBatch& out, uint64_t* missed = nullptr) {
+        if (resolution == BarResolution::Tick) {
+            return readSince(symbol, cursor, out, missed);
+        }
+        out.clear();
+        out.symbol = symbol;
+        if (missed) *missed = 0;
+        if (!bars_ || !registry_.contains(symbol)) {
+            return cursor;
+        }
+        
+        TRACE_SPAN("history fetch");
+        auto lock = modeLock();
+        uint64_t next = bars_->series(symbol, barLevel(resolution)).readSince(cursor, symbol, out, missed);
+        total_reads_.add();
+        return next;
+    }
+    
+    /**
+     * @brief Consumer: copy up to count most recent closed bars (oldest to newest)
+     * @return Number of bars copied (0 without bars)
+     */
+    size_t getBars(SymbolId symbol, BarResolution resolution, size_t count, std::vector<Bar>& out) {
+        out.clear();
+        if (!bars_ || !registry_.contains(symbol) || resolution == BarResolution::Tick) {
+            return 0;
+        }
+        
+        TRACE_SPAN("history fetch");
+        auto lock = modeLock();
+        bars_->series(symbol, barLevel(resolution)).readRecent(count, out);
+        total_reads_.add();
+        return out.size();
+    }
+    
+    /**
+     * @brief Startup only: refill a symbol's ring from saved ticks (see PriceRing::restore)
+     * 
+     * Not counted as writes, so the write epoch still starts at 0.
+     * @return false if the symbol is unknown
+     */
+    bool restoreHistory(SymbolId symbol, uint64_t sequence, const TickBatch& ticks) {
+        if (!registry_.contains(symbol)) {
+            return false;
+        }
+        auto lock = modeLock();
+        rings_[symbol]->restore(sequence, ticks.prices.data(), ticks.changes.data(),
+                                ticks.volumes.data(), ticks.timestamps.data(), ticks.size());
+        PriceData latest;
+        if (rings_[symbol]->readLatest(latest)) {
+            board_.publish(latest);
+        }
+        return true;
+    }
+    
+    size_t historyLimit() const { return max_history_size_; }
+    
+    /**
+     * @brief Latest tick of every symbol, for readers that want it directly
+     */
+    const LatestPriceBoard& latestBoard() const { return board_; }
+    
+    /**
+     * @brief Number of ticks ever published for a symbol (0 if unknown)
+     */
+    uint64_t sequence(SymbolId symbol) const {
+        return registry_.contains(symbol) ? rings_[symbol]->sequence() : 0;
+    }
+    
+    /**
+     * @brief Ticks (Tick) or closed bars of a resolution published so far for a symbol
+     */
+    uint64_t sequence(SymbolId symbol, BarResolution resolution) const {
+        if (resolution == BarResolution::Tick) {
+            return sequence(symbol);
+        }
+        return (bars_ && registry_.contains(symbol)) ? bars_->series(symbol, barLevel(resolution)).sequence() : 0;
+    }
+    
+    /**
+     * @brief Consumer: Copy price history for indicator calculations (thread-safe)
+     * 
+     * Copying counterpart of getHistoryView(); the result is always consistent.
+     * 
+     * @param symbol Stock symbol ID to query
+     * @param count Number of recent prices to retrieve
+     * @return Vector of recent prices (oldest to newest)
+     */
+    std::vector<PriceData> getHistory(SymbolId symbol, size_t count) {
+        std::vector<PriceData> result;
+        getHistory(symbol, count, result);
         return result;
     }
     
+    /**
+     * @brief Consumer: Copy price history into a caller-owned vector (thread-safe)
+     * 
+     * Same as getHistory(symbol, count), but out keeps its capacity across
+     * calls, so a consumer reusing it stops allocating after the first one.
+     * 
+     * @param out Recent prices (oldest to newest), replaced on each call
+     * @return Number of prices copied
+     */
+    size_t getHistory(SymbolId symbol, size_t count, std::vector<PriceData>& out) {
+        out.clear();
+        if (!registry_.contains(symbol)) {
+            return 0;
+        }
+        
+        TRACE_SPAN("history fetch");
+        auto lock = modeLock();
+        rings_[symbol]->readRecent(count, out);
+        total_reads_.add();
+        return out.size();
+    }
+    
     /**
      * @brief Consumer: Wait for new data (blocking with condition variable)
      * 
@@ -131,6 +780,8 @@ public:
      * @return true if woken by signal, false if timeout
      */
     bool waitForData(int timeout_ms = 1000) {
+        TRACE_SPAN("wait");
+        WaiterScope waiting(waiters_);
         std::unique_lock<std::mutex> lock(mutex_);
         
         // Wait until either:
@@ -143,16 +794,63 @@ public:
     }
     
     /**
-     * @brief Get all tracked symbols (thread-safe)
+     * @brief Consumer: Wait until the write epoch moves past seen_epoch
+     * 
+     * Unlike waitForData(), this blocks again after every pass: the consumer
+     * passes the epoch it has already processed and sleeps until a newer
+     * tick is pushed, so it runs as soon as data arrives rather than on a
+     * fixed interval. Combine with sequence(symbol) to visit only the
+     * symbols that changed since the consumer's last pass.
+     * 
+     * @param seen_epoch Epoch returned by the previous call (0 initially)
+     * @param timeout_ms Maximum wait time in milliseconds
+     * @return Current epoch (equal to seen_epoch on timeout or shutdown)
      */
-    std::vector<std::string> getSymbols() {
+    uint64_t waitForUpdate(uint64_t seen_epoch, int timeout_ms = 1000) {
+        if (total_writes_.load() > seen_epoch || shutdown_.load()) {
+            return total_writes_.load();
+        }
+        
+        TRACE_SPAN("wait");
+        WaiterScope waiting(waiters_);
         std::unique_lock<std::mutex> lock(mutex_);
+        cv_data_ready_.wait_for(lock,
+                                std::chrono::milliseconds(timeout_ms),
+                                [this, seen_epoch] { return shutdown_ || total_writes_ > seen_epoch; });
+        return total_writes_.load();
+    }
+    
+    /**
+     * @brief Global write epoch (ticks pushed so far)
+     */
+    uint64_t epoch() const {
+        return total_writes_.load();
+    }
+    
+    /**
+     * @brief Get IDs of all listed symbols that have received data (thread-safe)
+     * 
+     * Copies and filters the whole list; consumer loops read the list in
+     * place through a SymbolTable::Reader instead.
+     */
+    std::vector<SymbolId> getSymbols() {
+        std::vector<SymbolId> symbols;
+        getSymbols(symbols);
+        return symbols;
+    }
+    
+    /**
+     * @brief Same as getSymbols(), into a vector the caller reuses across passes
+     */
+    void getSymbols(std::vector<SymbolId>& out) {
+        out.clear();
         
-        std::vector<std::string> symbols;
-        for (const auto& pair : price_history_) {
-            symbols.push_back(pair.first);
+        SymbolTable::Reader reader(symbols_);
+        for (SymbolId id : reader.symbols()) {
+            if (rings_[id]->sequence() > 0) {
+                out.push_back(id);
+            }
         }
-        return symbols;
     }
     
     /**
@@ -168,23 +866,58 @@ public:
             shutdown_ = true;
         }
         cv_data_ready_.notify_all();
+        { std::lock_guard<std::mutex> handoff(room_mutex_); }
+        cv_room_.notify_all();
     }
     
     /**
      * @brief Check if shutdown was signaled
      */
     bool isShutdown() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return shutdown_;
+        return shutdown_.load();
     }
     
     /**
      * @brief Get statistics (thread-safe)
      */
     void getStats(size_t& writes, size_t& reads) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        writes = total_writes_;
-        reads = total_reads_;
+        writes = total_writes_.load();
+        reads = static_cast<size_t>(total_reads_.total());
+    }
+    
+    /**
+     * @brief Get statistics including backpressure and every consumer's lag (thread-safe)
+     * 
+     * Lag is read from the cursors now, one symbol at a time, so it is a
+     * close estimate while threads are running.
+     */
+    void getStats(BufferStats& stats) {
+        getStats(stats.writes, stats.reads);
+        stats.producer_waits = producer_waits_.total();
+        stats.producer_wait_ns = static_cast<int64_t>(producer_wait_ns_.total());
+        stats.unlisted_dropped = unlisted_dropped_.total();
+        stats.consumers.clear();
+        
+        for (ConsumerId id = 0; id < consumers_.size(); ++id) {
+            const ConsumerCursors::Consumer& c = consumers_[id];
+            ConsumerStats s;
+            s.name = c.name;
+            s.policy = c.policy;
+            s.lag_limit = c.lag_limit;
+            s.resolution = c.resolution;
+            for (size_t symbol = 0; symbol < rings_.size(); ++symbol) {
+                uint64_t sequence = this->sequence(static_cast<SymbolId>(symbol), c.resolution);
+                uint64_t cursor = c.cursors[symbol].load(std::memory_order_acquire);
+                uint64_t lag = sequence > cursor ? sequence - cursor : 0;
+                s.lag += lag;
+                s.worst_lag = std::max(s.worst_lag, lag);
+            }
+            s.peak_lag = c.peak_lag.load(std::memory_order_relaxed);
+            s.dropped = c.dropped.total();
+            s.conflated = c.conflated.total();
+            stats.consumers.push_back(s);
+        }
+        if (bars_) bars_->closedBars(stats.bars_closed);
     }
 };
 
@@ -0,0 +1,303 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define SIMD_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Vectorized kernels for the indicator math over contiguous price arrays.
+//
+// The implementation is picked once at first use: AVX2 on x86 CPUs that
+// support it (checked at runtime, so the binary still runs on older CPUs),
+// NEON on ARM64, and a portable scalar loop everywhere else.
+namespace simd {
+
+// ------------------------------------------------------------
+// Scalar fallback
+// ------------------------------------------------------------
+
+inline double sumScalar(const double* x, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) s += x[i];
+    return s;
+}
+
+inline double sumSquaredDeviationsScalar(const double* x, size_t n, double mean) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = x[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+inline void returnsScalar(const double* prices, size_t n, double* out) {
+    for (size_t i = 0; i + 1 < n; ++i) {
+        out[i] = (prices[i + 1] - prices[i]) / prices[i];
+    }
+}
+
+inline void rankUpdateScalar(double* out, size_t n, const double* const* rows, const double* coeffs, size_t m) {
+    for (size_t i = 0; i < n; ++i) {
+        double s = out[i];
+        for (size_t k = 0; k < m; ++k) s += coeffs[k] * rows[k][i];
+        out[i] = s;
+    }
+}
+
+// ------------------------------------------------------------
+// AVX2 (x86, selected at runtime)
+// ------------------------------------------------------------
+
+#if defined(SIMD_KERNELS_X86)
+
+__attribute__((target("avx2")))
+inline double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    __m128d swapped = _mm_unpackhi_pd(lo, lo);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, swapped));
+}
+
+__attribute__((target("avx2")))
+inline double sumAvx2(const double* x, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(x + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(x + i + 4));
+    }
+    double s = hsum256(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) s += x[i];
+    return s;
+}
+
+__attribute__((target("avx2")))
+inline double sumSquaredDeviationsAvx2(const double* x, size_t n, double mean) {
+    __m256d m = _mm256_set1_pd(mean);
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), m);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), m);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    double s = hsum256(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) {
+        double d = x[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+__attribute__((target("avx2")))
+inline void returnsAvx2(const double* prices, size_t n, double* out) {
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        __m256d prev = _mm256_loadu_pd(prices + i);
+        __m256d next = _mm256_loadu_pd(prices + i + 1);
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_sub_pd(next, prev), prev));
+    }
+    for (; i + 1 < n; ++i) {
+        out[i] = (prices[i + 1] - prices[i]) / prices[i];
+    }
+}
+
+__attribute__((target("avx2")))
+inline void rankUpdateAvx2(double* out, size_t n, const double* const* rows, const double* coeffs, size_t m) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // 8 outputs stay in registers over all m rows: out is loaded and stored once
+        __m256d acc0 = _mm256_loadu_pd(out + i);
+        __m256d acc1 = _mm256_loadu_pd(out + i + 4);
+        for (size_t k = 0; k < m; ++k) {
+            __m256d c = _mm256_set1_pd(coeffs[k]);
+            acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(c, _mm256_loadu_pd(rows[k] + i)));
+            acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(c, _mm256_loadu_pd(rows[k] + i + 4)));
+        }
+        _mm256_storeu_pd(out + i, acc0);
+        _mm256_storeu_pd(out + i + 4, acc1);
+    }
+    for (; i < n; ++i) {
+        double s = out[i];
+        for (size_t k = 0; k < m; ++k) s += coeffs[k] * rows[k][i];
+        out[i] = s;
+    }
+}
+
+#endif // SIMD_KERNELS_X86
+
+// ------------------------------------------------------------
+// NEON (ARM64, always available)
+// ------------------------------------------------------------
+
+#if defined(SIMD_KERNELS_NEON)
+
+inline double sumNeon(const double* x, size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vaddq_f64(acc0, vld1q_f64(x + i));
+        acc1 = vaddq_f64(acc1, vld1q_f64(x + i + 2));
+    }
+    double s = vaddvq_f64(vaddq_f64(acc0, acc1));
+    for (; i < n; ++i) s += x[i];
+    return s;
+}
+
+inline double sumSquaredDeviationsNeon(const double* x, size_t n, double mean) {
+    float64x2_t m = vdupq_n_f64(mean);
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float64x2_t d0 = vsubq_f64(vld1q_f64(x + i), m);
+        float64x2_t d1 = vsubq_f64(vld1q_f64(x + i + 2), m);
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    double s = vaddvq_f64(vaddq_f64(acc0, acc1));
+    for (; i < n; ++i) {
+        double d = x[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+inline void returnsNeon(const double* prices, size_t n, double* out) {
+    size_t i = 0;
+    for (; i + 2 < n; i += 2) {
+        float64x2_t prev = vld1q_f64(prices + i);
+        float64x2_t next = vld1q_f64(prices + i + 1);
+        vst1q_f64(out + i, vdivq_f64(vsubq_f64(next, prev), prev));
+    }
+    for (; i + 1 < n; ++i) {
+        out[i] = (prices[i + 1] - prices[i]) / prices[i];
+    }
+}
+
+inline void rankUpdateNeon(double* out, size_t n, const double* const* rows, const double* coeffs, size_t m) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float64x2_t acc0 = vld1q_f64(out + i);
+        float64x2_t acc1 = vld1q_f64(out + i + 2);
+        for (size_t k = 0; k < m; ++k) {
+            float64x2_t c = vdupq_n_f64(coeffs[k]);
+            acc0 = vfmaq_f64(acc0, c, vld1q_f64(rows[k] + i));
+            acc1 = vfmaq_f64(acc1, c, vld1q_f64(rows[k] + i + 2));
+        }
+        vst1q_f64(out + i, acc0);
+        vst1q_f64(out + i + 2, acc1);
+    }
+    for (; i < n; ++i) {
+        double s = out[i];
+        for (size_t k = 0; k < m; ++k) s += coeffs[k] * rows[k][i];
+        out[i] = s;
+    }
+}
+
+#endif // SIMD_KERNELS_NEON
+
+// ------------------------------------------------------------
+// Runtime dispatch
+// ------------------------------------------------------------
+
+struct KernelTable {
+    const char* isa;
+    double (*sum)(const double*, size_t);
+    double (*sumSquaredDeviations)(const double*, size_t, double);
+    void (*returns)(const double*, size_t, double*);
+    void (*rankUpdate)(double*, size_t, const double* const*, const double*, size_t);
+};
+
+inline KernelTable selectKernels() {
+#if defined(SIMD_KERNELS_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", sumAvx2, sumSquaredDeviationsAvx2, returnsAvx2, rankUpdateAvx2};
+    }
+#elif defined(SIMD_KERNELS_NEON)
+    return {"neon", sumNeon, sumSquaredDeviationsNeon, returnsNeon, rankUpdateNeon};
+#endif
+    return {"scalar", sumScalar, sumSquaredDeviationsScalar, returnsScalar, rankUpdateScalar};
+}
+
+inline const KernelTable& kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+// Name of the selected implementation ("avx2", "neon" or "scalar")
+inline const char* activeIsa() { return kernels().isa; }
+
+// Sum of x[0..n)
+inline double sum(const double* x, size_t n) {
+    return kernels().sum(x, n);
+}
+
+// Sum of (x[i] - mean)^2 over x[0..n)
+inline double sumSquaredDeviations(const double* x, size_t n, double mean) {
+    return kernels().sumSquaredDeviations(x, n, mean);
+}
+
+// Simple returns: out[i] = (prices[i+1] - prices[i]) / prices[i], n-1 outputs
+inline void returns(const double* prices, size_t n, double* out) {
+    kernels().returns(prices, n, out);
+}
+
+// Low-rank update of one matrix row: out[i] += sum over k of coeffs[k] * rows[k][i],
+// i in [0, n), k in [0, m) (see RollingCovariance)
+inline void rankUpdate(double* out, size_t n, const double* const* rows, const double* coeffs, size_t m) {
+    kernels().rankUpdate(out, n, rows, coeffs, m);
+}
+
+// ------------------------------------------------------------
+// Compile-time sized (fixed windows, see BasicRollingWindow)
+// ------------------------------------------------------------
+//
+// With N a constant the loops have known trip counts, so the compiler
+// unrolls them (completely for small windows) and vectorizes the four
+// independent accumulators, the same lane split as the AVX2 kernels. No
+// dispatch: they inline into the caller.
+
+template <size_t N>
+inline double sumFixed(const double* x) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    for (size_t i = 0; i + 4 <= N; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) acc[lane] += x[i + lane];
+    }
+    double s = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    for (size_t i = N & ~size_t(3); i < N; ++i) s += x[i];
+    return s;
+}
+
+template <size_t N>
+inline double sumSquaredDeviationsFixed(const double* x, double mean) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    for (size_t i = 0; i + 4 <= N; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            double d = x[i + lane] - mean;
+            acc[lane] += d * d;
+        }
+    }
+    double s = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    for (size_t i = N & ~size_t(3); i < N; ++i) {
+        double d = x[i] - mean;
+        s += d * d;
+    }
+    return s;
+}
+
+} // namespace simd
+
+#endif // SIMD_KERNELS_H
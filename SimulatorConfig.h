@@ -0,0 +1,462 @@
+#ifndef SIMULATOR_CONFIG_H
+#define SIMULATOR_CONFIG_H
+
+#include "SharedBuffer.h"
+#include "PriceGenerator.h"
+#include "Clock.h"
+#include "ThreadPlacement.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Everything main.cpp can be told, from the command line or a config file.
+//
+// Options are "--key=value" flags (or a bare number: the runtime in
+// seconds). --config=FILE reads more of them from a file, one per line as
+// "key = value" or a bare "key" (the flag without its leading dashes; '#'
+// starts a comment), at the point where the flag appears, so later flags
+// override the file. An invalid value prints a warning and keeps the
+// default, as the original argument parsing did.
+//
+// --stress is a preset for throughput runs: many generated symbols, a
+// spinning generator, no display, component logs or sampled indicator
+// output, a short runtime. It is applied before the other options
+// wherever it appears, so any of them can still be overridden (e.g.
+// --stress --symbols=100000).
+struct SimulatorConfig {
+    static constexpr int kMaxRuntimeSeconds = 24 * 3600;
+    static constexpr size_t kMaxSymbols = 100000;
+    
+    int runtime_seconds = 45;
+    
+    // Producer
+    size_t symbol_count = 0;                // 0: AAPL GOOGL MSFT AMZN BTC; N: generated S1..SN
+    size_t symbol_capacity = 0;             // Symbol slots, spare ones for runtime listings (0: see symbolCapacity)
+    size_t listing_churn = 0;               // Symbols delisted and listed every second (0 = fixed universe)
+    int generator_interval_ms = 100;        // Sleep between generator iterations (0 = spin)
+    size_t producer_shards = 1;
+    SymbolPartition partition = SymbolPartition::RoundRobin;
+    std::string replay_path;                // Empty: random-walk generator
+    double replay_speed = 1.0;              // 0 = as fast as possible
+    PriceModel price_model = PriceModel::RandomWalk;
+    GbmParameters gbm;                      // --model=gbm settings
+    std::string feed_address;               // GROUP:PORT of a UDP tick feed (empty: none; see MulticastFeed.h)
+    std::string feed_interface;             // Local address joining the feed's group (empty: default)
+    int feed_busy_poll_us = 0;              // SO_BUSY_POLL and spinning receives (0 = blocking)
+    
+    // Buffer
+    BufferMode buffer_mode = BufferMode::LockFree;
+    size_t history_size = 100;              // Ticks kept per symbol
+    
+    // Slow consumers (see OverloadPolicy): a policy for every indicator,
+    // overridden per indicator name (--overload=block,sma:conflate)
+    OverloadPolicy overload_policy = OverloadPolicy::DropOldest;
+    std::vector<std::pair<std::string, OverloadPolicy>> overload_overrides;
+    size_t lag_limit = 0;                   // Unread ticks per symbol before conflating/blocking (0 = history / 2)
+    size_t bar_history = 0;                 // Closed 1s/1m/5m/1h bars kept per symbol (0 = no bars)
+    
+    // Consumers
+    ConsumerWakeMode wake_mode = ConsumerWakeMode::Notify;
+    size_t indicator_workers = defaultWorkers(); // 0 = one dedicated thread per indicator
+    bool fused_indicators = true;           // One pass for all indicators vs separate calculators
+    size_t window = 20;                     // SMA / EMA / volatility / VWAP window
+    bool fixed_windows = true;              // Compile-time sized kernels for windows 10/20/50/200
+    size_t rsi_period = 14;
+    BarResolution resolution = BarResolution::Tick;     // What the indicators run on
+    bool display = true;
+    bool quiet = false;                     // Mute component logs while running
+    int indicator_log_every = -1;           // Console sample: every N-th result (0 = off, -1 = defaults)
+    int correlation_interval_ms = 0;        // Correlation matrix sample interval (0 = no matrix)
+    size_t correlation_window = 100;        // Samples the matrix covers
+    
+    // Indicator output (see IndicatorOutput.h)
+    std::string output_path;                // Binary stream file of every result (empty: none)
+    std::string output_shm_path;            // Shared-memory queue of results (empty: none)
+    size_t output_queue_capacity = 65536;   // Records the queue keeps
+    
+    ClockSource clock_source = ClockSource::Auto;
+    
+    // Thread placement (see ThreadPlacement.h)
+    PlacementPlan placement;                // Per-role CPU lists; empty = unpinned
+    bool pin_auto = false;                  // Fill unlisted roles from the local NUMA node
+    
+    std::string trace_path;                 // Chrome trace written at exit / on SIGUSR1 (tracing builds)
+    
+    std::string checkpoint_path;            // Empty: no checkpoints, always a cold start
+    int checkpoint_interval_seconds = 5;
+    
+    bool stress = false;
+    
+    static constexpr size_t kDefaultBarHistory = 64;
+    
+    /**
+     * @brief Bars to keep: --bars=N, or the default when indicators run on bars
+     */
+    size_t barHistory() const {
+        if (bar_history == 0 && resolution != BarResolution::Tick) return kDefaultBarHistory;
+        return bar_history;
+    }
+    
+    /**
+     * @brief Symbol slots to reserve for initial symbols: --symbol-capacity,
+     *        or twice the initial count when --churn lists new symbols
+     */
+    size_t symbolCapacity(size_t initial) const {
+        size_t capacity = symbol_capacity;
+        if (capacity == 0 && listing_churn > 0) capacity = std::min(2 * initial, kMaxSymbols);
+        return std::max(capacity, initial);
+    }
+    
+    static size_t defaultWorkers() {
+        unsigned hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 1 ? hardware_threads - 1 : 1;
+    }
+    
+    /**
+     * @brief Build the configuration from argv (warnings go to std::cerr)
+     */
+    static SimulatorConfig fromArgs(int argc, char* argv[]) {
+        std::vector<std::string> args;
+        for (int i = 1; i < argc; ++i) {
+            expand(argv[i], args, 0);
+        }
+        
+        SimulatorConfig config;
+        for (const auto& arg : args) {
+            if (arg == "--stress") config.applyStressPreset();
+        }
+        for (const auto& arg : args) {
+            config.apply(arg);
+        }
+        if (config.pin_auto) {
+            PlacementPlan automatic = PlacementPlan::automatic(config.producer_shards);
+            for (size_t r = 0; r < kThreadRoleCount; ++r) {
+                if (config.placement.cpus[r].empty()) config.placement.cpus[r] = automatic.cpus[r];
+            }
+        }
+        return config;
+    }
+    
+    // Throughput preset (see the class comment)
+    void applyStressPreset() {
+        stress = true;
+        runtime_seconds = 10;
+        symbol_count = 1000;
+        generator_interval_ms = 0;
+        display = false;
+        quiet = true;
+        indicator_log_every = 0;
+    }
+    
+    /**
+     * @brief Overload policy for the indicator called name (case-insensitive)
+     */
+    OverloadPolicy overloadPolicyFor(const std::string& name) const {
+        OverloadPolicy policy = overload_policy;
+        for (const auto& entry : overload_overrides) {
+            if (lower(entry.first) == lower(name)) policy = entry.second;
+        }
+        return policy;
+    }
+    
+    /**
+     * @brief Apply one option; unknown or invalid ones print a warning
+     */
+    void apply(const std::string& arg) {
+        std::string value;
+        
+        if (arg == "--stress") {
+            return;     // Applied up front by fromArgs()
+        }
+        if (arg == "--buffer=mutex") {
+            buffer_mode = BufferMode::Mutex;
+        } else if (arg == "--buffer=lockfree") {
+            buffer_mode = BufferMode::LockFree;
+        } else if (arg == "--wake=poll") {
+            wake_mode = ConsumerWakeMode::Poll;
+        } else if (arg == "--wake=notify") {
+            wake_mode = ConsumerWakeMode::Notify;
+        } else if (option(arg, "--producers=", value)) {
+            producer_shards = parseCount(value, 1, "producer count", 1);
+        } else if (arg == "--partition=round-robin") {
+            partition = SymbolPartition::RoundRobin;
+        } else if (arg == "--partition=contiguous") {
+            partition = SymbolPartition::Contiguous;
+        } else if (option(arg, "--workers=", value)) {
+            indicator_workers = parseCount(value, 0, "worker count", 1);
+        } else if (arg == "--clock=tsc") {
+            clock_source = ClockSource::Auto;
+        } else if (arg == "--clock=steady") {
+            clock_source = ClockSource::Steady;
+        } else if (arg == "--pin=auto") {
+            pin_auto = true;
+        } else if (arg == "--pin=off") {
+            pin_auto = false;
+            for (auto& cpus : placement.cpus) cpus.clear();
+        } else if (option(arg, "--pin-producer=", value)) {
+            setCpus(ThreadRole::Producer, value);
+        } else if (option(arg, "--pin-indicators=", value)) {
+            setCpus(ThreadRole::Indicator, value);
+        } else if (option(arg, "--pin-display=", value)) {
+            setCpus(ThreadRole::Display, value);
+        } else if (option(arg, "--pin-background=", value)) {
+            setCpus(ThreadRole::Background, value);
+        } else if (arg == "--numa-bind=on") {
+            placement.bind_history = true;
+        } else if (arg == "--numa-bind=off") {
+            placement.bind_history = false;
+        } else if (arg == "--indicators=fused") {
+            fused_indicators = true;
+        } else if (arg == "--indicators=separate") {
+            fused_indicators = false;
+        } else if (option(arg, "--symbols=", value)) {
+            symbol_count = parseCount(value, 1, "symbol count", 0);
+            if (symbol_count > kMaxSymbols) {
+                std::cerr << "At most " << kMaxSymbols << " symbols. Using " << kMaxSymbols << ".\n";
+                symbol_count = kMaxSymbols;
+            }
+        } else if (option(arg, "--symbol-capacity=", value)) {
+            symbol_capacity = parseCount(value, 1, "symbol capacity", 0);
+            if (symbol_capacity > kMaxSymbols) {
+                std::cerr << "At most " << kMaxSymbols << " symbols. Using " << kMaxSymbols << ".\n";
+                symbol_capacity = kMaxSymbols;
+            }
+        } else if (option(arg, "--churn=", value)) {
+            listing_churn = parseCount(value, 0, "listing churn", 0);
+        } else if (option(arg, "--interval-ms=", value)) {
+            generator_interval_ms = static_cast<int>(parseCount(value, 0, "generator interval", 100));
+        } else if (option(arg, "--history=", value)) {
+            history_size = parseCount(value, 1, "history size", 100);
+        } else if (option(arg, "--overload=", value)) {
+            setOverload(value);
+        } else if (option(arg, "--lag-limit=", value)) {
+            lag_limit = parseCount(value, 1, "lag limit", 0);
+        } else if (arg == "--bars=off") {
+            bar_history = 0;
+        } else if (option(arg, "--bars=", value)) {
+            bar_history = parseCount(value, 1, "bar history", kDefaultBarHistory);
+        } else if (option(arg, "--resolution=", value)) {
+            setResolution(value);
+        } else if (option(arg, "--window=", value)) {
+            window = parseCount(value, 2, "window size", 20);
+        } else if (arg == "--window-kernels=fixed") {
+            fixed_windows = true;
+        } else if (arg == "--window-kernels=runtime") {
+            fixed_windows = false;
+        } else if (option(arg, "--rsi-period=", value)) {
+            rsi_period = parseCount(value, 1, "RSI period", 14);
+        } else if (arg == "--display=on") {
+            display = true;
+        } else if (arg == "--display=off") {
+            display = false;
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--verbose") {
+            quiet = false;
+        } else if (arg == "--indicator-log=off") {
+            indicator_log_every = 0;
+        } else if (option(arg, "--indicator-log=", value)) {
+            indicator_log_every = static_cast<int>(parseCount(value, 0, "indicator log interval", 20));
+        } else if (arg == "--correlation=off") {
+            correlation_interval_ms = 0;
+        } else if (option(arg, "--correlation=", value)) {
+            correlation_interval_ms = static_cast<int>(parseCount(value, 1, "correlation sample interval", 100));
+        } else if (option(arg, "--correlation-window=", value)) {
+            correlation_window = parseCount(value, 2, "correlation window", 100);
+        } else if (option(arg, "--output=", value)) {
+            output_path = value;
+        } else if (option(arg, "--output-shm=", value)) {
+            output_shm_path = value;
+        } else if (option(arg, "--output-capacity=", value)) {
+            output_queue_capacity = parseCount(value, 1, "output queue capacity", 65536);
+        } else if (option(arg, "--trace=", value)) {
+            trace_path = value;
+        } else if (option(arg, "--checkpoint=", value)) {
+            checkpoint_path = value;
+        } else if (option(arg, "--checkpoint-interval=", value)) {
+            checkpoint_interval_seconds = static_cast<int>(parseCount(value, 1, "checkpoint interval", 5));
+        } else if (arg == "--model=walk") {
+            price_model = PriceModel::RandomWalk;
+        } else if (arg == "--model=gbm") {
+            price_model = PriceModel::Gbm;
+        } else if (option(arg, "--gbm-drift=", value)) {
+            gbm.drift = parseReal(value, -10.0, "GBM drift", 0.05);
+        } else if (option(arg, "--gbm-vol=", value)) {
+            gbm.volatility = parseReal(value, 0.0, "GBM volatility", 0.30);
+        } else if (option(arg, "--gbm-spread=", value)) {
+            gbm.spread = parseReal(value, 0.0, "GBM volatility spread", 0.5);
+            if (gbm.spread > 1.0) gbm.spread = 1.0;
+        } else if (option(arg, "--gbm-tick-seconds=", value)) {
+            gbm.tick_seconds = parseReal(value, 0.0, "GBM tick seconds", 60.0);
+        } else if (option(arg, "--replay=", value)) {
+            replay_path = value;
+        } else if (option(arg, "--replay-speed=", value)) {
+            if (value == "max") {
+                replay_speed = 0.0;
+            } else {
+                try {
+                    replay_speed = std::stod(value);
+                } catch (...) {
+                    std::cerr << "Invalid replay speed. Using 1x.\n";
+                    replay_speed = 1.0;
+                }
+            }
+        } else if (option(arg, "--feed=", value)) {
+            feed_address = value;
+        } else if (option(arg, "--feed-interface=", value)) {
+            feed_interface = value;
+        } else if (option(arg, "--feed-busy-poll=", value)) {
+            feed_busy_poll_us = static_cast<int>(parseCount(value, 0, "feed busy-poll time", 0));
+        } else if (option(arg, "--runtime=", value)) {
+            setRuntime(value);
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option " << arg << " (ignored).\n";
+        } else {
+            setRuntime(arg);
+        }
+    }
+
+private:
+    static bool option(const std::string& arg, const char* prefix, std::string& value) {
+        size_t n = std::char_traits<char>::length(prefix);
+        if (arg.compare(0, n, prefix) != 0) return false;
+        value = arg.substr(n);
+        return true;
+    }
+    
+    static size_t parseCount(const std::string& value, size_t minimum, const char* what, size_t fallback) {
+        try {
+            size_t pos = 0;
+            long long n = std::stoll(value, &pos);
+            if (pos == value.size() && n >= static_cast<long long>(minimum)) {
+                return static_cast<size_t>(n);
+            }
+        } catch (...) {
+        }
+        std::cerr << "Invalid " << what << " '" << value << "'. Using " << fallback << ".\n";
+        return fallback;
+    }
+    
+    static double parseReal(const std::string& value, double minimum, const char* what, double fallback) {
+        try {
+            size_t pos = 0;
+            double x = std::stod(value, &pos);
+            if (pos == value.size() && x >= minimum) return x;
+        } catch (...) {
+        }
+        std::cerr << "Invalid " << what << " '" << value << "'. Using " << fallback << ".\n";
+        return fallback;
+    }
+    
+    void setCpus(ThreadRole role, const std::string& value) {
+        if (!numa::parseCpuList(value, placement[role])) {
+            std::cerr << "Invalid CPU list '" << value << "' for " << threadRoleName(role)
+                      << " (e.g. 0-3,8). Leaving it unpinned.\n";
+            placement[role].clear();
+        }
+    }
+    
+    static bool parsePolicy(const std::string& value, OverloadPolicy& policy) {
+        if (value == "drop" || value == "drop-oldest") {
+            policy = OverloadPolicy::DropOldest;
+        } else if (value == "conflate") {
+            policy = OverloadPolicy::ConflateLatest;
+        } else if (value == "block") {
+            policy = OverloadPolicy::BlockProducer;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    
+    // Comma-separated: POLICY for every indicator, NAME:POLICY for one
+    void setOverload(const std::string& value) {
+        size_t begin = 0;
+        while (begin <= value.size()) {
+            size_t end = value.find(',', begin);
+            if (end == std::string::npos) end = value.size();
+            std::string entry = trim(value.substr(begin, end - begin));
+            size_t colon = entry.find(':');
+            OverloadPolicy policy;
+            if (!parsePolicy(colon == std::string::npos ? entry : entry.substr(colon + 1), policy)) {
+                std::cerr << "Invalid overload policy '" << entry
+                          << "' (drop, conflate or block, optionally NAME:POLICY). Ignored.\n";
+            } else if (colon == std::string::npos) {
+                overload_policy = policy;
+            } else {
+                overload_overrides.emplace_back(entry.substr(0, colon), policy);
+            }
+            begin = end + 1;
+        }
+    }
+    
+    void setResolution(const std::string& value) {
+        for (BarResolution r : {BarResolution::Tick, BarResolution::Second, BarResolution::Minute,
+                                BarResolution::FiveMinutes, BarResolution::Hour}) {
+            if (value == barResolutionName(r)) {
+                resolution = r;
+                return;
+            }
+        }
+        std::cerr << "Invalid resolution '" << value << "' (tick, 1s, 1m, 5m or 1h). Using ticks.\n";
+        resolution = BarResolution::Tick;
+    }
+    
+    void setRuntime(const std::string& value) {
+        try {
+            runtime_seconds = std::stoi(value);
+            if (runtime_seconds < 1 || runtime_seconds > kMaxRuntimeSeconds) {
+                std::cerr << "Runtime must be between 1 and " << kMaxRuntimeSeconds
+                          << " seconds. Using default (30s).\n";
+                runtime_seconds = 30;
+            }
+        } catch (...) {
+            std::cerr << "Invalid runtime argument. Using default (30s).\n";
+        }
+    }
+    
+    // Append arg to args, replacing --config=FILE with the options in FILE
+    static void expand(const std::string& arg, std::vector<std::string>& args, int depth) {
+        if (arg.rfind("--config=", 0) != 0) {
+            args.push_back(arg);
+            return;
+        }
+        std::string path = arg.substr(9);
+        std::ifstream in(path);
+        if (!in || depth > 4) {
+            std::cerr << "Cannot read config file " << path << " (ignored).\n";
+            return;
+        }
+        
+        std::string line;
+        while (std::getline(in, line)) {
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) continue;
+            size_t eq = line.find('=');
+            std::string key = trim(line.substr(0, eq));
+            std::string flag = (eq == std::string::npos) ? "--" + key
+                                                         : "--" + key + "=" + trim(line.substr(eq + 1));
+            expand(flag, args, depth + 1);
+        }
+    }
+    
+    static std::string lower(std::string s) {
+        for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+    
+    static std::string trim(const std::string& s) {
+        size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+};
+
+#endif // SIMULATOR_CONFIG_H
@@ -0,0 +1,135 @@
+#ifndef SYMBOL_REGISTRY_H
+#define SYMBOL_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dense integer handle for a symbol. IDs are assigned 0, 1, 2, ... in
+// registration order, so per-symbol state can live in flat arrays.
+using SymbolId = uint32_t;
+
+constexpr SymbolId kInvalidSymbolId = std::numeric_limits<SymbolId>::max();
+
+// Maps symbol names to dense IDs and back.
+//
+// The registry is filled at startup, before any worker thread starts.
+// It may also reserve spare slots (capacity() > size()): per-symbol
+// storage everywhere is sized by capacity(), so symbols listed at runtime
+// (SharedBuffer::listSymbol) take a free slot with tryIntern() while
+// other threads keep reading. Names and IDs never change once assigned;
+// name(id) and contains(id) need no lock for an ID this thread got from
+// the registry or a SymbolTable snapshot. Names are only needed at the
+// edges (display and reports); the hot path carries SymbolId.
+class SymbolRegistry {
+private:
+    std::vector<std::string> names_;                    // id -> name, capacity() slots
+    std::unordered_map<std::string, SymbolId> ids_;     // name -> id (guarded by mutex_)
+    std::atomic<size_t> size_{0};                       // Slots in use, published after the name
+    mutable std::mutex mutex_;
+
+public:
+    SymbolRegistry() = default;
+    
+    /**
+     * @param capacity Slots to reserve (at least symbols.size())
+     */
+    explicit SymbolRegistry(const std::vector<std::string>& symbols, size_t capacity = 0) {
+        reserve(capacity);
+        for (const auto& symbol : symbols) {
+            intern(symbol);
+        }
+    }
+    
+    SymbolRegistry(SymbolRegistry&& other) noexcept
+        : names_(std::move(other.names_)), ids_(std::move(other.ids_)), size_(other.size_.load()) {}
+    
+    /**
+     * @brief Reserve slots for symbols registered later (startup only)
+     */
+    void reserve(size_t capacity) {
+        if (capacity > names_.size()) names_.resize(capacity);
+    }
+    
+    /**
+     * @brief Register a symbol (startup only: may grow the storage)
+     * @return The symbol's ID; an existing ID if it was already registered
+     */
+    SymbolId intern(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        size_t id = size_.load(std::memory_order_relaxed);
+        if (id == names_.size()) names_.emplace_back();
+        return assignLocked(symbol, id);
+    }
+    
+    /**
+     * @brief Register a symbol in a spare slot (any time, thread-safe)
+     * @return The symbol's ID (existing or new); kInvalidSymbolId if every slot is taken
+     */
+    SymbolId tryIntern(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        size_t id = size_.load(std::memory_order_relaxed);
+        return id < names_.size() ? assignLocked(symbol, id) : kInvalidSymbolId;
+    }
+    
+    /**
+     * @brief Look up a symbol's ID
+     * @return kInvalidSymbolId if the symbol is not registered
+     */
+    SymbolId find(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(symbol);
+        return (it != ids_.end()) ? it->second : kInvalidSymbolId;
+    }
+    
+    const std::string& name(SymbolId id) const {
+        return names_[id];
+    }
+    
+    bool contains(SymbolId id) const {
+        return id < size_.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Symbols registered so far
+     */
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Slots per-symbol storage is sized for (registered + spare)
+     */
+    size_t capacity() const {
+        return names_.size();
+    }
+    
+    /**
+     * @brief Names of every registered symbol, in ID order
+     */
+    std::vector<std::string> names() const {
+        return std::vector<std::string>(names_.begin(), names_.begin() + size());
+    }
+
+private:
+    SymbolId assignLocked(const std::string& symbol, size_t id) {
+        names_[id] = symbol;
+        ids_.emplace(symbol, static_cast<SymbolId>(id));
+        size_.store(id + 1, std::memory_order_release);
+        return static_cast<SymbolId>(id);
+    }
+};
+
+#endif // SYMBOL_REGISTRY_H
@@ -0,0 +1,221 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include "SymbolRegistry.h"
+#include "CacheLine.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// One published version of the listed symbols (immutable once published)
+struct SymbolSnapshot {
+    uint64_t version = 0;
+    std::vector<SymbolId> symbols;      // Listed IDs, ascending
+};
+
+// Which registered symbols are currently listed, published RCU-style.
+//
+// Listing and delisting (rare, any thread) build a new SymbolSnapshot under
+// a mutex and publish it with one pointer store. Consumers read through a
+// Reader: Reader::refresh() is a single acquire load while nothing
+// changed, and the snapshot's vector is used in place, with no copy and
+// no lock, until the next version appears.
+//
+// Retired snapshots are freed after a grace period. Each Reader owns a
+// slot with the version of the oldest snapshot it may still touch; the
+// writer frees a retired version once every slot has moved past it. A
+// Reader therefore never sees its snapshot freed, and one that stops
+// refreshing only delays reclamation.
+class SymbolTable {
+public:
+    static constexpr size_t kMaxReaders = 256;
+
+private:
+    static constexpr uint64_t kFreeSlot = UINT64_MAX;
+    
+    struct alignas(kCacheLineSize) ReaderSlot {
+        std::atomic<uint64_t> version{kFreeSlot};
+    };
+    
+    std::atomic<const SymbolSnapshot*> current_;
+    mutable ReaderSlot slots_[kMaxReaders];     // Claimed by Readers of a const table
+    
+    // Writer side (mutex_)
+    std::mutex mutex_;
+    std::vector<std::atomic<uint8_t>> listed_;                  // Symbol ID -> listed (also read by listed())
+    std::vector<std::unique_ptr<SymbolSnapshot>> published_;    // Oldest first; back() is current
+    uint64_t listings_ = 0;
+    uint64_t delistings_ = 0;
+    
+    // Free retired snapshots no reader can still hold; caller holds mutex_
+    void reclaimLocked() {
+        uint64_t oldest_held = kFreeSlot;
+        for (const ReaderSlot& slot : slots_) {
+            oldest_held = std::min(oldest_held, slot.version.load());
+        }
+        size_t retired = 0;
+        while (retired + 1 < published_.size() && published_[retired]->version < oldest_held) ++retired;
+        published_.erase(published_.begin(), published_.begin() + static_cast<std::ptrdiff_t>(retired));
+    }
+
+public:
+    // A consumer thread's view of the table (one per thread, not shared)
+    class Reader {
+    private:
+        const SymbolTable& table_;
+        std::atomic<uint64_t>* slot_ = nullptr;
+        const SymbolSnapshot* snapshot_ = nullptr;
+    
+    public:
+        /**
+         * @throws std::length_error if kMaxReaders readers already exist
+         */
+        explicit Reader(const SymbolTable& table) : table_(table) {
+            for (ReaderSlot& slot : table.slots_) {
+                // Holding version 0 pins every snapshot until the first refresh()
+                uint64_t free = kFreeSlot;
+                if (slot.version.compare_exchange_strong(free, 0)) {
+                    slot_ = &slot.version;
+                    break;
+                }
+            }
+            if (!slot_) throw std::length_error("SymbolTable: too many readers");
+            refresh();
+        }
+        
+        ~Reader() { slot_->store(kFreeSlot); }
+        
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        
+        /**
+         * @brief Move to the latest version
+         * @return true if it changed (snapshot() now differs)
+         */
+        bool refresh() {
+            const SymbolSnapshot* latest = table_.current_.load(std::memory_order_acquire);
+            if (latest == snapshot_) return false;
+            snapshot_ = latest;
+            slot_->store(latest->version);  // Done with every older version
+            return true;
+        }
+        
+        const SymbolSnapshot& snapshot() const { return *snapshot_; }
+        const std::vector<SymbolId>& symbols() const { return snapshot_->symbols; }
+        uint64_t version() const { return snapshot_->version; }
+    };
+    
+    /**
+     * @param capacity Symbol IDs the table can list (the registry's capacity)
+     * @param listed Symbols listed initially
+     */
+    SymbolTable(size_t capacity, const std::vector<SymbolId>& listed) : listed_(capacity) {
+        auto first = std::make_unique<SymbolSnapshot>();
+        for (auto& flag : listed_) flag.store(0, std::memory_order_relaxed);
+        for (SymbolId id : listed) {
+            if (id < capacity) listed_[id].store(1, std::memory_order_relaxed);
+        }
+        for (size_t id = 0; id < capacity; ++id) {
+            if (listed_[id].load(std::memory_order_relaxed)) first->symbols.push_back(static_cast<SymbolId>(id));
+        }
+        first->version = 1;
+        current_.store(first.get(), std::memory_order_release);
+        published_.push_back(std::move(first));
+    }
+    
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+    
+    /**
+     * @brief List and delist symbols, published as one new version
+     *
+     * IDs already in the requested state (or out of range) are ignored;
+     * nothing is published if nothing changed.
+     * @return Symbols whose state changed
+     */
+    size_t update(const std::vector<SymbolId>& list, const std::vector<SymbolId>& delist) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t changed = 0;
+        for (SymbolId id : delist) {
+            if (id < listed_.size() && listed_[id].load(std::memory_order_relaxed)) {
+                listed_[id].store(0, std::memory_order_relaxed);
+                ++delistings_;
+                ++changed;
+            }
+        }
+        for (SymbolId id : list) {
+            if (id < listed_.size() && !listed_[id].load(std::memory_order_relaxed)) {
+                listed_[id].store(1, std::memory_order_relaxed);
+                ++listings_;
+                ++changed;
+            }
+        }
+        if (changed == 0) return 0;
+        
+        // Merge the changes into the current list (O(listed + changes))
+        const SymbolSnapshot& current = *published_.back();
+        auto next = std::make_unique<SymbolSnapshot>();
+        next->version = current.version + 1;
+        next->symbols.reserve(current.symbols.size() + list.size());
+        std::vector<SymbolId> added;
+        for (SymbolId id : list) {
+            if (id < listed_.size() && listed_[id].load(std::memory_order_relaxed)) added.push_back(id);
+        }
+        std::sort(added.begin(), added.end());
+        added.erase(std::unique(added.begin(), added.end()), added.end());
+        size_t a = 0;
+        for (SymbolId id : current.symbols) {
+            while (a < added.size() && added[a] < id) next->symbols.push_back(added[a++]);
+            if (a < added.size() && added[a] == id) ++a;    // Was listed already
+            if (listed_[id].load(std::memory_order_relaxed)) next->symbols.push_back(id);
+        }
+        while (a < added.size()) next->symbols.push_back(added[a++]);
+        
+        current_.store(next.get());
+        published_.push_back(std::move(next));
+        reclaimLocked();
+        return changed;
+    }
+    
+    /**
+     * @brief Whether symbol id is listed now (any thread, no lock: for
+     *        producers checking each tick; a change racing the call may
+     *        go either way)
+     */
+    bool listed(SymbolId id) const {
+        return id < listed_.size() && listed_[id].load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief A copy of the current list (for callers without a Reader)
+     */
+    std::vector<SymbolId> listedSymbols() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return published_.back()->symbols;
+    }
+    
+    struct Stats {
+        uint64_t version = 0;
+        size_t listed = 0;
+        uint64_t listings = 0;          // Since the table was built (initial symbols not counted)
+        uint64_t delistings = 0;
+        size_t unreclaimed = 0;         // Retired versions a reader may still hold
+    };
+    
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats stats;
+        stats.version = published_.back()->version;
+        stats.listed = published_.back()->symbols.size();
+        stats.listings = listings_;
+        stats.delistings = delistings_;
+        stats.unreclaimed = published_.size() - 1;
+        return stats;
+    }
+};
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,320 @@
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// CPU-affinity pinning per thread role, and NUMA-local history storage.
+//
+// A PlacementPlan lists the CPUs each role may run on (empty: not pinned).
+// Every long-running thread calls ThreadPlacement::pinCurrentThread() with
+// its role as its first action; threads of one role take the role's CPUs
+// in turn and each logs the CPU (and NUMA node) it ends up on. When a
+// producer thread is pinned, its symbols' ring storage is bound to the
+// producer's node (bindMemoryToNode(), i.e. mbind), so ticks are written
+// and, with indicators pinned to the same node, read without crossing the
+// socket interconnect.
+//
+// Call ThreadPlacement::configure() once, before any thread starts; the
+// plan is read-only afterwards (the same rule as CycleClock::init()).
+// Pinning and binding are Linux-only; elsewhere the calls log and do nothing.
+
+enum class ThreadRole {
+    Producer,       // PriceGenerator shards, TickReplayer
+    Indicator,      // Indicator calculators, scheduler and executor workers
+    Display,        // DisplayThread
+    Background      // Console writer, checkpointer
+};
+
+constexpr size_t kThreadRoleCount = 4;
+
+inline const char* threadRoleName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Producer: return "producer";
+        case ThreadRole::Indicator: return "indicators";
+        case ThreadRole::Display: return "display";
+        case ThreadRole::Background: return "background";
+    }
+    return "?";
+}
+
+namespace numa {
+
+inline std::string readLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+/**
+ * @brief Parse a kernel-style CPU list ("0-3,8,10-11")
+ * @return false (cpus untouched) on a malformed list
+ */
+inline bool parseCpuList(const std::string& list, std::vector<int>& cpus) {
+    std::vector<int> parsed;
+    std::stringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        try {
+            size_t pos = 0;
+            int first = std::stoi(range.substr(0, dash), &pos);
+            if (pos != (dash == std::string::npos ? range.size() : dash)) return false;
+            int last = first;
+            if (dash != std::string::npos) {
+                last = std::stoi(range.substr(dash + 1), &pos);
+                if (pos != range.size() - dash - 1) return false;
+            }
+            if (first < 0 || last < first) return false;
+            for (int cpu = first; cpu <= last; ++cpu) parsed.push_back(cpu);
+        } catch (...) {
+            return false;
+        }
+    }
+    if (parsed.empty()) return false;
+    cpus = parsed;
+    return true;
+}
+
+inline std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i) out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+// CPU the calling thread is running on (-1 if unknown)
+inline int currentCpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// NUMA node of cpu (-1 if the system does not report one)
+inline int nodeOfCpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return -1;
+    for (int node = 0; node < 1024; ++node) {
+        std::vector<int> cpus;
+        if (!parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"), cpus)) {
+            break;                      // Past the last node (or no NUMA information at all)
+        }
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) return node;
+    }
+#endif
+    (void)cpu;
+    return -1;
+}
+
+// CPUs of a NUMA node (empty if unknown)
+inline std::vector<int> nodeCpus(int node) {
+    std::vector<int> cpus;
+    if (node >= 0) {
+        parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"), cpus);
+    }
+    return cpus;
+}
+
+// CPUs this process may run on
+inline std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+/**
+ * @brief Prefer node for [data, data + bytes), moving pages already placed elsewhere
+ *
+ * The range is widened to whole pages: neighbouring data on a shared page
+ * moves with it. Returns false (errno-style reason in error) where mbind is
+ * unavailable or refused, e.g. in containers without the capability.
+ */
+inline bool bindMemoryToNode(void* data, size_t bytes, int node, std::string& error) {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (node < 0 || node >= 1024 || bytes == 0) {
+        error = "no node";
+        return false;
+    }
+    constexpr int kMpolPreferred = 1;       // <numaif.h> values; no libnuma needed
+    constexpr unsigned kMpolMfMove = 1u << 1;
+    
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes + page - 1) & ~(page - 1);
+    
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, mask, 8 * sizeof(mask) + 1, kMpolMfMove) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    (void)data; (void)bytes; (void)node;
+    error = "not supported on this platform";
+    return false;
+#endif
+}
+
+}  // namespace numa
+
+// Which CPUs each role runs on
+struct PlacementPlan {
+    std::vector<int> cpus[kThreadRoleCount];    // Empty: role not pinned
+    bool bind_history = true;                   // Bind pinned producers' ring storage to their node
+    
+    std::vector<int>& operator[](ThreadRole role) { return cpus[static_cast<size_t>(role)]; }
+    const std::vector<int>& operator[](ThreadRole role) const { return cpus[static_cast<size_t>(role)]; }
+    
+    bool pinsAnything() const {
+        for (const auto& c : cpus) {
+            if (!c.empty()) return true;
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Keep every role on the NUMA node the caller is running on
+     *
+     * The node's CPUs (those this process may use) go first to the
+     * producer shards, one each, then one to display and background
+     * threads, and the rest to indicators. With too few CPUs the roles
+     * share them.
+     */
+    static PlacementPlan automatic(size_t producer_count) {
+        std::vector<int> allowed = numa::allowedCpus();
+        std::vector<int> local;
+        for (int cpu : numa::nodeCpus(numa::nodeOfCpu(numa::currentCpu()))) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) local.push_back(cpu);
+        }
+        if (local.empty()) local = allowed;
+        
+        PlacementPlan plan;
+        if (local.empty()) return plan;     // No affinity support: leave everything unpinned
+        
+        size_t producers = std::min(std::max<size_t>(producer_count, 1), local.size());
+        plan[ThreadRole::Producer].assign(local.begin(), local.begin() + producers);
+        
+        std::vector<int> rest(local.begin() + producers, local.end());
+        if (rest.empty()) rest = local;
+        plan[ThreadRole::Display] = {rest.back()};
+        plan[ThreadRole::Background] = {rest.back()};
+        if (rest.size() > 1) rest.pop_back();
+        plan[ThreadRole::Indicator] = rest;
+        return plan;
+    }
+};
+
+namespace placement_detail {
+
+// Written by ThreadPlacement::configure() only; read-only afterwards
+inline PlacementPlan g_plan;
+inline std::atomic<size_t> g_next[kThreadRoleCount];    // Next CPU index per role
+
+}  // namespace placement_detail
+
+class ThreadPlacement {
+public:
+    static void configure(const PlacementPlan& plan) {
+        placement_detail::g_plan = plan;
+        for (auto& next : placement_detail::g_next) next.store(0, std::memory_order_relaxed);
+    }
+    
+    static const PlacementPlan& plan() { return placement_detail::g_plan; }
+    
+    static bool bindsHistory(int cpu) { return cpu >= 0 && plan().bind_history; }
+    
+    /**
+     * @brief Pin the calling thread to the next CPU of its role and log where it runs
+     * @param label Thread name for the log line (e.g. "PriceGenerator shard 0")
+     * @return The CPU pinned to, or -1 if the role is not pinned (or pinning failed)
+     */
+    static int pinCurrentThread(ThreadRole role, const std::string& label) {
+        trace::nameThread(label);       // Every long-running thread starts here
+        const std::vector<int>& cpus = plan()[role];
+        int pinned = -1;
+        std::string note = "unpinned";
+        
+        if (!cpus.empty()) {
+            size_t index = placement_detail::g_next[static_cast<size_t>(role)].fetch_add(1);
+            int cpu = cpus[index % cpus.size()];
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (rc == 0) {
+                pinned = cpu;
+                note = "pinned";
+                sched_yield();  // Let the scheduler move us before reporting the CPU
+            } else {
+                note = "pin to CPU " + std::to_string(cpu) + " failed: " + std::strerror(rc);
+            }
+#else
+            note = "pinning not supported";
+#endif
+        }
+        
+        int cpu = numa::currentCpu();
+        int node = numa::nodeOfCpu(cpu);
+        std::ostringstream line;
+        line << "[ThreadPlacement] " << label << " (" << threadRoleName(role) << "): CPU " << cpu
+             << ", node " << (node >= 0 ? std::to_string(node) : "?") << ", " << note << "\n";
+        std::cout << line.str();        // One write, so concurrent starts don't interleave
+        return pinned;
+    }
+    
+    // One line describing the plan (for startup logs)
+    static std::string describe() {
+        const PlacementPlan& p = plan();
+        if (!p.pinsAnything()) return "unpinned";
+        std::string out;
+        for (size_t r = 0; r < kThreadRoleCount; ++r) {
+            if (p.cpus[r].empty()) continue;
+            if (!out.empty()) out += ", ";
+            out += std::string(threadRoleName(static_cast<ThreadRole>(r))) + " CPUs " +
+                   numa::formatCpuList(p.cpus[r]);
+        }
+        if (!p[ThreadRole::Producer].empty()) {
+            out += p.bind_history ? "; history bound to producer nodes" : "; history not bound";
+        }
+        return out;
+    }
+};
+
+#endif // THREAD_PLACEMENT_H
@@ -0,0 +1,62 @@
+#ifndef TICK_ARENA_H
+#define TICK_ARENA_H
+
+#include "AlignedArray.h"
+#include "ThreadPlacement.h"
+#include <cstddef>
+#include <string>
+
+// One preallocated block holding the tick storage of every symbol's ring.
+//
+// SharedBuffer sizes it once from max_history_size_ and hands each PriceRing
+// a fixed slice, so all history storage is a single allocation made up
+// front: pushes and reads never touch the heap, and a symbol's columns sit
+// next to each other instead of wherever the allocator put them.
+//
+// The block starts on a page boundary so ranges of slices can be bound to a
+// NUMA node (bindSlices()) without touching memory outside it.
+class TickArena {
+private:
+    size_t slice_bytes_;                    // Rounded up to a cache line
+    size_t slices_;
+    static constexpr size_t kPageAlignment = 4096;
+    AlignedArray<std::byte, kPageAlignment> storage_;   // Zero-initialized
+    
+    static size_t roundUpLine(size_t n) {
+        return (n + 63) & ~static_cast<size_t>(63);
+    }
+
+public:
+    /**
+     * @param slices Number of slices (one per symbol)
+     * @param slice_bytes Bytes each slice must hold
+     */
+    TickArena(size_t slices, size_t slice_bytes)
+        : slice_bytes_(roundUpLine(slice_bytes)), slices_(slices),
+          storage_(slices_ * slice_bytes_) {}
+    
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+    
+    /**
+     * @brief Start of slice i (64-byte aligned, slice_bytes long)
+     */
+    std::byte* slice(size_t i) { return storage_.data() + i * slice_bytes_; }
+    
+    /**
+     * @brief Move slices [first, first + count) to NUMA node (see numa::bindMemoryToNode)
+     */
+    bool bindSlices(size_t first, size_t count, int node, std::string& error) {
+        if (first + count > slices_ || count == 0) {
+            error = "slice range out of bounds";
+            return false;
+        }
+        return numa::bindMemoryToNode(slice(first), count * slice_bytes_, node, error);
+    }
+    
+    size_t sliceBytes() const { return slice_bytes_; }
+    size_t sliceCount() const { return slices_; }
+    size_t bytes() const { return storage_.size(); }
+};
+
+#endif // TICK_ARENA_H
@@ -0,0 +1,208 @@
+#ifndef TICK_FILE_H
+#define TICK_FILE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary tick file format (native byte order, little-endian on every
+// platform we build for):
+//
+//   TickFileHeader                         32 bytes
+//   symbol table                           symbol_count x kTickFileNameBytes
+//                                          (NUL-padded names; file symbol id = index)
+//   padding up to records_offset
+//   TickFileRecord[record_count]           24 bytes each, ordered by exchange_time_ns
+//
+// Records are fixed-width so a mapped file is just an array to walk.
+
+constexpr char kTickFileMagic[8] = {'S', 'T', 'K', 'T', 'I', 'C', 'K', '1'};
+constexpr uint32_t kTickFileVersion = 1;
+constexpr size_t kTickFileNameBytes = 16;
+
+struct TickFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t symbol_count;
+    uint64_t record_count;
+    uint64_t records_offset;    // Byte offset of the first record (8-byte aligned)
+};
+
+struct TickFileRecord {
+    uint32_t symbol;            // Index into the file's symbol table
+    uint32_t size;              // Traded quantity
+    double price;
+    int64_t exchange_time_ns;   // Exchange timestamp, nanoseconds since any fixed epoch
+};
+
+static_assert(sizeof(TickFileHeader) == 32, "tick file header layout");
+static_assert(sizeof(TickFileRecord) == 24, "tick file record layout");
+
+// Read-only memory mapping of a tick file.
+//
+// The records are never copied: records() points into the mapping and the
+// kernel pages the file in as the replay walks it (MADV_SEQUENTIAL). Only
+// the header and symbol table are validated up front; record symbol ids are
+// checked by the reader so opening a large file does not touch every page.
+class MappedTickFile {
+private:
+    std::string path_;
+    void* base_;
+    size_t length_;
+    std::vector<std::string> symbols_;
+    const TickFileRecord* records_;
+    size_t record_count_;
+    
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("tick file " + path_ + ": " + what);
+    }
+
+public:
+    /**
+     * @brief Map and validate a tick file
+     * @throws std::runtime_error if the file cannot be mapped or is malformed
+     */
+    explicit MappedTickFile(const std::string& path)
+        : path_(path), base_(nullptr), length_(0), records_(nullptr), record_count_(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(std::strerror(errno));
+        
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(std::strerror(errno));
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        if (length_ < sizeof(TickFileHeader)) {
+            ::close(fd);
+            fail("too small for a header");
+        }
+        
+        base_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file referenced
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            fail(std::strerror(errno));
+        }
+        ::madvise(base_, length_, MADV_SEQUENTIAL);
+        
+        try {
+            parse();
+        } catch (...) {
+            ::munmap(base_, length_);
+            throw;
+        }
+    }
+    
+    ~MappedTickFile() {
+        if (base_) ::munmap(base_, length_);
+    }
+    
+    MappedTickFile(const MappedTickFile&) = delete;
+    MappedTickFile& operator=(const MappedTickFile&) = delete;
+    
+    const std::string& path() const { return path_; }
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const TickFileRecord* records() const { return records_; }
+    size_t size() const { return record_count_; }
+    
+    const TickFileRecord& operator[](size_t i) const { return records_[i]; }
+
+private:
+    void parse() {
+        const char* bytes = static_cast<const char*>(base_);
+        TickFileHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        
+        if (std::memcmp(header.magic, kTickFileMagic, sizeof(kTickFileMagic)) != 0) {
+            fail("bad magic (not a tick file)");
+        }
+        if (header.version != kTickFileVersion) {
+            fail("unsupported version " + std::to_string(header.version));
+        }
+        
+        uint64_t table_end = sizeof(TickFileHeader) + uint64_t(header.symbol_count) * kTickFileNameBytes;
+        if (header.records_offset < table_end || header.records_offset % 8 != 0 ||
+            header.records_offset > length_) {
+            fail("bad records offset");
+        }
+        if (header.record_count > (length_ - header.records_offset) / sizeof(TickFileRecord)) {
+            fail("truncated (header says " + std::to_string(header.record_count) + " records)");
+        }
+        
+        for (uint32_t i = 0; i < header.symbol_count; ++i) {
+            const char* name = bytes + sizeof(TickFileHeader) + i * kTickFileNameBytes;
+            symbols_.emplace_back(name, strnlen(name, kTickFileNameBytes));
+        }
+        
+        records_ = reinterpret_cast<const TickFileRecord*>(bytes + header.records_offset);
+        record_count_ = static_cast<size_t>(header.record_count);
+    }
+};
+
+// Streams records into a new tick file (e.g. to capture a feed for replay).
+class TickFileWriter {
+private:
+    std::ofstream out_;
+    TickFileHeader header_;
+
+public:
+    /**
+     * @param symbols File symbol table; record symbol ids index into it
+     * @throws std::runtime_error if the file cannot be created or a name is too long
+     */
+    TickFileWriter(const std::string& path, const std::vector<std::string>& symbols)
+        : out_(path, std::ios::binary | std::ios::trunc) {
+        if (!out_) throw std::runtime_error("tick file " + path + ": cannot create");
+        
+        std::memcpy(header_.magic, kTickFileMagic, sizeof(kTickFileMagic));
+        header_.version = kTickFileVersion;
+        header_.symbol_count = static_cast<uint32_t>(symbols.size());
+        header_.record_count = 0;
+        uint64_t table_end = sizeof(TickFileHeader) + symbols.size() * kTickFileNameBytes;
+        header_.records_offset = (table_end + 7) & ~uint64_t(7);
+        
+        out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        for (const auto& symbol : symbols) {
+            if (symbol.size() >= kTickFileNameBytes) {
+                throw std::runtime_error("tick file " + path + ": symbol name too long: " + symbol);
+            }
+            char name[kTickFileNameBytes] = {};
+            std::memcpy(name, symbol.data(), symbol.size());
+            out_.write(name, sizeof(name));
+        }
+        for (uint64_t pad = table_end; pad < header_.records_offset; ++pad) {
+            out_.put('\0');
+        }
+    }
+    
+    ~TickFileWriter() {
+        close();
+    }
+    
+    void append(const TickFileRecord& record) {
+        out_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        ++header_.record_count;
+    }
+    
+    /**
+     * @brief Patch the record count into the header and close the file
+     */
+    void close() {
+        if (!out_.is_open()) return;
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        out_.close();
+    }
+};
+
+#endif // TICK_FILE_H
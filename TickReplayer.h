@@ -0,0 +1,209 @@
+#ifndef TICK_REPLAYER_H
+#define TICK_REPLAYER_H
+
+#include "PriceData.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "TickFile.h"
+#include "TickSource.h"
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// Replays a recorded tick file into the shared buffer.
+//
+// Pacing follows the file's exchange timestamps: speed 1 replays at the
+// recorded rate, speed N at N times that rate, and speed 0 publishes as
+// fast as the pipeline accepts ticks (for reproducible throughput runs).
+// Each published tick is stamped with the local time it was published, so
+// PerformanceMonitor latencies measure our pipeline, not the recording.
+//
+// Only listed symbols are replayed: the thread checks its
+// SymbolTable::Reader once per batch and skips records for delisted ones,
+// so a delisting takes effect from the next batch.
+//
+// A single replay thread is the only writer of every ring it feeds.
+class TickReplayer : public TickSource {
+private:
+    // Largest number of ticks published with one pushBatch()
+    static constexpr size_t kMaxBatch = 512;
+    
+    SharedBuffer& buffer_;                      // Reference to shared buffer (synchronization point)
+    PerformanceMonitor& perf_monitor_;         // Performance tracking
+    const MappedTickFile& file_;
+    double speed_;                              // Replay speed multiplier (0 = as fast as possible)
+    
+    std::vector<SymbolId> symbol_map_;          // File symbol index -> registry ID
+    std::vector<double> last_prices_;           // File symbol index -> previous price (for change)
+    std::vector<uint8_t> listed_;               // Registry ID -> listed, as of the last refresh
+    std::vector<PriceData> batch_;              // Ticks published together, reused
+    
+    std::atomic<bool> running_;                 // Thread-safe flag for shutdown
+    std::atomic<bool> finished_;                // Reached the end of the file
+    std::thread thread_;                        // Worker thread
+    
+    // Sleep until the given time, waking periodically to honor stop()
+    void sleepUntil(std::chrono::steady_clock::time_point due) {
+        const auto slice = std::chrono::milliseconds(100);
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= due || !running_.load()) return;
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - now, slice));
+        }
+    }
+
+public:
+    /**
+     * @param file Mapped tick file; must outlive the replayer
+     * @param speed 1 = recorded pace, N = N x faster, 0 = maximum speed
+     *
+     * File symbols are matched to the buffer's registry by name; records for
+     * symbols the registry does not know, or that are not listed, are skipped.
+     */
+    TickReplayer(SharedBuffer& buffer,
+                 PerformanceMonitor& perf_monitor,
+                 const MappedTickFile& file,
+                 double speed = 1.0)
+        : buffer_(buffer), perf_monitor_(perf_monitor), file_(file),
+          speed_(speed > 0.0 ? speed : 0.0),
+          last_prices_(file.symbols().size(), 0.0), listed_(buffer.registry().capacity(), 0),
+          running_(false), finished_(false)
+    {
+        for (const auto& name : file.symbols()) {
+            symbol_map_.push_back(buffer_.registry().find(name));
+        }
+        batch_.reserve(kMaxBatch);
+    }
+    
+    ~TickReplayer() override {
+        stop();
+    }
+    
+    void start() override {
+        bool expected = false;
+        if (running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread(&TickReplayer::run, this);
+            std::cout << "[TickReplayer] Started replay thread (ID: " << thread_.get_id()
+                      << ") for " << file_.path() << " (" << file_.size() << " ticks, ";
+            if (speed_ > 0.0) {
+                std::cout << speed_ << "x speed)\n";
+            } else {
+                std::cout << "max speed)\n";
+            }
+        }
+    }
+    
+    void stop() override {
+        if (running_.exchange(false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            std::cout << "[TickReplayer] Replay thread stopped\n";
+        }
+    }
+    
+    bool finished() const override {
+        return finished_.load();
+    }
+
+private:
+    void syncListed(const std::vector<SymbolId>& listed) {
+        std::fill(listed_.begin(), listed_.end(), 0);
+        for (SymbolId id : listed) {
+            if (id < listed_.size()) listed_[id] = 1;
+        }
+    }
+    
+    void run() {
+        std::vector<SymbolId> symbols;
+        for (SymbolId id : symbol_map_) {
+            if (id != kInvalidSymbolId) symbols.push_back(id);
+        }
+        std::sort(symbols.begin(), symbols.end());
+        placeProducerThread(buffer_, symbols, "TickReplayer");
+        SymbolTable::Reader listed(buffer_.symbolTable());
+        syncListed(listed.symbols());
+        std::cout << "[TickReplayer] Replay loop starting...\n";
+        
+        const TickFileRecord* records = file_.records();
+        const size_t count = file_.size();
+        const bool paced = speed_ > 0.0;
+        
+        size_t next = 0;
+        size_t published = 0;
+        size_t skipped = 0;
+        size_t batches = 0;
+        const size_t progress_step = count / 10 > 0 ? count / 10 : 1;
+        size_t next_progress = progress_step;
+        
+        const int64_t first_ts = count > 0 ? records[0].exchange_time_ns : 0;
+        const auto wall_start = std::chrono::steady_clock::now();
+        
+        while (running_.load() && next < count) {
+            // Recorded timestamp reached so far, in file time
+            int64_t until_ts = records[next].exchange_time_ns;
+            if (paced) {
+                auto offset = std::chrono::nanoseconds(
+                    static_cast<int64_t>((until_ts - first_ts) / speed_));
+                sleepUntil(wall_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset));
+                if (!running_.load()) break;
+                
+                // If we fell behind, everything already due goes out in this batch
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - wall_start).count();
+                int64_t now_ts = first_ts + static_cast<int64_t>(elapsed * speed_);
+                if (now_ts > until_ts) until_ts = now_ts;
+            }
+            
+            if (listed.refresh()) syncListed(listed.symbols());
+            batch_.clear();
+            const auto stamp = TickClock::now();    // One clock read per batch
+            while (next < count && batch_.size() < kMaxBatch &&
+                   (!paced || records[next].exchange_time_ns <= until_ts)) {
+                const TickFileRecord& record = records[next++];
+                if (record.symbol >= symbol_map_.size() || symbol_map_[record.symbol] == kInvalidSymbolId ||
+                    !listed_[symbol_map_[record.symbol]]) {
+                    ++skipped;      // Unknown or delisted symbol
+                    continue;
+                }
+                double& last = last_prices_[record.symbol];
+                double change = (last > 0.0) ? record.price - last : 0.0;
+                last = record.price;
+                batch_.emplace_back(symbol_map_[record.symbol], record.price, change,
+                                    static_cast<double>(record.size), stamp);
+            }
+            
+            if (!batch_.empty()) {
+                buffer_.pushBatch(batch_);
+                perf_monitor_.recordGenerationBatch(batch_);
+                published += batch_.size();
+                ++batches;
+            }
+            
+            if (next >= next_progress && next < count) {
+                std::cout << "[TickReplayer] " << (next * 100 / count) << "% replayed ("
+                          << published << " ticks)\n";
+                while (next_progress <= next) next_progress += progress_step;
+            }
+        }
+        
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        if (next >= count) {
+            finished_.store(true);
+        }
+        
+        std::cout << "[TickReplayer] Replay loop exited after " << published << " ticks in "
+                  << batches << " batches (" << skipped << " skipped), "
+                  << std::fixed << std::setprecision(3) << seconds << " s";
+        if (seconds > 0.0) {
+            std::cout << ", " << std::setprecision(0) << (published / seconds) << " ticks/sec";
+        }
+        std::cout << "\n";
+    }
+};
+
+#endif // TICK_REPLAYER_H
@@ -0,0 +1,54 @@
+#ifndef TICK_SOURCE_H
+#define TICK_SOURCE_H
+
+#include "SharedBuffer.h"
+#include "ThreadPlacement.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Anything that feeds ticks into the SharedBuffer from its own thread(s):
+// the random-walk PriceGenerator or a TickReplayer reading a recorded file.
+// main() drives the source only through this interface.
+class TickSource {
+public:
+    virtual ~TickSource() = default;
+    
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    
+    /**
+     * @brief True once the source has nothing more to publish
+     *
+     * Generators never finish; a replay finishes at the end of its file.
+     */
+    virtual bool finished() const { return false; }
+
+protected:
+    /**
+     * @brief Pin the calling producer thread and bind its symbols' history to its node
+     *
+     * Call first thing on each producer thread (see ThreadPlacement.h).
+     */
+    static void placeProducerThread(SharedBuffer& buffer, const std::vector<SymbolId>& symbols,
+                                    const std::string& label) {
+        int cpu = ThreadPlacement::pinCurrentThread(ThreadRole::Producer, label);
+        if (!ThreadPlacement::bindsHistory(cpu)) return;
+        
+        int node = numa::nodeOfCpu(cpu);
+        if (node < 0) return;       // No NUMA topology: nothing to bind to
+        std::string error;
+        size_t bytes = buffer.bindHistory(symbols, node, error);
+        std::ostringstream line;
+        line << "[ThreadPlacement] " << label << ": ";
+        if (bytes > 0) {
+            line << "history of " << symbols.size() << " symbols (" << bytes / 1024 << " KB) bound to node " << node;
+        } else {
+            line << "history not bound to node " << node << " (" << error << ")";
+        }
+        std::cout << line.str() << "\n";
+    }
+};
+
+#endif // TICK_SOURCE_H
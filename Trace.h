@@ -0,0 +1,217 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "Clock.h"
+#include "CacheLine.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped trace spans on the pipeline's hot paths, exported as Chrome trace
+// JSON (chrome://tracing, or drag into ui.perfetto.dev).
+//
+//   void push(...) {
+//       TRACE_SPAN("push");     // Records [construction, end of scope)
+//       ...
+//   }
+//
+// Configure with -DSTOCK_SIMULATOR_TRACING=ON to compile the spans in; without
+// it TRACE_SPAN expands to nothing and the functions below do nothing, so
+// production builds pay no cost at all. Compiled in, spans still cost only
+// a relaxed load until trace::start() (main.cpp: --trace=FILE).
+//
+// Each thread writes its spans to its own fixed ring (registered on the
+// thread's first span, never freed), so recording is two clock reads and
+// a few stores with no lock or shared cache line. When a ring is full the
+// oldest spans are overwritten: a trace holds the last kRingEvents spans of
+// every thread. writeChromeTrace() may run while threads keep recording;
+// spans overwritten during the copy are detected and left out.
+namespace trace {
+
+#ifdef STOCK_SIMULATOR_TRACING
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+constexpr size_t kRingEvents = size_t(1) << 15;    // Per thread (24 bytes each)
+
+struct Event {
+    const char* name;           // String literal
+    int64_t start_ns;           // TickClock
+    int64_t duration_ns;
+};
+
+struct ThreadRing {
+    alignas(kCacheLineSize) std::atomic<uint64_t> head{0};     // Spans ever recorded
+    Event events[kRingEvents];
+    
+    // Written under detail::g_mutex
+    std::string name;
+    uint32_t id = 0;
+};
+
+namespace detail {
+
+inline std::atomic<bool> g_active{false};
+inline int64_t g_origin_ns = 0;                 // Written by start() before any span
+inline std::mutex g_mutex;                      // Guards g_rings and ring names
+inline std::vector<std::unique_ptr<ThreadRing>> g_rings;
+
+inline ThreadRing* registerRing() {
+    auto ring = std::make_unique<ThreadRing>();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    ring->id = static_cast<uint32_t>(g_rings.size() + 1);
+    ring->name = "thread " + std::to_string(ring->id);
+    g_rings.push_back(std::move(ring));
+    return g_rings.back().get();
+}
+
+inline ThreadRing& currentRing() {
+    thread_local ThreadRing* ring = registerRing();
+    return *ring;
+}
+
+inline void escape(std::FILE* out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') std::fputc('\\', out);
+        if (static_cast<unsigned char>(c) >= 0x20) std::fputc(c, out);
+    }
+}
+
+}  // namespace detail
+
+inline bool active() {
+    return kEnabled && detail::g_active.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start recording (call before the threads to trace start)
+ * @return false if tracing is compiled out
+ */
+inline bool start() {
+    if (!kEnabled) return false;
+    detail::g_origin_ns = TickClock::now().time_since_epoch().count();
+    detail::g_active.store(true, std::memory_order_release);
+    return true;
+}
+
+inline void stop() { detail::g_active.store(false, std::memory_order_release); }
+
+/**
+ * @brief Name the calling thread in the trace (ThreadPlacement::pinCurrentThread calls this)
+ */
+inline void nameThread(const std::string& name) {
+    if (!active()) return;
+    ThreadRing& ring = detail::currentRing();
+    std::lock_guard<std::mutex> lock(detail::g_mutex);
+    ring.name = name;
+}
+
+inline void record(const char* name, int64_t start_ns, int64_t end_ns) {
+    ThreadRing& ring = detail::currentRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    ring.events[head & (kRingEvents - 1)] = Event{name, start_ns, end_ns - start_ns};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+// Records its lifetime as one span (see TRACE_SPAN)
+class Span {
+private:
+    const char* name_;
+    int64_t start_ns_;
+
+public:
+    explicit Span(const char* name)
+        : name_(active() ? name : nullptr),
+          start_ns_(name_ ? TickClock::now().time_since_epoch().count() : 0) {}
+    
+    ~Span() {
+        if (name_) record(name_, start_ns_, TickClock::now().time_since_epoch().count());
+    }
+    
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+};
+
+struct ExportStats {
+    size_t threads = 0;
+    uint64_t spans = 0;             // Written to the file
+    uint64_t overwritten = 0;       // Recorded but no longer in the rings
+};
+
+/**
+ * @brief Write every thread's recorded spans as Chrome trace JSON
+ *
+ * Safe while threads are recording (e.g. on a signal); timestamps are
+ * microseconds since start().
+ * @return false (reason in error) if tracing is compiled out or the file
+ *         cannot be written
+ */
+inline bool writeChromeTrace(const std::string& path, ExportStats& stats, std::string& error) {
+    stats = ExportStats();
+    if (!kEnabled) {
+        error = "built without STOCK_SIMULATOR_TRACING";
+        return false;
+    }
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        error = std::strerror(errno);
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(detail::g_mutex);
+    std::vector<Event> copy;
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", out);
+    std::fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"stock_simulator\"}}", out);
+    for (const auto& ring : detail::g_rings) {
+        std::fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                     ring->id);
+        detail::escape(out, ring->name);
+        std::fputs("\"}}", out);
+        
+        // Copy the ring, then drop whatever the writer lapped meanwhile
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > kRingEvents ? head - kRingEvents : 0;
+        copy.assign(ring->events, ring->events + kRingEvents);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t now = ring->head.load(std::memory_order_relaxed);
+        uint64_t intact = now >= kRingEvents ? now - kRingEvents + 1 : 0;   // Slot of `now` may be mid-write
+        if (intact > first) first = intact < head ? intact : head;
+        stats.overwritten += first;
+        
+        for (uint64_t seq = first; seq < head; ++seq) {
+            const Event& e = copy[seq & (kRingEvents - 1)];
+            std::fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         e.name, ring->id, (e.start_ns - detail::g_origin_ns) / 1000.0, e.duration_ns / 1000.0);
+        }
+        stats.spans += head - first;
+        ++stats.threads;
+    }
+    std::fputs("\n]}\n", out);
+    
+    if (std::fclose(out) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef STOCK_SIMULATOR_TRACING
+#define TRACE_SPAN(name) ::trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)
+#else
+#define TRACE_SPAN(name) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -4,31 +4,73 @@
 #include "PriceData.h"
 #include "SharedBuffer.h"
 #include "PerformanceMonitor.h"
+#include "RollingWindow.h"
+#include "IndicatorTask.h"
+#include "CacheLine.h"
+#include "SimdKernels.h"
+#include "ThreadPlacement.h"
 #include <thread>
 #include <atomic>
 #include <iostream>
 #include <cmath>
-#include <numeric>
 #include <iomanip>
 
 // Computes volatility for each symbol in the background.
-class VolatilityCalculator {
+//
+// Returns are derived once per tick as ticks arrive and kept in a rolling
+// window with a running variance, so each volatility read is O(1).
+//
+// Runs either on its own thread (start()) or as per-symbol tasks on an
+// IndicatorScheduler.
+class VolatilityCalculator : public IndicatorTask {
 private:
+    // Streaming state for one symbol, on its own cache line(s): executor
+    // workers update neighbouring symbols at the same time
+    struct alignas(kCacheLineSize) SymbolState {
+        uint64_t cursor;            // Buffer sequence consumed so far
+        RollingWindow returns;      // Last window_size_ - 1 returns
+        PriceData latest;           // Most recent tick folded in
+        bool has_price;             // latest holds a real tick
+        
+        explicit SymbolState(size_t window_size)
+            : cursor(0), returns(window_size > 1 ? window_size - 1 : 1), has_price(false) {}
+    };
+    
     SharedBuffer& buffer_;                  // Reference to shared buffer
     PerformanceMonitor& perf_monitor_;     // Performance tracking
     std::atomic<bool> running_;             // Thread-safe shutdown flag
     std::thread thread_;                    // Worker thread
     
-    int calculation_interval_ms_;           // Time between calculations
-    size_t window_size_;                    // Volatility window size
+    int calculation_interval_ms_;           // Time between calculations (Poll) / wait timeout (Notify)
+    size_t window_size_;                    // Volatility window size (prices)
+    ConsumerWakeMode wake_mode_;            // Fixed-interval polling or epoch notification
+    BarResolution resolution_;              // Ticks, or closed bars of one size
+    std::string name_;                      // "Volatility", or e.g. "Volatility 1m" on bars
+    
+    std::vector<SymbolState> states_;       // Indexed by symbol ID
+    OperationId operation_id_;              // "Volatility" in the performance report
+    IndicatorSink* sink_ = nullptr;         // Binary output (attachOutput), if any
+    uint16_t output_id_ = 0;
+    ConsumerId consumer_;                   // Cursor (and overload policy) in the buffer
+    
+    alignas(kCacheLineSize) std::atomic<size_t> calculation_count_;   // Bumped by every worker
 
 public:
     VolatilityCalculator(SharedBuffer& buffer,
                          PerformanceMonitor& perf_monitor,
                          size_t window_size = 20,
-                         int calculation_interval_ms = 1500)
+                         int calculation_interval_ms = 1500,
+                         ConsumerWakeMode wake_mode = ConsumerWakeMode::Poll,
+                         BarResolution resolution = BarResolution::Tick)
         : buffer_(buffer), perf_monitor_(perf_monitor), running_(false),
-          calculation_interval_ms_(calculation_interval_ms), window_size_(window_size) {}
+          calculation_interval_ms_(calculation_interval_ms), window_size_(window_size),
+          wake_mode_(wake_mode), resolution_(resolution), name_(indicatorName("Volatility", resolution)),
+          states_(buffer.registry().capacity(), SymbolState(window_size)),
+          operation_id_(perf_monitor.registerOperation(name_)),
+          consumer_(buffer.registerConsumer(name_, resolution)),
+          calculation_count_(0) {
+        setLogEvery(15);
+    }
     
     void start() {
         bool expected = false;
@@ -48,106 +90,201 @@ public:
         }
     }
     
-    ~VolatilityCalculator() {
+    ~VolatilityCalculator() override {
         stop();
     }
+    
+    const char* name() const override { return name_.c_str(); }
+    
+    ConsumerId consumerId() const override { return consumer_; }
+    
+    void attachOutput(IndicatorSink& sink) override {
+        output_id_ = sink.registerIndicator(name_);
+        sink_ = &sink;
+    }
+    
+    bool hasNewData(SymbolId symbol) const override {
+        return buffer_.sequence(symbol, resolution_) != states_[symbol].cursor;
+    }
+    
+    /**
+     * @brief Fold new ticks for one symbol into its returns window and report volatility
+     * @return false if the symbol does not have enough data yet
+     *
+     * Safe to call concurrently for different symbols (see IndicatorTask).
+     */
+    bool calculateSymbol(SymbolId symbol) override {
+        // Per-thread scratch: executor workers may run different symbols at once
+        thread_local TickBatch new_ticks;
+        thread_local std::vector<double> new_returns;
+        
+        // Fold ticks published since the last pass into the returns window
+        SymbolState& state = states_[symbol];
+        state.cursor = buffer_.consume(consumer_, symbol, state.cursor, new_ticks);
+        if (!new_ticks.empty()) {
+            TRACE_SPAN("compute");
+            const std::vector<double>& prices = new_ticks.prices;
+            if (state.has_price) {
+                double prev = state.latest.price;
+                state.returns.push((prices[0] - prev) / prev);
+            }
+            if (prices.size() > 1) {
+                new_returns.resize(prices.size() - 1);
+                simd::returns(prices.data(), prices.size(), new_returns.data());
+                state.returns.pushBatch(new_returns.data(), new_returns.size());
+            }
+            state.latest = new_ticks.back();
+            state.has_price = true;
+        }
+        
+        if (state.returns.size() < 2) {
+            return false;  // Need at least 3 data points
+        }
+        
+        // Running variance of returns: O(1) read
+        double variance = state.returns.variance();
+        size_t sample_size = state.returns.size();
+        
+        // Calculate standard deviation (volatility)
+        double volatility = std::sqrt(variance);
+        
+        // Annualized volatility (assuming 252 trading days)
+        double annualized_volatility = volatility * std::sqrt(252.0) * 100.0;  // As percentage
+        
+        // Record performance: latency from generation to calculation
+        auto generation_time = state.latest.timestamp;
+        auto processing_time = TickClock::now();
+        perf_monitor_.recordProcessing(symbol, operation_id_, generation_time, processing_time);
+        
+        if (sink_) {
+            sink_->emit(symbol, output_id_, annualized_volatility, state.latest.price,
+                        generation_time, processing_time, state.cursor);
+        }
+        
+        size_t count = ++calculation_count_;
+        
+        // Log a sample of the results
+        if (logSample(count)) {
+            // Classify volatility level
+            const char* volatility_level;
+            if (annualized_volatility < 15.0) {
+                volatility_level = "LOW";
+            } else if (annualized_volatility < 30.0) {
+                volatility_level = "MODERATE";
+            } else {
+                volatility_level = "HIGH";
+            }
+            
+            std::cout << "\n[VolatilityCalculator] " << buffer_.registry().name(symbol) 
+                      << " - Price: $" << std::fixed << std::setprecision(2) << state.latest.price
+                      << " | Volatility: " << std::setprecision(2) << annualized_volatility << "% (annualized)"
+                      << " | Level: " << volatility_level
+                      << " | Sample size: " << sample_size;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Checkpoint: window size, then per symbol the cursor, latest tick and window
+     */
+    void saveState(CheckpointWriter& out) const override {
+        out.put(static_cast<uint32_t>(states_.size()));
+        out.put(static_cast<uint64_t>(window_size_));
+        for (const SymbolState& state : states_) {
+            out.put(state.cursor);
+            out.put(state.latest);
+            out.put(static_cast<uint8_t>(state.has_price));
+            state.returns.save(out);
+        }
+    }
+    
+    /**
+     * @brief Restore saveState() output; needs the same symbols and window size
+     */
+    bool loadState(CheckpointReader& in, TickClock::duration clock_shift) override {
+        uint32_t symbols = 0;
+        uint64_t window = 0;
+        if (!in.get(symbols) || !in.get(window) ||
+            symbols != states_.size() || window != window_size_) {
+            return false;
+        }
+        for (SymbolState& state : states_) {
+            uint8_t has_price = 0;
+            if (!(in.get(state.cursor) && in.get(state.latest) && in.get(has_price) && state.returns.load(in))) {
+                states_.assign(states_.size(), SymbolState(window_size_));
+                return false;
+            }
+            state.has_price = (has_price != 0);
+            state.latest.timestamp += clock_shift;
+            if (resolution_ != BarResolution::Tick) state.cursor = 0;   // Bars are not checkpointed
+        }
+        for (size_t id = 0; id < states_.size(); ++id) {
+            buffer_.restoreCursor(consumer_, static_cast<SymbolId>(id), states_[id].cursor);
+        }
+        return true;
+    }
 
 private:
     void run() {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "VolatilityCalculator");
         std::cout << "[VolatilityCalculator] Volatility calculation loop starting...\n";
         
-        size_t calculation_count = 0;
+        const bool notify = (wake_mode_ == ConsumerWakeMode::Notify);
+        uint64_t seen_epoch = 0;
+        SymbolTable::Reader listed(buffer_.symbolTable());     // Listed symbols, read in place
         
         while (running_.load()) {
-            // Wait for new data with condition variable
-            buffer_.waitForData(calculation_interval_ms_);
-            
-            if (!running_.load()) break;
+            if (notify) {
+                // Sleep until a tick newer than the last pass is pushed
+                uint64_t epoch = buffer_.waitForUpdate(seen_epoch, calculation_interval_ms_);
+                if (!running_.load()) break;
+                if (epoch == seen_epoch) continue;  // Timed out, nothing new
+                seen_epoch = epoch;
+            } else {
+                // Wait for new data with condition variable
+                buffer_.waitForData(calculation_interval_ms_);
+                if (!running_.load()) break;
+            }
             
-            // Get all symbols being tracked
-            auto symbols = buffer_.getSymbols();
+            // Symbols being tracked (a new list only after a listing change)
+            listed.refresh();
+            const std::vector<SymbolId>& symbols = listed.symbols();
             
             if (symbols.empty()) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 continue;
             }
             
-            auto calc_start = std::chrono::high_resolution_clock::now();
+            auto calc_start = TickClock::now();
+            size_t pass_start_count = calculation_count_;
             
             // Calculate volatility for each symbol
-            for (const auto& symbol : symbols) {
-                // Read price history (CRITICAL SECTION handled internally)
-                auto history = buffer_.getHistory(symbol, window_size_);
-                
-                if (history.size() < 3) {
-                    continue;  // Need at least 3 data points
-                }
-                
-                // Calculate returns
-                std::vector<double> returns;
-                for (size_t i = 1; i < history.size(); ++i) {
-                    double return_pct = (history[i].price - history[i-1].price) / history[i-1].price;
-                    returns.push_back(return_pct);
-                }
-                
-                // Calculate mean return
-                double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-                
-                // Calculate variance
-                double variance = 0.0;
-                for (double ret : returns) {
-                    variance += (ret - mean_return) * (ret - mean_return);
-                }
-                variance /= returns.size();
-                
-                // Calculate standard deviation (volatility)
-                double volatility = std::sqrt(variance);
-                
-                // Annualized volatility (assuming 252 trading days)
-                double annualized_volatility = volatility * std::sqrt(252.0) * 100.0;  // As percentage
-                
-                // Record performance: latency from generation to calculation
-                auto generation_time = history.back().timestamp;
-                auto processing_time = std::chrono::high_resolution_clock::now();
-                perf_monitor_.recordProcessing(symbol, "Volatility", generation_time, processing_time);
-                
-                ++calculation_count;
-                
-                // Classify volatility level
-                std::string volatility_level;
-                if (annualized_volatility < 15.0) {
-                    volatility_level = "LOW";
-                } else if (annualized_volatility < 30.0) {
-                    volatility_level = "MODERATE";
-                } else {
-                    volatility_level = "HIGH";
-                }
-                
-                // Log results periodically
-                if (calculation_count % 15 == 0) {
-                    std::cout << "\n[VolatilityCalculator] " << symbol 
-                              << " - Price: $" << std::fixed << std::setprecision(2) << history.back().price
-                              << " | Volatility: " << std::setprecision(2) << annualized_volatility << "% (annualized)"
-                              << " | Level: " << volatility_level
-                              << " | Sample size: " << returns.size();
+            for (SymbolId symbol : symbols) {
+                // Notify mode: skip symbols whose epoch did not move since our last pass
+                if (notify && !hasNewData(symbol)) {
+                    continue;
                 }
+                calculateSymbol(symbol);
             }
+            passComplete();     // Between passes: safe point for a checkpoint copy
             
-            auto calc_end = std::chrono::high_resolution_clock::now();
+            auto calc_end = TickClock::now();
             auto calc_time = std::chrono::duration_cast<std::chrono::microseconds>(
                 calc_end - calc_start).count();
             
             // Log calculation performance (display in microseconds using ASCII)
-            if (calculation_count % 15 == 0) {
+            if (calculation_count_ != pass_start_count && logSample(calculation_count_)) {
                 std::cout << " | Calc time: " << calc_time << " us\n";
             }
             
             // Sleep to control calculation rate
-            std::this_thread::sleep_for(std::chrono::milliseconds(calculation_interval_ms_));
+            if (!notify) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(calculation_interval_ms_));
+            }
         }
         
         std::cout << "\n[VolatilityCalculator] Volatility calculation loop exited after " 
-                  << calculation_count << " calculations\n";
+                  << calculation_count_ << " calculations\n";
     }
 };
 
@@ -0,0 +1,289 @@
+#ifndef WORK_STEALING_EXECUTOR_H
+#define WORK_STEALING_EXECUTOR_H
+
+#include "CacheLine.h"
+#include "ThreadPlacement.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts the outstanding tasks of one submission so the submitter can wait
+// for all of them (see WorkStealingExecutor::wait).
+struct TaskGroup {
+    std::atomic<size_t> pending{0};
+    
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// One unit of work: a plain function pointer plus its argument, so queuing
+// a task never allocates (unlike std::function).
+struct ExecutorTask {
+    void (*run)(void* context, size_t argument) = nullptr;
+    void* context = nullptr;
+    size_t argument = 0;
+    TaskGroup* group = nullptr;
+};
+
+// Fixed pool of worker threads with one task deque per worker.
+//
+// Submitted tasks are spread round-robin over the worker deques. A worker
+// pops from the back of its own deque and, when that is empty, steals from
+// the front of another worker's deque, so a worker that drew only cheap
+// tasks keeps the others' backlog moving instead of idling. Idle workers
+// sleep on a condition variable and only cost the submitter a notify when
+// someone is actually asleep (same handoff as SharedBuffer::notifyConsumers).
+//
+// Each deque has its own small mutex: the owner and a thief only contend
+// when the thief picks the same deque, and no lock is ever held while a
+// task runs.
+class WorkStealingExecutor {
+private:
+    // Double-ended ring of tasks. Capacity doubles when full and is never
+    // given back, so a steady submit/run cycle stops touching the heap once
+    // the largest pass has been seen (std::deque allocates and frees a block
+    // every few tasks as its contents slide along).
+    class TaskQueue {
+    private:
+        std::vector<ExecutorTask> slots_;   // Power-of-two size
+        size_t head_ = 0;                   // Index of the front task
+        size_t size_ = 0;
+        
+        size_t mask() const { return slots_.size() - 1; }
+        
+        void grow() {
+            std::vector<ExecutorTask> bigger(slots_.size() * 2);
+            for (size_t i = 0; i < size_; ++i) {
+                bigger[i] = slots_[(head_ + i) & mask()];
+            }
+            slots_.swap(bigger);
+            head_ = 0;
+        }
+    
+    public:
+        TaskQueue() : slots_(64) {}
+        
+        bool empty() const { return size_ == 0; }
+        
+        void pushBack(const ExecutorTask& task) {
+            if (size_ == slots_.size()) grow();
+            slots_[(head_ + size_) & mask()] = task;
+            ++size_;
+        }
+        
+        ExecutorTask popBack() {
+            --size_;
+            return slots_[(head_ + size_) & mask()];
+        }
+        
+        ExecutorTask popFront() {
+            ExecutorTask task = slots_[head_];
+            head_ = (head_ + 1) & mask();
+            --size_;
+            return task;
+        }
+    };
+    
+    // Each worker on its own cache line(s): its lock and counters are
+    // written constantly by its thread (and by thieves)
+    struct alignas(kCacheLineSize) Worker {
+        std::mutex mutex;
+        TaskQueue tasks;
+        std::thread thread;
+        std::atomic<size_t> executed{0};
+        std::atomic<size_t> stolen{0};      // Tasks this worker took from others
+    };
+    
+    // Read-mostly: set up once, stop_ written only at shutdown
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stop_;
+    
+    // Write-hot, one cache line each: every push/pop touches queued_,
+    // every submit next_queue_, every idle worker sleepers_
+    alignas(kCacheLineSize) std::atomic<size_t> queued_;    // Tasks sitting in any deque
+    alignas(kCacheLineSize) std::atomic<size_t> next_queue_; // Round-robin submission cursor
+    
+    alignas(kCacheLineSize) std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<int> sleepers_;
+    
+    // Index of the worker running on this thread (-1 elsewhere)
+    static int& currentIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+    
+    bool popLocal(size_t index, ExecutorTask& task) {
+        Worker& w = *workers_[index];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) return false;
+        task = w.tasks.popBack();
+        queued_.fetch_sub(1);
+        return true;
+    }
+    
+    bool stealFrom(size_t victim, ExecutorTask& task) {
+        Worker& w = *workers_[victim];
+        std::unique_lock<std::mutex> lock(w.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || w.tasks.empty()) return false;
+        task = w.tasks.popFront();
+        queued_.fetch_sub(1);
+        return true;
+    }
+    
+    // Own deque first (if the caller is a worker), then every other one
+    bool findTask(int self, ExecutorTask& task) {
+        if (self >= 0 && popLocal(static_cast<size_t>(self), task)) {
+            return true;
+        }
+        size_t n = workers_.size();
+        size_t start = (self >= 0) ? static_cast<size_t>(self) + 1 : next_queue_.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if (static_cast<int>(victim) == self) continue;
+            if (stealFrom(victim, task)) {
+                if (self >= 0) workers_[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    static void execute(const ExecutorTask& task) {
+        task.run(task.context, task.argument);
+        if (task.group) {
+            task.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+    
+    void wakeWorkers(size_t count) {
+        if (sleepers_.load() == 0) {
+            return;
+        }
+        { std::lock_guard<std::mutex> handoff(sleep_mutex_); }
+        if (count == 1) {
+            wake_.notify_one();
+        } else {
+            wake_.notify_all();
+        }
+    }
+    
+    void workerLoop(size_t index) {
+        ThreadPlacement::pinCurrentThread(ThreadRole::Indicator, "WorkStealingExecutor worker " + std::to_string(index));
+        currentIndex() = static_cast<int>(index);
+        Worker& self = *workers_[index];
+        ExecutorTask task;
+        
+        while (!stop_.load()) {
+            if (findTask(static_cast<int>(index), task)) {
+                execute(task);
+                self.executed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            
+            // Nothing anywhere: sleep until a submit (or stop). Registering
+            // in sleepers_ before re-checking queued_ pairs with wakeWorkers().
+            ++sleepers_;
+            {
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                wake_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+            }
+            --sleepers_;
+        }
+    }
+
+public:
+    /**
+     * @param worker_count Number of worker threads (at least 1)
+     */
+    explicit WorkStealingExecutor(size_t worker_count)
+        : stop_(false), queued_(0), next_queue_(0), sleepers_(0) {
+        if (worker_count == 0) worker_count = 1;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_[i]->thread = std::thread(&WorkStealingExecutor::workerLoop, this, i);
+        }
+        std::cout << "[WorkStealingExecutor] Started " << worker_count << " worker thread(s)\n";
+    }
+    
+    ~WorkStealingExecutor() {
+        stop_.store(true);
+        { std::lock_guard<std::mutex> handoff(sleep_mutex_); }
+        wake_.notify_all();
+        for (auto& w : workers_) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+    }
+    
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+    
+    size_t workerCount() const { return workers_.size(); }
+    
+    /**
+     * @brief Queue tasks; each counts against its own group until it has run
+     *
+     * Tasks go round-robin over the worker deques (a worker submitting work
+     * keeps it on its own deque). Sleeping workers are woken once per call.
+     */
+    void submit(const ExecutorTask* tasks, size_t count) {
+        if (count == 0) return;
+        
+        int self = currentIndex();
+        for (size_t i = 0; i < count; ++i) {
+            if (tasks[i].group) {
+                tasks[i].group->pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            size_t target = (self >= 0) ? static_cast<size_t>(self)
+                                        : next_queue_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+            Worker& w = *workers_[target];
+            {
+                std::lock_guard<std::mutex> lock(w.mutex);
+                w.tasks.pushBack(tasks[i]);
+            }
+            queued_.fetch_add(1);
+        }
+        wakeWorkers(count);
+    }
+    
+    void submit(const ExecutorTask& task) {
+        submit(&task, 1);
+    }
+    
+    /**
+     * @brief Block until every task in group has run
+     *
+     * The calling thread helps by running queued tasks (from any group)
+     * while it waits, so waiting never idles a core.
+     */
+    void wait(TaskGroup& group) {
+        ExecutorTask task;
+        int self = currentIndex();
+        while (!group.done()) {
+            if (findTask(self, task)) {
+                execute(task);
+            } else {
+                std::this_thread::yield();  // Remaining tasks are running on workers
+            }
+        }
+    }
+    
+    /**
+     * @brief Totals since start: tasks run by workers and how many were stolen
+     */
+    void getStats(size_t& executed, size_t& stolen) const {
+        executed = stolen = 0;
+        for (const auto& w : workers_) {
+            executed += w->executed.load(std::memory_order_relaxed);
+            stolen += w->stolen.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif // WORK_STEALING_EXECUTOR_H
@@ -0,0 +1,72 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include "SymbolRegistry.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+// Registry with symbols "S0", "S1", ... "S<count-1>"
+inline SymbolRegistry makeRegistry(size_t count) {
+    SymbolRegistry registry;
+    for (size_t i = 0; i < count; ++i) {
+        registry.intern("S" + std::to_string(i));
+    }
+    return registry;
+}
+
+// Background threads that repeat a callable until destroyed, used to put
+// contending readers (or a writer) next to the thread being measured.
+class BackgroundThreads {
+private:
+    std::atomic<bool> running_;
+    std::atomic<size_t> started_;
+    std::vector<std::thread> threads_;
+
+public:
+    /**
+     * @param fn Called repeatedly as fn(thread_index) until destruction
+     *
+     * Returns once every thread has entered its loop.
+     */
+    template <typename Fn>
+    BackgroundThreads(size_t count, Fn fn) : running_(true), started_(0) {
+        for (size_t i = 0; i < count; ++i) {
+            threads_.emplace_back([this, fn, i]() mutable {
+                started_.fetch_add(1);
+                while (running_.load(std::memory_order_relaxed)) {
+                    fn(i);
+                }
+            });
+        }
+        while (started_.load() < count) {
+            std::this_thread::yield();
+        }
+    }
+    
+    ~BackgroundThreads() {
+        running_.store(false);
+        for (auto& t : threads_) t.join();
+    }
+    
+    BackgroundThreads(const BackgroundThreads&) = delete;
+    BackgroundThreads& operator=(const BackgroundThreads&) = delete;
+};
+
+// Mutes std::cout while alive, for benchmarking components that log
+class QuietStdout {
+public:
+    QuietStdout() { std::cout.setstate(std::ios::failbit); }
+    ~QuietStdout() { std::cout.clear(); }
+    
+    QuietStdout(const QuietStdout&) = delete;
+    QuietStdout& operator=(const QuietStdout&) = delete;
+};
+
+}  // namespace bench
+
+#endif // BENCH_UTIL_H
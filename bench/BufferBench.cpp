@@ -0,0 +1,278 @@
+// SharedBuffer microbenchmarks: producer push cost and consumer read cost
+// under contention, for both buffer modes.
+
+#include "BenchUtil.h"
+#include "SharedBuffer.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr size_t kSymbols = 5;
+constexpr size_t kHistory = 100;
+
+BufferMode modeArg(const benchmark::State& state) {
+    return state.range(0) ? BufferMode::LockFree : BufferMode::Mutex;
+}
+
+// Producer push() of one tick while `readers` threads call getHistory()
+void BM_Push(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, modeArg(state));
+    size_t readers = static_cast<size_t>(state.range(1));
+    
+    bench::BackgroundThreads contention(readers, [&buffer](size_t i) {
+        auto history = buffer.getHistory(static_cast<SymbolId>(i % kSymbols), 20);
+        benchmark::DoNotOptimize(history.data());
+    });
+    
+    PriceData tick(0, 100.0, 0.1);
+    SymbolId symbol = 0;
+    for (auto _ : state) {
+        tick.symbol = symbol;
+        tick.price += 0.01;
+        buffer.push(tick);
+        symbol = (symbol + 1 == kSymbols) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Push)
+    ->ArgNames({"lockfree", "readers"})
+    ->ArgsProduct({{0, 1}, {0, 1, 2, 4, 8}})
+    ->UseRealTime();
+
+// One pushBatch() of a tick per symbol (one generator iteration)
+void BM_PushBatch(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(1)));
+    SharedBuffer buffer(registry, kHistory, modeArg(state));
+    
+    std::vector<PriceData> batch;
+    for (size_t id = 0; id < registry.size(); ++id) {
+        batch.emplace_back(static_cast<SymbolId>(id), 100.0, 0.1);
+    }
+    for (auto _ : state) {
+        for (auto& tick : batch) tick.price += 0.01;
+        buffer.pushBatch(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_PushBatch)
+    ->ArgNames({"lockfree", "symbols"})
+    ->ArgsProduct({{0, 1}, {5, 500}});
+
+// pushBatch() with and without OHLCV bars (lock-free), 10 ms of tick time
+// per iteration so 1s bars close every 100 batches and coarser ones roll up
+void BM_PushBatchBars(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(1)));
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree, state.range(0) ? 64 : 0);
+    
+    std::vector<PriceData> batch;
+    for (size_t id = 0; id < registry.size(); ++id) {
+        batch.emplace_back(static_cast<SymbolId>(id), 100.0, 0.1);
+    }
+    for (auto _ : state) {
+        for (auto& tick : batch) {
+            tick.price += 0.01;
+            tick.timestamp += std::chrono::milliseconds(10);
+        }
+        buffer.pushBatch(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_PushBatchBars)
+    ->ArgNames({"bars", "symbols"})
+    ->ArgsProduct({{0, 1}, {5, 500}});
+
+// getHistory(count) with `readers` readers in total (this one included)
+// and a producer pushing continuously
+void BM_GetHistory(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, modeArg(state));
+    size_t readers = static_cast<size_t>(state.range(1));
+    size_t count = static_cast<size_t>(state.range(2));
+    
+    // Fill the history before measuring
+    for (size_t i = 0; i < kHistory * kSymbols; ++i) {
+        buffer.push(PriceData(static_cast<SymbolId>(i % kSymbols), 100.0, 0.0));
+    }
+    
+    PriceData produced(0, 100.0, 0.1);
+    bench::BackgroundThreads writer(1, [&buffer, &produced](size_t) {
+        produced.symbol = (produced.symbol + 1 == kSymbols) ? 0 : produced.symbol + 1;
+        produced.price += 0.01;
+        buffer.push(produced);
+    });
+    bench::BackgroundThreads contention(readers - 1, [&buffer, count](size_t i) {
+        auto history = buffer.getHistory(static_cast<SymbolId>(i % kSymbols), count);
+        benchmark::DoNotOptimize(history.data());
+    });
+    
+    SymbolId symbol = 0;
+    for (auto _ : state) {
+        auto history = buffer.getHistory(symbol, count);
+        benchmark::DoNotOptimize(history.data());
+        symbol = (symbol + 1 == kSymbols) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetHistory)
+    ->ArgNames({"lockfree", "readers", "count"})
+    ->ArgsProduct({{0, 1}, {1, 2, 4, 8}, {20, 100}})
+    ->UseRealTime();
+
+// Zero-copy view + validation of the newest `count` ticks, summing prices
+void BM_GetHistoryView(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    size_t readers = static_cast<size_t>(state.range(0));
+    size_t count = static_cast<size_t>(state.range(1));
+    
+    for (size_t i = 0; i < kHistory * kSymbols; ++i) {
+        buffer.push(PriceData(static_cast<SymbolId>(i % kSymbols), 100.0, 0.0));
+    }
+    
+    PriceData produced(0, 100.0, 0.1);
+    bench::BackgroundThreads writer(1, [&buffer, &produced](size_t) {
+        produced.symbol = (produced.symbol + 1 == kSymbols) ? 0 : produced.symbol + 1;
+        produced.price += 0.01;
+        buffer.push(produced);
+    });
+    bench::BackgroundThreads contention(readers - 1, [&buffer, count](size_t i) {
+        HistoryView view = buffer.getHistoryView(static_cast<SymbolId>(i % kSymbols), count);
+        benchmark::DoNotOptimize(view.valid());
+    });
+    
+    SymbolId symbol = 0;
+    for (auto _ : state) {
+        HistoryView view = buffer.getHistoryView(symbol, count);
+        double sum = 0.0;
+        for (size_t i = 0; i < view.size(); ++i) sum += view.price(i);
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(view.valid());
+        symbol = (symbol + 1 == kSymbols) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetHistoryView)
+    ->ArgNames({"readers", "count"})
+    ->ArgsProduct({{1, 2, 4, 8}, {20, 100}})
+    ->UseRealTime();
+
+// getLatest() (the latest-price board) with `readers` readers in total and
+// a producer pushing continuously; neither buffer mode takes a lock here
+void BM_GetLatestWithWriter(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, modeArg(state));
+    size_t readers = static_cast<size_t>(state.range(1));
+    
+    for (size_t id = 0; id < kSymbols; ++id) {
+        buffer.push(PriceData(static_cast<SymbolId>(id), 100.0, 0.0));
+    }
+    
+    PriceData produced(0, 100.0, 0.1);
+    bench::BackgroundThreads writer(1, [&buffer, &produced](size_t) {
+        produced.symbol = (produced.symbol + 1 == kSymbols) ? 0 : produced.symbol + 1;
+        produced.price += 0.01;
+        buffer.push(produced);
+    });
+    bench::BackgroundThreads contention(readers - 1, [&buffer](size_t i) {
+        PriceData latest;
+        benchmark::DoNotOptimize(buffer.getLatest(static_cast<SymbolId>(i % kSymbols), latest));
+    });
+    
+    SymbolId symbol = 0;
+    PriceData latest;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.getLatest(symbol, latest));
+        symbol = (symbol + 1 == kSymbols) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetLatestWithWriter)
+    ->ArgNames({"lockfree", "readers"})
+    ->ArgsProduct({{0, 1}, {1, 2, 4, 8}})
+    ->UseRealTime();
+
+// snapshotLatest() over every symbol while one producer keeps pushing
+void BM_SnapshotLatest(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(0)));
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    size_t symbols = registry.size();
+    
+    PriceData produced(0, 100.0, 0.1);
+    bench::BackgroundThreads writer(1, [&buffer, &produced, symbols](size_t) {
+        produced.symbol = (produced.symbol + 1 == symbols) ? 0 : produced.symbol + 1;
+        produced.price += 0.01;
+        buffer.push(produced);
+    });
+    
+    std::vector<PriceData> latest;
+    std::vector<uint64_t> versions;
+    for (auto _ : state) {
+        std::fill(versions.begin(), versions.end(), 0);     // Read every symbol, not just changed ones
+        buffer.snapshotLatest(latest, versions);
+        benchmark::DoNotOptimize(latest.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(symbols));
+}
+BENCHMARK(BM_SnapshotLatest)->Arg(5)->Arg(500)->Arg(50000)->UseRealTime();
+
+// Finding the symbols to process at the start of a consumer pass: the
+// getSymbols() copy vs. refreshing a SymbolTable::Reader (no listing change)
+void BM_PassSymbolsCopy(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(0)));
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    for (size_t id = 0; id < registry.size(); ++id) buffer.push(PriceData(static_cast<SymbolId>(id), 100.0, 0.1));
+    
+    std::vector<SymbolId> symbols;
+    for (auto _ : state) {
+        buffer.getSymbols(symbols);
+        benchmark::DoNotOptimize(symbols.data());
+    }
+}
+BENCHMARK(BM_PassSymbolsCopy)->ArgName("symbols")->Arg(500)->Arg(10000)->Arg(100000);
+
+void BM_PassSymbolsReader(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(0)));
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    
+    SymbolTable::Reader listed(buffer.symbolTable());
+    for (auto _ : state) {
+        listed.refresh();
+        benchmark::DoNotOptimize(listed.symbols().data());
+    }
+}
+BENCHMARK(BM_PassSymbolsReader)->ArgName("symbols")->Arg(500)->Arg(10000)->Arg(100000);
+
+// Publishing one listing change (one symbol delisted, one listed) while a
+// reader refreshes: the writer's cost is a merge of the listed IDs
+void BM_ListingChange(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    SymbolRegistry registry = bench::makeRegistry(symbols);
+    registry.reserve(symbols + 1);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    std::vector<std::string> spare = {"SPARE"};
+    buffer.updateListings(spare, {});
+    SymbolId spare_id = registry.find("SPARE");
+    
+    bench::BackgroundThreads reader(1, [&buffer](size_t) {
+        thread_local SymbolTable::Reader listed(buffer.symbolTable());
+        listed.refresh();
+        benchmark::DoNotOptimize(listed.symbols().data());
+    });
+    
+    bool spare_listed = true;
+    for (auto _ : state) {
+        if (spare_listed) {
+            buffer.updateListings({}, {spare_id});
+        } else {
+            buffer.updateListings(spare, {0});
+        }
+        spare_listed = !spare_listed;
+    }
+}
+BENCHMARK(BM_ListingChange)->ArgName("symbols")->Arg(500)->Arg(10000)->Arg(100000)->UseRealTime();
+
+}  // namespace
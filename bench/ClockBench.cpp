@@ -0,0 +1,48 @@
+// Clock microbenchmarks: cost of one timestamp from each clock the
+// simulator could use (every tick and every calculation takes one).
+
+#include "Clock.h"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+namespace {
+
+// Calibrate before any benchmark runs
+const bool g_clock_ready = (CycleClock::init(), true);
+
+void BM_HighResolutionClock(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::high_resolution_clock::now());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HighResolutionClock);
+
+void BM_SteadyClock(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SteadyClock);
+
+void BM_CycleClock(benchmark::State& state) {
+    benchmark::DoNotOptimize(g_clock_ready);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CycleClock::now());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(CycleClock::name());
+}
+BENCHMARK(BM_CycleClock);
+
+void BM_CoarseClock(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CoarseClock::now());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CoarseClock);
+
+}  // namespace
@@ -0,0 +1,147 @@
+// Correlation matrix microbenchmarks at 500, 2k and 5k symbols: one
+// incremental sample (rank-1 update plus the downdate of the sample leaving
+// the window) against recomputing the window, staged samples sharing one
+// sweep, a plain row-major scalar update, and sweeps split over executor
+// workers.
+
+#include "CorrelationMatrix.h"
+#include "WorkStealingExecutor.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kWindow = 100;
+constexpr size_t kSampleSets = 16;     // Distinct samples cycled through
+
+void symbolArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("symbols");
+    for (int symbols : {500, 2000, 5000}) b->Arg(symbols);
+}
+
+// Returns with a market factor, so pairs are actually correlated
+std::vector<std::vector<double>> makeSamples(size_t symbols) {
+    std::mt19937 gen(42);
+    std::normal_distribution<> noise(0.0, 0.01);
+    std::vector<std::vector<double>> samples(kSampleSets, std::vector<double>(symbols));
+    for (auto& sample : samples) {
+        double market = noise(gen);
+        for (double& r : sample) r = 0.5 * market + noise(gen);
+    }
+    return samples;
+}
+
+// A matrix whose window is already full, so every sample also removes one
+void fill(RollingCovariance& matrix, const std::vector<std::vector<double>>& samples) {
+    for (size_t s = 0; s < kWindow; ++s) {
+        matrix.add(samples[s % kSampleSets].data());
+        matrix.update();
+    }
+}
+
+// One sample per sweep, as CorrelationCalculator applies them: O(N^2)
+void BM_CorrelationUpdate(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    auto samples = makeSamples(symbols);
+    RollingCovariance matrix(symbols, kWindow);
+    fill(matrix, samples);
+    
+    size_t s = 0;
+    for (auto _ : state) {
+        matrix.add(samples[s++ % kSampleSets].data());
+        matrix.update();
+    }
+    benchmark::DoNotOptimize(matrix.covariance(0, symbols - 1));
+    state.SetItemsProcessed(state.iterations());
+    state.counters["matrix_MB"] = RollingCovariance::memoryBytes(symbols, kWindow) / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_CorrelationUpdate)->Apply(symbolArgs)->Unit(benchmark::kMillisecond);
+
+// What each sample costs without running sums: the window recomputed, O(N^2 * window)
+void BM_CorrelationRecompute(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    auto samples = makeSamples(symbols);
+    RollingCovariance matrix(symbols, kWindow);
+    fill(matrix, samples);
+    
+    for (auto _ : state) {
+        matrix.rebuild();
+    }
+    benchmark::DoNotOptimize(matrix.covariance(0, symbols - 1));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CorrelationRecompute)->Apply(symbolArgs)->Unit(benchmark::kMillisecond);
+
+// kMaxStaged samples applied in one sweep: each tile stays in L1 for all
+// of them, so the sums are streamed once per batch (items = samples)
+void BM_CorrelationStagedUpdate(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    auto samples = makeSamples(symbols);
+    RollingCovariance matrix(symbols, kWindow);
+    fill(matrix, samples);
+    
+    size_t s = 0;
+    for (auto _ : state) {
+        for (size_t k = 0; k < RollingCovariance::kMaxStaged; ++k) {
+            matrix.add(samples[s++ % kSampleSets].data());
+        }
+        matrix.update();
+    }
+    benchmark::DoNotOptimize(matrix.covariance(0, symbols - 1));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(RollingCovariance::kMaxStaged));
+}
+BENCHMARK(BM_CorrelationStagedUpdate)->Apply(symbolArgs)->Unit(benchmark::kMillisecond);
+
+// Baseline for the tiles and the SIMD kernel: the same update over a full
+// row-major N x N matrix, written as the obvious scalar loop
+void BM_CorrelationNaiveUpdate(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    auto samples = makeSamples(symbols);
+    std::vector<double> cross(symbols * symbols, 0.0);
+    std::vector<double> sums(symbols, 0.0);
+    
+    size_t s = 0;
+    for (auto _ : state) {
+        const std::vector<double>& added = samples[s % kSampleSets];
+        const std::vector<double>& removed = samples[(s + kSampleSets / 2) % kSampleSets];
+        ++s;
+        for (size_t i = 0; i < symbols; ++i) {
+            sums[i] += added[i] - removed[i];
+            for (size_t j = 0; j < symbols; ++j) {
+                cross[i * symbols + j] += added[i] * added[j] - removed[i] * removed[j];
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(cross[symbols - 1]);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CorrelationNaiveUpdate)->Apply(symbolArgs)->Unit(benchmark::kMillisecond);
+
+// One sample per sweep with the tile runs on an executor; the benchmark
+// thread helps while it waits (real time: the work is on other threads)
+void BM_CorrelationParallelUpdate(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    size_t workers = static_cast<size_t>(state.range(1));
+    auto samples = makeSamples(symbols);
+    WorkStealingExecutor executor(workers);
+    RollingCovariance matrix(symbols, kWindow, &executor);
+    fill(matrix, samples);
+    
+    size_t s = 0;
+    for (auto _ : state) {
+        matrix.add(samples[s++ % kSampleSets].data());
+        matrix.update();
+    }
+    benchmark::DoNotOptimize(matrix.covariance(0, symbols - 1));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CorrelationParallelUpdate)
+    ->ArgNames({"symbols", "workers"})
+    ->ArgsProduct({{500, 2000, 5000}, {1, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,108 @@
+// Display microbenchmarks: fastfmt against snprintf, and rendering a frame
+// from the buffer (old per-symbol getLatest + stringstream path vs.
+// DisplayRenderer's snapshot with changed-row redraw).
+
+#include "BenchUtil.h"
+#include "DisplayRenderer.h"
+#include "FastFormat.h"
+#include "SharedBuffer.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void BM_FormatFastfmt(benchmark::State& state) {
+    char out[fastfmt::kMaxFixed];
+    double value = 187.34;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fastfmt::fixed(out, value, 2, 8));
+        value += 0.01;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatFastfmt);
+
+void BM_FormatSnprintf(benchmark::State& state) {
+    char out[64];
+    double value = 187.34;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::snprintf(out, sizeof(out), "%8.2f", value));
+        value += 0.01;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatSnprintf);
+
+// Buffer with `symbols` symbols, each with some history
+struct DisplayFixture {
+    SymbolRegistry registry;
+    SharedBuffer buffer;
+    std::vector<PriceData> batch;
+    
+    explicit DisplayFixture(size_t symbols)
+        : registry(bench::makeRegistry(symbols)), buffer(registry, 100, BufferMode::LockFree) {
+        for (size_t id = 0; id < symbols; ++id) {
+            batch.emplace_back(static_cast<SymbolId>(id), 100.0 + id, 0.25);
+        }
+        buffer.pushBatch(batch);
+    }
+    
+    // New ticks for every stride-th symbol
+    void touch(size_t stride) {
+        for (size_t id = 0; id < batch.size(); id += stride) {
+            batch[id].price += 0.01;
+            buffer.push(batch[id]);
+        }
+    }
+};
+
+void renderArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"symbols", "changed_pct"});
+    b->ArgsProduct({{5, 5000}, {1, 100}});
+}
+
+// Original DisplayThread frame: getLatest per symbol into a fresh stringstream
+void BM_RenderStringstream(benchmark::State& state) {
+    DisplayFixture fixture(static_cast<size_t>(state.range(0)));
+    size_t stride = 100 / static_cast<size_t>(state.range(1));
+    std::vector<SymbolId> symbols;
+    for (auto _ : state) {
+        fixture.touch(stride);
+        fixture.buffer.getSymbols(symbols);
+        std::stringstream output;
+        output << "\r" << std::fixed << std::setprecision(2);
+        for (SymbolId symbol : symbols) {
+            PriceData data;
+            if (fixture.buffer.getLatest(symbol, data)) {
+                output << fixture.registry.name(symbol) << ": $" << std::setw(8) << data.price
+                       << (data.change >= 0 ? " UP " : " DN ")
+                       << std::setw(6) << std::showpos << data.change << std::noshowpos << " | ";
+            }
+        }
+        std::string frame = output.str();
+        benchmark::DoNotOptimize(frame.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderStringstream)->Apply(renderArgs);
+
+void BM_RenderSnapshot(benchmark::State& state) {
+    DisplayFixture fixture(static_cast<size_t>(state.range(0)));
+    size_t stride = 100 / static_cast<size_t>(state.range(1));
+    DisplayRenderer renderer(fixture.buffer);
+    std::string frame;
+    for (auto _ : state) {
+        fixture.touch(stride);
+        benchmark::DoNotOptimize(renderer.render(frame));
+        benchmark::DoNotOptimize(frame.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderSnapshot)->Apply(renderArgs);
+
+}  // namespace
@@ -0,0 +1,87 @@
+// False-sharing microbenchmarks: how per-thread counters and reader-side
+// statistics scale with the number of threads when they share a cache line
+// versus when each thread owns one (CacheLine.h, ShardedCounter.h).
+//
+// Scaling only shows on a machine with at least as many cores as threads;
+// with fewer, the threads time-slice and every variant looks alike.
+
+#include "BenchUtil.h"
+#include "CacheLine.h"
+#include "ShardedCounter.h"
+#include "SharedBuffer.h"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+
+namespace {
+
+constexpr int kMaxThreads = 8;
+
+// One counter every thread increments (what SharedBuffer::total_reads_ was)
+void BM_SharedCounter(benchmark::State& state) {
+    static std::atomic<uint64_t> counter{0};
+    for (auto _ : state) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedCounter)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// The same count, one padded slot per thread
+void BM_ShardedCounter(benchmark::State& state) {
+    static ShardedCounter counter;
+    for (auto _ : state) {
+        counter.add();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedCounter)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// Each thread writes only its own slot, but the slots are adjacent: eight
+// of them share one line, so the writes still contend
+void BM_PackedSlots(benchmark::State& state) {
+    static std::atomic<uint64_t> slots[kMaxThreads];
+    std::atomic<uint64_t>& mine = slots[state.thread_index()];
+    for (auto _ : state) {
+        mine.store(mine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PackedSlots)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// The same per-thread slots, one cache line each
+void BM_PaddedSlots(benchmark::State& state) {
+    static CachePadded<std::atomic<uint64_t>> slots[kMaxThreads];
+    std::atomic<uint64_t>& mine = *slots[state.thread_index()];
+    for (auto _ : state) {
+        mine.store(mine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PaddedSlots)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// getLatest() from every thread at once (lock-free rings, no writer): the
+// seqlock reads share nothing, so the read counter is the only write
+void BM_GetLatest(benchmark::State& state) {
+    static SymbolRegistry registry = bench::makeRegistry(kMaxThreads);
+    static SharedBuffer buffer(registry, 100, BufferMode::LockFree);
+    // One symbol per thread; pushes happen before any thread measures
+    SymbolId symbol = static_cast<SymbolId>(state.thread_index());
+    static const bool filled = [] {
+        for (size_t id = 0; id < registry.size(); ++id) {
+            buffer.push(PriceData(static_cast<SymbolId>(id), 100.0, 0.0));
+        }
+        return true;
+    }();
+    benchmark::DoNotOptimize(filled);
+    
+    PriceData latest;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.getLatest(symbol, latest));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetLatest)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,95 @@
+// Network feed microbenchmarks: decoding feed packets into the buffer, and
+// the whole loopback path (sendmmsg -> recvmmsg -> decode -> pushBatch).
+
+#include "BenchUtil.h"
+#include "MulticastFeed.h"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+constexpr size_t kSymbols = 500;
+constexpr size_t kHistory = 100;
+constexpr size_t kPackets = 64;     // One full recvmmsg() batch
+
+std::vector<TickFileRecord> makeRecords(size_t count) {
+    std::vector<TickFileRecord> records(count);
+    for (size_t i = 0; i < count; ++i) {
+        records[i] = TickFileRecord{static_cast<uint32_t>(i % kSymbols), 100, 100.0 + (i % 13) * 0.01, 0};
+    }
+    return records;
+}
+
+// Decode a receive batch of full packets and publish it with one pushBatch()
+void BM_FeedDecode(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    FeedDecoder decoder(registry.size());
+    
+    std::vector<TickFileRecord> records = makeRecords(kPackets * kFeedMaxRecords);
+    std::vector<std::byte> packets(kPackets * kFeedMaxPacketBytes);
+    size_t lengths[kPackets];
+    std::vector<PriceData> batch;
+    batch.reserve(records.size());
+    
+    uint64_t sequence = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (size_t p = 0; p < kPackets; ++p) {
+            lengths[p] = feed::encodePacket(records.data() + p * kFeedMaxRecords, kFeedMaxRecords, sequence++,
+                                            packets.data() + p * kFeedMaxPacketBytes);
+        }
+        state.ResumeTiming();
+        
+        FeedStats stats;
+        auto stamp = TickClock::now();
+        batch.clear();
+        for (size_t p = 0; p < kPackets; ++p) {
+            decoder.decode(packets.data() + p * kFeedMaxPacketBytes, lengths[p], stamp, batch, stats);
+        }
+        buffer.pushBatch(batch);
+        benchmark::DoNotOptimize(stats.ticks);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records.size()));
+}
+BENCHMARK(BM_FeedDecode);
+
+// Send a batch of packets over loopback and wait until the receiver has
+// published them (unicast to 127.0.0.1; multicast takes the same path)
+void BM_FeedLoopback(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    
+    FeedEndpoint endpoint;
+    FeedEndpoint::parse("127.0.0.1:30017", endpoint);
+    MulticastTickReceiver receiver(buffer, monitor, endpoint, static_cast<int>(state.range(0)));
+    MulticastTickPublisher publisher(endpoint);
+    receiver.start();
+    
+    std::vector<TickFileRecord> records = makeRecords(kPackets * kFeedMaxRecords);
+    uint64_t expected = 0;
+    uint64_t timeouts = 0;
+    for (auto _ : state) {
+        expected += publisher.publish(records.data(), records.size());
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (monitor.getFeedStats().packets + monitor.getFeedStats().missing < expected) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                ++timeouts;     // Datagrams dropped by the socket; next round's gap accounts for them
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    receiver.stop();
+    
+    FeedStats stats = monitor.getFeedStats();
+    state.SetItemsProcessed(static_cast<int64_t>(stats.ticks));
+    state.counters["missing"] = static_cast<double>(stats.missing);
+    state.counters["timeouts"] = static_cast<double>(timeouts);
+}
+BENCHMARK(BM_FeedLoopback)->ArgName("busy_poll_us")->Arg(0)->Arg(50)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,127 @@
+// Price generation microbenchmarks: one iteration's draws and price steps
+// for n symbols, the original per-symbol mt19937 + normal_distribution
+// loop against the batch kernels (RandomKernels.h) PriceGenerator uses.
+
+#include "RandomKernels.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+void symbolArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("symbols");
+    b->RangeMultiplier(8)->Range(8, 32768);
+}
+
+// Baseline: the original loop (one normal and one volume draw per symbol)
+void BM_IterationMt19937(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::mt19937 gen(42);
+    std::normal_distribution<> change_dist(0.0, 0.5);
+    std::uniform_int_distribution<int> volume_dist(1, 1000);
+    std::vector<double> prices(n, 250.0);
+    std::vector<double> volumes(n);
+    
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            prices[i] += change_dist(gen);
+            if (prices[i] < 1.0) prices[i] = 1.0;
+            volumes[i] = volume_dist(gen);
+        }
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::DoNotOptimize(volumes.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IterationMt19937)->Apply(symbolArgs);
+
+// Batch random walk: normals, volume uniforms, one vectorized step
+void BM_IterationBatchWalk(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    rng::LaneState lanes;
+    rng::seed(lanes, 42);
+    std::vector<double> prices(n, 250.0), normals(n), uniforms(n), changes(n);
+    
+    for (auto _ : state) {
+        rng::fillNormal(lanes, normals.data(), n);
+        rng::fillUniform(lanes, uniforms.data(), n);
+        rng::walkStep(prices.data(), normals.data(), 0.5, 1.0, changes.data(), n);
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::DoNotOptimize(uniforms.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(rng::activeIsa());
+}
+BENCHMARK(BM_IterationBatchWalk)->Apply(symbolArgs);
+
+// Batch GBM with per-symbol drift and volatility
+void BM_IterationBatchGbm(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    rng::LaneState lanes;
+    rng::seed(lanes, 42);
+    std::vector<double> prices(n, 250.0), normals(n), uniforms(n), changes(n);
+    std::vector<double> drift(n, 1e-7), vol(n, 1e-3);
+    
+    for (auto _ : state) {
+        rng::fillNormal(lanes, normals.data(), n);
+        rng::fillUniform(lanes, uniforms.data(), n);
+        rng::gbmStep(prices.data(), normals.data(), drift.data(), vol.data(), changes.data(), n);
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::DoNotOptimize(uniforms.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(rng::activeIsa());
+}
+BENCHMARK(BM_IterationBatchGbm)->Apply(symbolArgs);
+
+// The normal draws alone: std::normal_distribution vs the batch kernel,
+// with the scalar fallback for reference
+void BM_NormalMt19937(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::mt19937 gen(42);
+    std::normal_distribution<> dist(0.0, 1.0);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        for (auto& z : out) z = dist(gen);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NormalMt19937)->Arg(4096);
+
+void BM_NormalBatch(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    rng::LaneState lanes;
+    rng::seed(lanes, 42);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        rng::fillNormal(lanes, out.data(), n);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(rng::activeIsa());
+}
+BENCHMARK(BM_NormalBatch)->Arg(4096);
+
+void BM_NormalBatchScalar(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    rng::LaneState lanes;
+    rng::seed(lanes, 42);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        rng::fillNormalScalar(lanes, out.data(), n);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NormalBatchScalar)->Arg(4096);
+
+}  // namespace
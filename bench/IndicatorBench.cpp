@@ -0,0 +1,329 @@
+// Indicator microbenchmarks: the streaming SMA / volatility updates the
+// calculators use, against recomputing each window from scratch, the
+// compile-time sized windows against the runtime-sized ones, the raw SIMD
+// kernels, and a fused indicator pass against separate calculators.
+
+#include "BenchUtil.h"
+#include "RollingWindow.h"
+#include "SimdKernels.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "SMACalculator.h"
+#include "VolatilityCalculator.h"
+#include "FusedIndicatorCalculator.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Random-walk prices, like PriceGenerator produces
+std::vector<double> makePrices(size_t n) {
+    std::mt19937 gen(42);
+    std::normal_distribution<> step(0.0, 0.5);
+    std::vector<double> prices(n);
+    double price = 250.0;
+    for (auto& p : prices) {
+        price += step(gen);
+        if (price < 1.0) price = 1.0;
+        p = price;
+    }
+    return prices;
+}
+
+constexpr size_t kStream = 4096;    // Ticks cycled through per benchmark
+
+void windowArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("window");
+    for (int window : {10, 20, 50, 200, 1000}) b->Arg(window);
+}
+
+void sizeArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("n");
+    b->RangeMultiplier(4)->Range(16, 4096);
+}
+
+// Streaming SMA: one push + O(1) mean per tick (SMACalculator)
+void BM_SmaRolling(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    std::vector<double> prices = makePrices(kStream);
+    RollingWindow sma(window);
+    for (size_t i = 0; i < window; ++i) sma.push(prices[i % kStream]);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        sma.push(prices[i]);
+        benchmark::DoNotOptimize(sma.mean());
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SmaRolling)->Apply(windowArgs);
+
+// Baseline: re-sum the whole window on every tick
+void BM_SmaRecompute(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    std::vector<double> prices = makePrices(kStream + window);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        double sma = simd::sum(prices.data() + i, window) / window;
+        benchmark::DoNotOptimize(sma);
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(simd::activeIsa());
+}
+BENCHMARK(BM_SmaRecompute)->Apply(windowArgs);
+
+// Streaming volatility: one return + O(1) variance per tick (VolatilityCalculator)
+void BM_VolatilityRolling(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    std::vector<double> prices = makePrices(kStream + 1);
+    RollingWindow returns(window - 1);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        returns.push((prices[i + 1] - prices[i]) / prices[i]);
+        benchmark::DoNotOptimize(std::sqrt(returns.variance()));
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VolatilityRolling)->Apply(windowArgs);
+
+// Baseline: recompute returns and their variance over the window every tick
+void BM_VolatilityRecompute(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    std::vector<double> prices = makePrices(kStream + window);
+    std::vector<double> returns(window - 1);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        simd::returns(prices.data() + i, window, returns.data());
+        double mean = simd::sum(returns.data(), returns.size()) / returns.size();
+        double variance = simd::sumSquaredDeviations(returns.data(), returns.size(), mean) / returns.size();
+        benchmark::DoNotOptimize(std::sqrt(variance));
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(simd::activeIsa());
+}
+BENCHMARK(BM_VolatilityRecompute)->Apply(windowArgs);
+
+// Catch-up path: fold a whole batch of new ticks into a window at once
+void BM_SmaPushBatch(benchmark::State& state) {
+    size_t window = static_cast<size_t>(state.range(0));
+    std::vector<double> prices = makePrices(kStream);
+    RollingWindow sma(window);
+    const size_t batch = 64;
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        sma.pushBatch(prices.data() + i, batch);
+        benchmark::DoNotOptimize(sma.mean());
+        i = (i + batch) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_SmaPushBatch)->Apply(windowArgs);
+
+// The same three with the window fixed at compile time (FixedRollingWindow),
+// for the windows makeWindowKernel() specializes; compare with the
+// window:N rows above
+template <size_t N>
+void BM_SmaRollingFixed(benchmark::State& state) {
+    std::vector<double> prices = makePrices(kStream);
+    FixedRollingWindow<N> sma;
+    for (size_t i = 0; i < N; ++i) sma.push(prices[i % kStream]);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        sma.push(prices[i]);
+        benchmark::DoNotOptimize(sma.mean());
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_SmaRollingFixed, 10);
+BENCHMARK_TEMPLATE(BM_SmaRollingFixed, 20);
+BENCHMARK_TEMPLATE(BM_SmaRollingFixed, 50);
+BENCHMARK_TEMPLATE(BM_SmaRollingFixed, 200);
+
+template <size_t N>
+void BM_VolatilityRollingFixed(benchmark::State& state) {
+    std::vector<double> prices = makePrices(kStream + 1);
+    FixedRollingWindow<N - 1> returns;
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        returns.push((prices[i + 1] - prices[i]) / prices[i]);
+        benchmark::DoNotOptimize(std::sqrt(returns.variance()));
+        i = (i + 1) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_VolatilityRollingFixed, 10);
+BENCHMARK_TEMPLATE(BM_VolatilityRollingFixed, 20);
+BENCHMARK_TEMPLATE(BM_VolatilityRollingFixed, 50);
+BENCHMARK_TEMPLATE(BM_VolatilityRollingFixed, 200);
+
+template <size_t N>
+void BM_SmaPushBatchFixed(benchmark::State& state) {
+    std::vector<double> prices = makePrices(kStream);
+    FixedRollingWindow<N> sma;
+    const size_t batch = 64;
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        sma.pushBatch(prices.data() + i, batch);
+        benchmark::DoNotOptimize(sma.mean());
+        i = (i + batch) & (kStream - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK_TEMPLATE(BM_SmaPushBatchFixed, 10);
+BENCHMARK_TEMPLATE(BM_SmaPushBatchFixed, 20);
+BENCHMARK_TEMPLATE(BM_SmaPushBatchFixed, 50);
+BENCHMARK_TEMPLATE(BM_SmaPushBatchFixed, 200);
+
+void BM_KernelSum(benchmark::State& state) {
+    std::vector<double> x = makePrices(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simd::sum(x.data(), x.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::activeIsa());
+}
+BENCHMARK(BM_KernelSum)->Apply(sizeArgs);
+
+void BM_KernelSumSquaredDeviations(benchmark::State& state) {
+    std::vector<double> x = makePrices(static_cast<size_t>(state.range(0)));
+    double mean = simd::sum(x.data(), x.size()) / x.size();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simd::sumSquaredDeviations(x.data(), x.size(), mean));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::activeIsa());
+}
+BENCHMARK(BM_KernelSumSquaredDeviations)->Apply(sizeArgs);
+
+void BM_KernelReturns(benchmark::State& state) {
+    std::vector<double> x = makePrices(static_cast<size_t>(state.range(0)));
+    std::vector<double> out(x.size() - 1);
+    for (auto _ : state) {
+        simd::returns(x.data(), x.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::activeIsa());
+}
+BENCHMARK(BM_KernelReturns)->Apply(sizeArgs);
+
+// One generator iteration (a tick per symbol) followed by an indicator pass
+// over every symbol. Both variants pay the same push; the difference is one
+// read and walk per indicator versus one for all of them.
+void passArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("symbols");
+    for (int symbols : {5, 500}) b->Arg(symbols);
+}
+
+void publishIteration(SharedBuffer& buffer, std::vector<PriceData>& batch,
+                      const std::vector<double>& prices, size_t& i) {
+    for (auto& tick : batch) {
+        tick.price = prices[i];
+        tick.volume = 100.0;
+        i = (i + 1) & (kStream - 1);
+    }
+    buffer.pushBatch(batch);
+}
+
+// Baseline: SMACalculator and VolatilityCalculator, each reading on its own
+void BM_SeparatePass(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(0)));
+    SharedBuffer buffer(registry, 100, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    bench::QuietStdout quiet;
+    SMACalculator sma(buffer, monitor, 20);
+    VolatilityCalculator volatility(buffer, monitor, 20);
+    
+    std::vector<double> prices = makePrices(kStream);
+    std::vector<PriceData> batch;
+    for (size_t id = 0; id < registry.size(); ++id) batch.emplace_back(static_cast<SymbolId>(id), 0.0, 0.0);
+    size_t i = 0;
+    for (auto _ : state) {
+        publishIteration(buffer, batch, prices, i);
+        for (size_t id = 0; id < registry.size(); ++id) {
+            sma.calculateSymbol(static_cast<SymbolId>(id));
+            volatility.calculateSymbol(static_cast<SymbolId>(id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SeparatePass)->Apply(passArgs);
+
+// FusedIndicatorCalculator with the same two indicators, then all five
+void BM_FusedPass(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(static_cast<size_t>(state.range(0)));
+    SharedBuffer buffer(registry, 100, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    bench::QuietStdout quiet;
+    FusedIndicatorCalculator fused(buffer, monitor);
+    fused.add<SmaKernel>(20);
+    fused.add<VolatilityKernel>(20);
+    if (state.range(1) > 2) {
+        fused.add<EmaKernel>(20);
+        fused.add<VwapKernel>(20);
+        fused.add<RsiKernel>(14);
+    }
+    
+    std::vector<double> prices = makePrices(kStream);
+    std::vector<PriceData> batch;
+    for (size_t id = 0; id < registry.size(); ++id) batch.emplace_back(static_cast<SymbolId>(id), 0.0, 0.0);
+    size_t i = 0;
+    for (auto _ : state) {
+        publishIteration(buffer, batch, prices, i);
+        for (size_t id = 0; id < registry.size(); ++id) {
+            fused.calculateSymbol(static_cast<SymbolId>(id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FusedPass)
+    ->ArgNames({"symbols", "kernels"})
+    ->ArgsProduct({{5, 500}, {2, 5}});
+
+// The windowed kernels (SMA, volatility, VWAP) built by makeWindowKernel(),
+// runtime-sized (fixed:0) against compile-time sized (fixed:1)
+void BM_FusedWindowKernels(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(500);
+    SharedBuffer buffer(registry, 100, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    bench::QuietStdout quiet;
+    FusedIndicatorCalculator fused(buffer, monitor);
+    size_t window = static_cast<size_t>(state.range(0));
+    bool specialized = state.range(1) != 0;
+    fused.addKernel(makeWindowKernel<BasicSmaKernel>(window, specialized));
+    fused.addKernel(makeWindowKernel<BasicVolatilityKernel>(window, specialized));
+    fused.addKernel(makeWindowKernel<BasicVwapKernel>(window, specialized));
+    
+    std::vector<double> prices = makePrices(kStream);
+    std::vector<PriceData> batch;
+    for (size_t id = 0; id < registry.size(); ++id) batch.emplace_back(static_cast<SymbolId>(id), 0.0, 0.0);
+    size_t i = 0;
+    for (auto _ : state) {
+        publishIteration(buffer, batch, prices, i);
+        for (size_t id = 0; id < registry.size(); ++id) {
+            fused.calculateSymbol(static_cast<SymbolId>(id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * registry.size());
+}
+BENCHMARK(BM_FusedWindowKernels)
+    ->ArgNames({"window", "fixed"})
+    ->ArgsProduct({{20, 200}, {0, 1}});
+
+}  // namespace
@@ -0,0 +1,64 @@
+// PerformanceMonitor microbenchmarks: cost of the latency record path that
+// every calculator hits once per calculation.
+
+#include "BenchUtil.h"
+#include "PerformanceMonitor.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace {
+
+std::unique_ptr<SymbolRegistry> g_registry;
+std::unique_ptr<PerformanceMonitor> g_monitor;
+OperationId g_operation = 0;
+
+// recordProcessing() from `threads` calculator threads at once, each cycling
+// over `symbols` symbols. The monitor is shared by all benchmark threads.
+void BM_RecordProcessing(benchmark::State& state) {
+    size_t symbols = static_cast<size_t>(state.range(0));
+    if (state.thread_index() == 0) {
+        g_registry = std::make_unique<SymbolRegistry>(bench::makeRegistry(symbols));
+        g_monitor = std::make_unique<PerformanceMonitor>(*g_registry);
+        g_operation = g_monitor->registerOperation("SMA");
+    }
+    
+    auto generated = TickClock::now();
+    auto processed = generated + std::chrono::microseconds(25);
+    SymbolId symbol = static_cast<SymbolId>(state.thread_index() % symbols);
+    for (auto _ : state) {
+        g_monitor->recordProcessing(symbol, g_operation, generated, processed);
+        symbol = (symbol + 1 == symbols) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    
+    if (state.thread_index() == 0) {
+        state.counters["samples"] = static_cast<double>(
+            g_monitor->getLatencySummary(0, g_operation).count);
+    }
+}
+BENCHMARK(BM_RecordProcessing)
+    ->ArgName("symbols")
+    ->Arg(5)->Arg(500)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Name-based overload (looks the operation up on every call)
+void BM_RecordProcessingByName(benchmark::State& state) {
+    SymbolRegistry registry = bench::makeRegistry(5);
+    PerformanceMonitor monitor(registry);
+    monitor.registerOperation("SMA");
+    monitor.registerOperation("Volatility");
+    
+    auto generated = TickClock::now();
+    auto processed = generated + std::chrono::microseconds(25);
+    SymbolId symbol = 0;
+    for (auto _ : state) {
+        monitor.recordProcessing(symbol, "Volatility", generated, processed);
+        symbol = (symbol + 1 == 5) ? 0 : symbol + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordProcessingByName);
+
+}  // namespace
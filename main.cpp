@@ -1,30 +1,124 @@
 // Entry point for the real-time stock price simulator.
 
+#include "SymbolRegistry.h"
 #include "SharedBuffer.h"
 #include "PriceGenerator.h"
+#include "TickReplayer.h"
+#include "MulticastFeed.h"
 #include "DisplayThread.h"
 #include "SMACalculator.h"
 #include "VolatilityCalculator.h"
+#include "FusedIndicatorCalculator.h"
+#include "CorrelationCalculator.h"
+#include "IndicatorScheduler.h"
+#include "WorkStealingExecutor.h"
 #include "PerformanceMonitor.h"
+#include "Checkpoint.h"
+#include "SimulatorConfig.h"
+#include "ThreadPlacement.h"
+#include "IndicatorSink.h"
+#include "Trace.h"
+#include "SimdKernels.h"
 
+// The one translation unit that defines the counting operator new/delete
+// (only active when built with STOCK_SIMULATOR_COUNT_ALLOCATIONS)
+#define STOCK_SIMULATOR_DEFINE_ALLOCATION_HOOKS
+#include "AllocationCounter.h"
+
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
+#include <cstdio>
 #include <vector>
 #include <string>
 #include <thread>
 #include <chrono>
 #include <csignal>
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <stdexcept>
 
 // Global flag for graceful shutdown on Ctrl+C
 std::atomic<bool> g_shutdown_requested(false);
 
+// Set by SIGUSR1 (--trace): the main loop writes a trace snapshot
+std::atomic<bool> g_trace_dump_requested(false);
+
 void signalHandler(int signal) {
     if (signal == SIGINT) {
         std::cout << "\n\n[Main] Shutdown signal received (Ctrl+C)...\n";
         g_shutdown_requested.store(true);
     }
+#ifdef SIGUSR1
+    if (signal == SIGUSR1) {
+        g_trace_dump_requested.store(true);
+    }
+#endif
+}
+
+// Write the spans recorded so far to path (--trace)
+void writeTrace(const std::string& path) {
+    trace::ExportStats stats;
+    std::string error;
+    if (trace::writeChromeTrace(path, stats, error)) {
+        std::cout << "[Main] Trace: " << stats.spans << " spans from " << stats.threads << " threads ("
+                  << stats.overwritten << " older ones overwritten) written to " << path << "\n";
+    } else {
+        std::cerr << "[Main] Cannot write trace " << path << ": " << error << "\n";
+    }
 }
 
+// Intraday listings for --churn=N: every second the N longest-listed
+// symbols are delisted and N others listed, fresh names (L1, L2, ...)
+// while the registry has spare slots, then the longest-delisted ones again.
+// Starts from the current listings (a restored checkpoint may have some
+// symbols delisted and fresh names taken already).
+class ListingChurn {
+private:
+    SharedBuffer& buffer_;
+    size_t per_second_;
+    size_t next_name_ = 1;
+    std::deque<SymbolId> listed_;       // Oldest listing first
+    std::deque<SymbolId> delisted_;     // Oldest delisting first
+
+public:
+    ListingChurn(SharedBuffer& buffer, size_t per_second) : buffer_(buffer), per_second_(per_second) {
+        SymbolTable::Reader listed(buffer.symbolTable());
+        std::vector<uint8_t> is_listed(buffer.registry().capacity(), 0);
+        for (SymbolId id : listed.symbols()) is_listed[id] = 1;
+        for (size_t id = 0; id < buffer.registry().size(); ++id) {
+            (is_listed[id] ? listed_ : delisted_).push_back(static_cast<SymbolId>(id));
+        }
+    }
+    
+    void step() {
+        const SymbolRegistry& registry = buffer_.registry();
+        std::vector<SymbolId> delist;
+        while (delist.size() < per_second_ && !listed_.empty()) {
+            delist.push_back(listed_.front());
+            listed_.pop_front();
+        }
+        std::vector<std::string> list;
+        size_t spare = registry.capacity() - registry.size();
+        while (list.size() < std::min(per_second_, spare)) {
+            std::string name = "L" + std::to_string(next_name_++);
+            if (registry.find(name) == kInvalidSymbolId) list.push_back(name);
+        }
+        while (list.size() < per_second_ && !delisted_.empty()) {
+            list.push_back(registry.name(delisted_.front()));
+            delisted_.pop_front();
+        }
+        
+        std::vector<SymbolId> ids;
+        buffer_.updateListings(list, delist, &ids);
+        for (SymbolId id : ids) {
+            if (id != kInvalidSymbolId) listed_.push_back(id);
+        }
+        delisted_.insert(delisted_.end(), delist.begin(), delist.end());
+    }
+};
+
 /**
  * @brief Main application entry point
  * 
@@ -52,21 +146,10 @@ int main(int argc, char* argv[]) {
     std::cout << "  - High-Resolution Performance Measurement\n";
     std::cout << "\n========================================================\n\n";
     
-    // Parse command-line arguments (optional: runtime duration)
-    int runtime_seconds = 45;  // Default: 45 seconds
-    if (argc > 1) {
-        try {
-            runtime_seconds = std::stoi(argv[1]);
-            if (runtime_seconds < 5 || runtime_seconds > 300) {
-                std::cerr << "Runtime must be between 5 and 300 seconds. Using default (30s).\n";
-                runtime_seconds = 30;
-            }
-        } catch (...) {
-            std::cerr << "Invalid runtime argument. Using default (30s).\n";
-        }
-    }
+    // Options from the command line and --config files (see SimulatorConfig.h)
+    SimulatorConfig config = SimulatorConfig::fromArgs(argc, argv);
     
-    std::cout << "[Main] Simulation will run for " << runtime_seconds << " seconds\n";
+    std::cout << "[Main] Simulation will run for " << config.runtime_seconds << " seconds\n";
     std::cout << "[Main] Press Ctrl+C to stop early and view performance report\n\n";
     
     // ============================================================
@@ -75,18 +158,127 @@ int main(int argc, char* argv[]) {
     
     std::cout << "[Main] Initializing shared resources...\n";
     
-    // Thread-safe circular buffer (max 100 price ticks per symbol)
-    SharedBuffer shared_buffer(100);
+    // Stock symbols to simulate (--symbols=N generates S1..SN instead)
+    std::vector<std::string> symbols = {"AAPL", "GOOGL", "MSFT", "AMZN", "BTC"};
+    if (config.symbol_count > 0) {
+        symbols.clear();
+        for (size_t i = 1; i <= config.symbol_count; ++i) {
+            symbols.push_back("S" + std::to_string(i));
+        }
+    }
     
-    // Performance monitoring system
-    PerformanceMonitor perf_monitor;
+    // Replay: map the tick file up front; its symbol table replaces the defaults
+    std::unique_ptr<MappedTickFile> replay_file;
+    if (!config.replay_path.empty()) {
+        try {
+            replay_file = std::make_unique<MappedTickFile>(config.replay_path);
+        } catch (const std::exception& e) {
+            std::cerr << "[Main] Cannot open replay file: " << e.what() << "\n";
+            return 1;
+        }
+        symbols = replay_file->symbols();
+        std::cout << "[Main] Replaying " << replay_file->size() << " ticks from " << config.replay_path << "\n";
+    }
     
-    // Stock symbols to simulate
-    std::vector<std::string> symbols = {"AAPL", "GOOGL", "MSFT", "AMZN", "BTC"};
+    // Live feed (--feed=GROUP:PORT): packets name symbols by their index in
+    // the list above, so publisher and simulator must agree on --symbols
+    FeedEndpoint feed_endpoint;
+    bool use_feed = !config.feed_address.empty();
+    if (use_feed && replay_file) {
+        std::cerr << "[Main] --feed ignored: replaying " << config.replay_path << "\n";
+        use_feed = false;
+    }
+    if (use_feed) {
+        if (!FeedEndpoint::parse(config.feed_address, feed_endpoint) ||
+            (!config.feed_interface.empty() &&
+             inet_pton(AF_INET, config.feed_interface.c_str(), &feed_endpoint.interface_address) != 1)) {
+            std::cerr << "[Main] Invalid feed '" << config.feed_address
+                      << "' (IPv4 GROUP:PORT, --feed-interface=IPv4 address)\n";
+            return 1;
+        }
+    }
+    
+    // Intern symbols once; everything downstream works on dense IDs. Spare
+    // slots (--symbol-capacity=N) take symbols listed at runtime (--churn=N)
+    SymbolRegistry symbol_registry(symbols, config.symbolCapacity(symbols.size()));
+    
+    // Thread-safe circular buffer (--history=N price ticks per symbol, default 100)
+    // LockFree mode gives each symbol its own single-writer ring; pass
+    // --buffer=mutex to run the original single-mutex design instead.
+    // With --bars=N (or --resolution=1s|1m|5m|1h) every push also updates
+    // the symbol's 1s/1m/5m/1h OHLCV bars, N closed bars kept per level.
+    SharedBuffer shared_buffer(symbol_registry, config.history_size, config.buffer_mode, config.barHistory());
+    
+    std::cout << "[Main] Shared buffer mode: "
+              << (config.buffer_mode == BufferMode::LockFree ? "lock-free rings" : "mutex")
+              << " (" << symbols.size() << " symbols x " << config.history_size << " ticks, "
+              << shared_buffer.storageBytes() / 1024 << " KB preallocated)\n";
+    if (shared_buffer.hasBars()) {
+        std::cout << "[Main] OHLCV bars: 1s/1m/5m/1h, " << shared_buffer.barHistoryLimit()
+                  << " closed bars per level; indicators run on "
+                  << barResolutionName(config.resolution) << "\n";
+    }
+    
+    if (symbol_registry.capacity() > symbols.size()) {
+        std::cout << "[Main] Symbol slots: " << symbol_registry.capacity() << " ("
+                  << symbol_registry.capacity() - symbols.size() << " spare for runtime listings)\n";
+    }
+    
+    std::cout << "[Main] Indicator kernels: " << simd::activeIsa() << "\n";
+    
+    // Latency clock: calibrated cycle counter unless --clock=steady (before any thread starts)
+    CycleClock::init(config.clock_source);
+    std::cout << "[Main] Latency clock: " << CycleClock::name();
+    if (CycleClock::usesCounter()) {
+        std::cout << " @ " << std::fixed << std::setprecision(3) << CycleClock::counterGhz() << " GHz";
+    }
+    std::cout << "\n";
+    
+    // Thread placement (--pin=auto, --pin-producer=0-1, ...): each thread
+    // pins itself to its role's CPUs when it starts (before any thread starts)
+    ThreadPlacement::configure(config.placement);
+    std::cout << "[Main] Thread placement: " << ThreadPlacement::describe() << "\n";
+    
+    // Pipeline trace (--trace=FILE): spans record from here on, in builds
+    // configured with -DSTOCK_SIMULATOR_TRACING=ON; written at exit and on SIGUSR1
+    if (!config.trace_path.empty()) {
+        if (trace::start()) {
+            trace::nameThread("main");
+#ifdef SIGUSR1
+            std::signal(SIGUSR1, signalHandler);
+#endif
+            std::cout << "[Main] Tracing to " << config.trace_path << " (SIGUSR1 writes a snapshot)\n";
+        } else {
+            std::cerr << "[Main] --trace ignored: built without STOCK_SIMULATOR_TRACING\n";
+        }
+    }
+    
+    // Warm restart (--checkpoint=FILE): refill the rings from the last
+    // checkpoint before any thread starts (indicator state follows once the
+    // calculators exist). A replay always starts from its file instead.
+    std::unique_ptr<MappedCheckpoint> checkpoint;
+    auto restore_start = std::chrono::steady_clock::now();
+    if (!config.checkpoint_path.empty() && !replay_file && ::access(config.checkpoint_path.c_str(), F_OK) == 0) {
+        try {
+            checkpoint = std::make_unique<MappedCheckpoint>(config.checkpoint_path);
+            size_t restored = checkpoint->restoreBuffer(shared_buffer);
+            std::cout << "[Main] Restored " << restored << " ticks from checkpoint "
+                      << checkpoint->number() << " (" << config.checkpoint_path << ")\n";
+        } catch (const std::exception& e) {
+            std::cerr << "[Main] Ignoring checkpoint, starting cold: " << e.what() << "\n";
+            checkpoint.reset();
+        }
+    }
+    
+    // Performance monitoring system
+    PerformanceMonitor perf_monitor(symbol_registry);
     
     std::cout << "[Main] Tracking symbols: ";
-    for (const auto& sym : symbols) {
-        std::cout << sym << " ";
+    for (size_t i = 0; i < symbols.size() && i < 10; ++i) {
+        std::cout << symbols[i] << " ";
+    }
+    if (symbols.size() > 10) {
+        std::cout << "... (" << symbols.size() << " total)";
     }
     std::cout << "\n\n";
     
@@ -96,21 +288,181 @@ int main(int argc, char* argv[]) {
     
     std::cout << "[Main] Creating thread objects...\n";
     
-    // Thread 1: Producer (Price Generator)
-    // Generates random prices every 100ms
-    PriceGenerator price_generator(shared_buffer, perf_monitor, symbols, 100);
+    // Thread 1: Producer (Price Generator, Tick Replayer or feed receiver)
+    // Generates random prices every --interval-ms (default 100ms; 0 spins),
+    // split across --producers threads, as a random walk or GBM (--model=gbm),
+    // replays a recorded tick file (--replay=FILE, --replay-speed=N|max)
+    // or receives a UDP feed (--feed=GROUP:PORT, --feed-busy-poll=USEC)
+    std::unique_ptr<TickSource> tick_source;
+    if (replay_file) {
+        tick_source = std::make_unique<TickReplayer>(shared_buffer, perf_monitor,
+                                                     *replay_file, config.replay_speed);
+    } else if (use_feed) {
+        try {
+            tick_source = std::make_unique<MulticastTickReceiver>(shared_buffer, perf_monitor, feed_endpoint,
+                                                                  config.feed_busy_poll_us);
+        } catch (const std::exception& e) {
+            std::cerr << "[Main] Cannot receive feed: " << e.what() << "\n";
+            return 1;
+        }
+        std::cout << "[Main] Receiving ticks from " << feed_endpoint.describe()
+                  << (feed_endpoint.multicast() ? " (multicast)\n" : " (unicast)\n");
+    } else {
+        auto generator = std::make_unique<PriceGenerator>(shared_buffer, perf_monitor,
+                                                          std::vector<SymbolId>{}, config.generator_interval_ms,
+                                                          config.producer_shards, config.partition);
+        if (config.price_model == PriceModel::Gbm) {
+            generator->useGbm(config.gbm);
+        }
+        tick_source = std::move(generator);
+    }
     
     // Thread 2: Consumer (Display)
-    // Updates console display every 500ms
-    DisplayThread display_thread(shared_buffer, 500);
+    // Updates console display every 500ms (--display=off for throughput runs)
+    std::unique_ptr<DisplayThread> display_thread;
+    if (config.display) {
+        display_thread = std::make_unique<DisplayThread>(shared_buffer, 500);
+    }
+    
+    // Threads 3+: Consumers (Indicators)
+    // Default (--indicators=fused): one calculator updates SMA, EMA,
+    // volatility and VWAP over --window ticks (20) and RSI over --rsi-period
+    // changes (14) from a single read and pass over each
+    // symbol's new ticks, every 1000ms (Poll) or on every new tick (Notify,
+    // the default; --wake=poll restores the interval).
+    // Windows of 10, 20, 50 or 200 use the compile-time sized kernels
+    // (--window-kernels=runtime forces the runtime-sized ones).
+    // --indicators=separate runs the SMA (1000ms) and volatility (1500ms)
+    // calculators instead, each reading the buffer on its own.
+    // --resolution=1s|1m|5m|1h feeds them closed bars instead of ticks, so
+    // the same windows span seconds to days.
+    std::unique_ptr<FusedIndicatorCalculator> fused_calculator;
+    std::unique_ptr<SMACalculator> sma_calculator;
+    std::unique_ptr<VolatilityCalculator> volatility_calculator;
+    if (config.fused_indicators) {
+        fused_calculator = std::make_unique<FusedIndicatorCalculator>(shared_buffer, perf_monitor,
+                                                                      1000, config.wake_mode, config.resolution);
+        fused_calculator->addKernel(makeWindowKernel<BasicSmaKernel>(config.window, config.fixed_windows));
+        fused_calculator->add<EmaKernel>(config.window);
+        fused_calculator->addKernel(makeWindowKernel<BasicVolatilityKernel>(config.window, config.fixed_windows));
+        fused_calculator->addKernel(makeWindowKernel<BasicVwapKernel>(config.window, config.fixed_windows));
+        fused_calculator->add<RsiKernel>(config.rsi_period);
+    } else {
+        sma_calculator = std::make_unique<SMACalculator>(shared_buffer, perf_monitor, config.window, 1000,
+                                                         config.wake_mode, config.resolution);
+        volatility_calculator = std::make_unique<VolatilityCalculator>(shared_buffer, perf_monitor,
+                                                                       config.window, 1500, config.wake_mode,
+                                                                       config.resolution);
+    }
+    
+    // Indicators resume from the checkpoint instead of warming up again
+    std::vector<IndicatorTask*> indicators;
+    if (fused_calculator) {
+        indicators.push_back(fused_calculator.get());
+    } else {
+        indicators.push_back(sma_calculator.get());
+        indicators.push_back(volatility_calculator.get());
+    }
     
-    // Thread 3: Consumer (SMA Calculator)
-    // Calculates 20-period moving average every 1000ms
-    SMACalculator sma_calculator(shared_buffer, perf_monitor, 20, 1000);
+    // What the buffer does when an indicator falls behind (--overload=,
+    // --lag-limit=): drop the oldest unread ticks (default), conflate to
+    // the latest one, or hold the producer back
+    for (IndicatorTask* indicator : indicators) {
+        OverloadPolicy policy = config.overloadPolicyFor(indicator->name());
+        if (policy != OverloadPolicy::DropOldest && config.resolution != BarResolution::Tick) {
+            std::cerr << "[Main] " << indicator->name() << ": --overload only applies to tick indicators\n";
+            continue;
+        }
+        shared_buffer.setOverloadPolicy(indicator->consumerId(), policy, config.lag_limit);
+        if (policy != OverloadPolicy::DropOldest) {
+            std::cout << "[Main] " << indicator->name() << ": overload policy " << overloadPolicyName(policy)
+                      << " beyond " << (config.lag_limit ? config.lag_limit : shared_buffer.defaultLagLimit())
+                      << " unread ticks per symbol\n";
+        }
+    }
     
-    // Thread 4: Consumer (Volatility Calculator)
-    // Calculates volatility every 1500ms
-    VolatilityCalculator volatility_calculator(shared_buffer, perf_monitor, 20, 1500);
+    if (checkpoint) {
+        for (IndicatorTask* indicator : indicators) {
+            bool warm = checkpoint->restoreIndicator(*indicator);
+            std::cout << "[Main] " << indicator->name() << ": "
+                      << (warm ? "state restored" : "no matching checkpoint state, warming up") << "\n";
+        }
+        checkpoint.reset();     // Unmap
+        std::cout << "[Main] Warm restart took " << std::fixed << std::setprecision(2)
+                  << std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - restore_start).count() << " ms\n";
+    }
+    
+    // Indicator results as binary records (--output=FILE or --output-shm=PATH),
+    // written by a thread of their own; the console shows a sample
+    // (--indicator-log=N, off for --stress)
+    std::unique_ptr<IndicatorSink> indicator_sink;
+    if (!config.output_path.empty() || !config.output_shm_path.empty()) {
+        std::unique_ptr<IndicatorTarget> target;
+        if (!config.output_path.empty()) {
+            if (!config.output_shm_path.empty()) {
+                std::cerr << "[Main] Both --output and --output-shm given; writing " << config.output_path << "\n";
+            }
+            target = std::make_unique<IndicatorFileTarget>(config.output_path);
+        } else {
+            target = std::make_unique<IndicatorQueueTarget>(config.output_shm_path, config.output_queue_capacity);
+        }
+        indicator_sink = std::make_unique<IndicatorSink>(symbol_registry, std::move(target));
+        for (IndicatorTask* indicator : indicators) {
+            indicator->attachOutput(*indicator_sink);
+        }
+    }
+    if (config.indicator_log_every >= 0) {
+        for (IndicatorTask* indicator : indicators) {
+            indicator->setLogEvery(static_cast<size_t>(config.indicator_log_every));
+        }
+    }
+    
+    // Periodic checkpoints, written off the tick path (--checkpoint=FILE,
+    // --checkpoint-interval=SECONDS)
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (!config.checkpoint_path.empty()) {
+        checkpointer = std::make_unique<Checkpointer>(shared_buffer, config.checkpoint_path,
+                                                      config.checkpoint_interval_seconds * 1000);
+        for (IndicatorTask* indicator : indicators) {
+            checkpointer->addIndicator(*indicator);
+        }
+    }
+    
+    // With --workers=N (default), the calculators don't get threads of their
+    // own: they run as per-symbol tasks on a shared work-stealing pool.
+    // --workers=0 keeps one dedicated thread per calculator.
+    std::unique_ptr<WorkStealingExecutor> executor;
+    std::unique_ptr<IndicatorScheduler> indicator_scheduler;
+    if (config.indicator_workers > 0) {
+        executor = std::make_unique<WorkStealingExecutor>(config.indicator_workers);
+        indicator_scheduler = std::make_unique<IndicatorScheduler>(shared_buffer, *executor, config.wake_mode);
+        if (fused_calculator) {
+            indicator_scheduler->registerIndicator(*fused_calculator, 1000);
+        } else {
+            indicator_scheduler->registerIndicator(*sma_calculator, 1000);
+            indicator_scheduler->registerIndicator(*volatility_calculator, 1500);
+        }
+    }
+    
+    // --correlation=MS: a rolling correlation matrix of all symbols' returns,
+    // sampled every MS over the last --correlation-window samples (100),
+    // its sweeps split over the indicator workers
+    std::unique_ptr<CorrelationCalculator> correlation_calculator;
+    if (config.correlation_interval_ms > 0) {
+        size_t matrix_bytes = CorrelationCalculator::memoryBytes(shared_buffer, config.correlation_window);
+        if (matrix_bytes > CorrelationCalculator::kMaxMatrixBytes) {
+            std::cerr << "[Main] A correlation matrix over " << symbol_registry.capacity() << " symbol slots needs "
+                      << matrix_bytes / (1024 * 1024) << " MB (at most "
+                      << CorrelationCalculator::kMaxMatrixBytes / (1024 * 1024) << " MB); running without it\n";
+        } else {
+            correlation_calculator = std::make_unique<CorrelationCalculator>(
+                shared_buffer, config.correlation_window, config.correlation_interval_ms, executor.get());
+            if (config.indicator_log_every == 0) correlation_calculator->setLogEvery(0);
+            std::cout << "[Main] Correlation matrix: " << symbol_registry.capacity() << " symbol slots, "
+                      << matrix_bytes / (1024 * 1024) << " MB\n";
+        }
+    }
     
     // ============================================================
     // STEP 3: Start all threads
@@ -118,19 +470,51 @@ int main(int argc, char* argv[]) {
     
     std::cout << "\n[Main] Starting all threads...\n\n";
     
+    // Output first, so no result is emitted before it exists
+    if (indicator_sink) {
+        try {
+            indicator_sink->start();
+        } catch (const std::exception& e) {
+            std::cerr << "[Main] Cannot create indicator output: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    
+    // --quiet (and --stress): component logs would cost more than they
+    // show at high rates, so std::cout stays muted until shutdown and the
+    // main thread prints one progress line per second instead
+    if (config.quiet) {
+        std::cout << "[Main] Component logs muted (--quiet); progress every second\n" << std::flush;
+        std::cout.setstate(std::ios::failbit);
+    }
+    
     // Start producer
-    price_generator.start();
+    tick_source->start();
     
     // Small delay to ensure some data is generated before consumers start
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
     
     // Start consumers
-    display_thread.start();
-    sma_calculator.start();
-    volatility_calculator.start();
+    if (display_thread) {
+        display_thread->start();
+    }
+    if (indicator_scheduler) {
+        indicator_scheduler->start();
+    } else if (fused_calculator) {
+        fused_calculator->start();
+    } else {
+        sma_calculator->start();
+        volatility_calculator->start();
+    }
+    if (correlation_calculator) {
+        correlation_calculator->start();
+    }
+    if (checkpointer) {
+        checkpointer->start();
+    }
     
     std::cout << "\n[Main] All threads running. Monitoring system...\n";
-    std::cout << "[Main] System will automatically stop after " << runtime_seconds << " seconds\n\n";
+    std::cout << "[Main] System will automatically stop after " << config.runtime_seconds << " seconds\n\n";
     
     // ============================================================
     // STEP 4: Monitor for shutdown
@@ -139,15 +523,73 @@ int main(int argc, char* argv[]) {
     // Main thread monitors for shutdown signal or timeout
     auto start_time = std::chrono::steady_clock::now();
     
+    // Steady-state window for the allocation counter: opens once every
+    // thread has sized its reusable scratch buffers and every indicator has
+    // produced its first value (EMA(20) needs 2s of ticks)
+    const int warmup_seconds = 4;
+    bool steady_state = false;
+    uint64_t steady_allocations = 0;
+    uint64_t steady_ticks = 0;
+    
+    // Throughput is measured over the same window (or the whole run if it
+    // ends first)
+    auto steady_start = start_time;
+    size_t steady_generations = 0, steady_evaluations = 0;
+    uint64_t window_ticks = 0;
+    double uptime_seconds = 0.0;
+    uint64_t last_ticks = 0;
+    size_t last_evaluations = 0;
+    
+    std::unique_ptr<ListingChurn> churn;
+    if (config.listing_churn > 0) {
+        churn = std::make_unique<ListingChurn>(shared_buffer, config.listing_churn);
+        std::cout << "[Main] Listing churn: " << config.listing_churn << " symbols delisted and listed per second\n";
+    }
+    
     while (!g_shutdown_requested.load()) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
         
+        if (churn) {
+            churn->step();
+        }
+        
+        if (g_trace_dump_requested.exchange(false)) {
+            writeTrace(config.trace_path);
+        }
+        
         // Check if runtime exceeded
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::steady_clock::now() - start_time).count();
         
-        if (elapsed >= runtime_seconds) {
-            std::cout << "\n\n[Main] Runtime limit reached (" << runtime_seconds << "s)\n";
+        if (!steady_state && elapsed >= warmup_seconds) {
+            steady_allocations = alloc_counter::allocations();
+            steady_ticks = shared_buffer.epoch();
+            steady_start = std::chrono::steady_clock::now();
+            window_ticks = steady_ticks;
+            perf_monitor.getSystemStats(steady_generations, steady_evaluations, uptime_seconds);
+            steady_state = true;
+        }
+        
+        if (config.quiet) {
+            size_t generations, evaluations;
+            perf_monitor.getSystemStats(generations, evaluations, uptime_seconds);
+            uint64_t ticks = shared_buffer.epoch();
+            std::printf("[Main] %llds: %llu ticks/s, %zu indicator evals/s\n",
+                        static_cast<long long>(elapsed), static_cast<unsigned long long>(ticks - last_ticks),
+                        evaluations - last_evaluations);
+            std::fflush(stdout);
+            last_ticks = ticks;
+            last_evaluations = evaluations;
+        }
+        
+        if (elapsed >= config.runtime_seconds) {
+            std::cout << "\n\n[Main] Runtime limit reached (" << config.runtime_seconds << "s)\n";
+            break;
+        }
+        
+        // A replay ends with its file
+        if (tick_source->finished()) {
+            std::cout << "\n\n[Main] Replay finished\n";
             break;
         }
     }
@@ -156,6 +598,19 @@ int main(int argc, char* argv[]) {
     // STEP 5: Graceful shutdown
     // ============================================================
     
+    if (steady_state) {
+        steady_allocations = alloc_counter::allocations() - steady_allocations;
+        steady_ticks = shared_buffer.epoch() - steady_ticks;
+    }
+    
+    // Sustained rates over the measurement window
+    size_t end_generations, end_evaluations;
+    perf_monitor.getSystemStats(end_generations, end_evaluations, uptime_seconds);
+    double measured_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - steady_start).count();
+    uint64_t measured_ticks = shared_buffer.epoch() - window_ticks;
+    uint64_t measured_evaluations = end_evaluations - steady_evaluations;
+    
     std::cout << "[Main] Initiating graceful shutdown...\n\n";
     
     // Signal shared buffer to wake waiting threads
@@ -163,22 +618,64 @@ int main(int argc, char* argv[]) {
     
     // Stop all threads (joins will block until threads exit)
     std::cout << "[Main] Stopping producer thread...\n";
-    price_generator.stop();
+    tick_source->stop();
     
     std::cout << "[Main] Stopping consumer threads...\n";
-    display_thread.stop();
-    sma_calculator.stop();
-    volatility_calculator.stop();
+    if (display_thread) {
+        display_thread->stop();
+    }
+    if (correlation_calculator) {
+        correlation_calculator->stop();
+    }
+    if (indicator_scheduler) {
+        indicator_scheduler->stop();
+    }
+    if (fused_calculator) {
+        fused_calculator->stop();
+    } else {
+        sma_calculator->stop();
+        volatility_calculator->stop();
+    }
+    
+    // After the indicators: the final checkpoint copies their state directly
+    if (checkpointer) {
+        std::cout << "[Main] Writing final checkpoint...\n";
+        checkpointer->stop();
+    }
+    
+    // After the indicators too: drains every result they emitted
+    if (indicator_sink) {
+        indicator_sink->stop();
+    }
     
+    std::cout.clear();  // Unmute (--quiet)
     std::cout << "\n[Main] All threads stopped successfully\n";
     
+    if (trace::active()) {
+        trace::stop();
+        writeTrace(config.trace_path);
+    }
+    
     // ============================================================
     // STEP 6: Display performance report
     // ============================================================
     
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
     
-    perf_monitor.printReport();
+    // Per-symbol latency rows only while they fit on a screen
+    perf_monitor.printReport(symbols.size() <= 32);
+    
+    LatencySummary latency = perf_monitor.getTotalLatencySummary();
+    std::cout << "--- Sustained Throughput (" << (steady_state ? "after warmup, " : "whole run, ")
+              << std::fixed << std::setprecision(1) << measured_seconds << "s) ---\n";
+    std::cout << "Ticks: " << measured_ticks << " (" << std::setprecision(0)
+              << (measured_seconds > 0 ? measured_ticks / measured_seconds : 0.0) << " ticks/sec)\n";
+    std::cout << "Indicator Evaluations: " << measured_evaluations << " ("
+              << (measured_seconds > 0 ? measured_evaluations / measured_seconds : 0.0) << " evals/sec)\n";
+    std::cout << "Latency, all indicators (us): p50 " << std::setprecision(2)
+              << latency.percentile(0.50) / 1000.0 << " | p90 " << latency.percentile(0.90) / 1000.0
+              << " | p99 " << latency.percentile(0.99) / 1000.0 << " | p99.9 "
+              << latency.percentile(0.999) / 1000.0 << " | max " << latency.max / 1000.0 << "\n\n";
     
     // Additional statistics
     size_t total_writes, total_reads;
@@ -188,7 +685,79 @@ int main(int argc, char* argv[]) {
     std::cout << "Total Writes: " << total_writes << "\n";
     std::cout << "Total Reads: " << total_reads << "\n";
     std::cout << "Read/Write Ratio: " << std::fixed << std::setprecision(2) 
-              << (static_cast<double>(total_reads) / total_writes) << "\n\n";
+              << (static_cast<double>(total_reads) / total_writes) << "\n";
+    std::cout << "Preallocated Tick Storage: " << shared_buffer.storageBytes() / 1024 << " KB\n\n";
+    
+    BufferStats buffer_stats;
+    shared_buffer.getStats(buffer_stats);
+    std::cout << "--- Consumer Lag ---\n";
+    for (const ConsumerStats& consumer : buffer_stats.consumers) {
+        bool ticks = (consumer.resolution == BarResolution::Tick);
+        std::cout << consumer.name << " (" << overloadPolicyName(consumer.policy);
+        if (ticks) std::cout << ", limit " << consumer.lag_limit;
+        std::cout << "): lag " << consumer.lag << (ticks ? " ticks" : " bars") << " (worst symbol "
+                  << consumer.worst_lag << ", peak " << consumer.peak_lag << ") | dropped "
+                  << consumer.dropped << " | conflated " << consumer.conflated << "\n";
+    }
+    if (shared_buffer.hasBars()) {
+        std::cout << "Bars Closed: " << buffer_stats.bars_closed[0] << " x 1s | "
+                  << buffer_stats.bars_closed[1] << " x 1m | " << buffer_stats.bars_closed[2] << " x 5m | "
+                  << buffer_stats.bars_closed[3] << " x 1h\n";
+    }
+    if (buffer_stats.producer_waits > 0) {
+        std::cout << "Producer Blocked: " << buffer_stats.producer_waits << " times, "
+                  << buffer_stats.producer_wait_ns / 1e6 << " ms\n";
+    }
+    if (buffer_stats.unlisted_dropped > 0) {
+        std::cout << "Unlisted Ticks Dropped: " << buffer_stats.unlisted_dropped << "\n";
+    }
+    std::cout << "\n";
+    
+    SymbolTable::Stats listings = shared_buffer.getListingStats();
+    if (listings.version > 1) {
+        std::cout << "--- Symbol Listings ---\n";
+        std::cout << "Listed: " << listings.listed << " of " << symbol_registry.size() << " registered ("
+                  << symbol_registry.capacity() << " slots)\n";
+        std::cout << "Changes: " << listings.listings << " listed, " << listings.delistings
+                  << " delisted in " << listings.version - 1 << " table versions ("
+                  << listings.unreclaimed << " retired versions not yet reclaimed)\n\n";
+    }
+    
+    if (correlation_calculator) {
+        CorrelationStats correlation = correlation_calculator->getStats();
+        std::vector<CorrelatedPair> strongest;
+        correlation_calculator->strongestPairs(5, strongest);
+        std::cout << "--- Correlation Matrix ---\n";
+        std::cout << "Symbols: " << correlation.symbols << " | Window: " << correlation.samples << " of "
+                  << correlation.window << " samples | Matrix: " << correlation.matrix_bytes / (1024 * 1024) << " MB\n";
+        std::cout << "Sweeps: " << correlation.sweeps << " (" << correlation.samples_added << " samples, "
+                  << correlation.rebuilds << " rebuilds) | avg " << std::setprecision(3)
+                  << correlation.sweep_ns_total / 1e6 / std::max<uint64_t>(correlation.sweeps, 1)
+                  << " ms | max " << correlation.sweep_ns_max / 1e6 << " ms\n" << std::setprecision(2);
+        for (const CorrelatedPair& pair : strongest) {
+            std::cout << "  " << symbol_registry.name(pair.first) << " / " << symbol_registry.name(pair.second)
+                      << ": " << std::showpos << pair.correlation << std::noshowpos << "\n";
+        }
+        std::cout << "\n";
+    }
+    
+    if (indicator_sink) {
+        std::cout << "--- Indicator Output ---\n";
+        std::cout << "Records Written: " << indicator_sink->written() << " (" << indicator_sink->dropped()
+                  << " dropped) to " << indicator_sink->describe() << "\n\n";
+    }
+    
+    if (alloc_counter::kEnabled) {
+        std::cout << "--- Heap Allocations (after " << warmup_seconds << "s warmup) ---\n";
+        if (steady_state) {
+            std::cout << "Allocations: " << steady_allocations << " over " << steady_ticks << " ticks ("
+                      << std::setprecision(4)
+                      << (steady_ticks > 0 ? static_cast<double>(steady_allocations) / steady_ticks : 0.0)
+                      << " per tick)\n\n" << std::setprecision(2);
+        } else {
+            std::cout << "Run ended before the warmup did\n\n";
+        }
+    }
     
     std::cout << "====================================================\n";
     std::cout << "     Simulation completed successfully!             \n";
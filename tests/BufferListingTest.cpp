@@ -0,0 +1,81 @@
+// SharedBuffer enforces the listing: ticks for a delisted symbol are
+// dropped whichever producer sends them, and a producer blocked on a slow
+// consumer is let go when the symbol it waits for is delisted.
+
+#include "TestUtil.h"
+#include "SharedBuffer.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kHistory = 16;
+
+PriceData tick(SymbolId symbol, double price) {
+    return PriceData(symbol, price, 0.0, 10.0, TickClock::now());
+}
+
+void testDelistedTicksAreDropped() {
+    SymbolRegistry registry = test::makeRegistry(3);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    buffer.push(tick(1, 100.0));
+    buffer.delistSymbol(1);
+    
+    buffer.push(tick(1, 101.0));
+    buffer.pushBatch(std::vector<PriceData>{tick(0, 10.0), tick(1, 102.0), tick(2, 20.0)});
+    CHECK(buffer.sequence(0) == 1);
+    CHECK(buffer.sequence(1) == 1);     // Only the tick from before the delisting
+    CHECK(buffer.sequence(2) == 1);
+    BufferStats stats;
+    buffer.getStats(stats);
+    CHECK(stats.unlisted_dropped == 2);
+    CHECK(stats.writes == 3);
+    
+    // Listed again: accepted from now on
+    buffer.updateListings({"S1"}, {});
+    buffer.push(tick(1, 103.0));
+    CHECK(buffer.sequence(1) == 2);
+    PriceData latest;
+    CHECK(buffer.getLatest(1, latest) && latest.price == 103.0);
+}
+
+// A blocking consumer that never reads symbol 0 (it was delisted): the
+// producer waiting on its cursor must give up instead of waiting forever
+void testDelistingReleasesBlockedProducer() {
+    SymbolRegistry registry = test::makeRegistry(2);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    ConsumerId consumer = buffer.registerConsumer("slow");
+    buffer.setOverloadPolicy(consumer, OverloadPolicy::BlockProducer, 4);
+    for (int i = 0; i < 4; ++i) buffer.push(tick(0, 100.0 + i));
+    
+    std::thread delister([&buffer] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.delistSymbol(0);
+    });
+    CHECK(test::finishesWithin(std::chrono::seconds(2), [&buffer] { buffer.push(tick(0, 200.0)); }));
+    delister.join();
+    
+    BufferStats stats;
+    buffer.getStats(stats);
+    CHECK(buffer.sequence(0) == 4);
+    CHECK(stats.producer_waits == 1);
+    CHECK(stats.unlisted_dropped == 1);
+    
+    // Other symbols are unaffected, and a batch skips the delisted one without waiting
+    CHECK(test::finishesWithin(std::chrono::seconds(2), [&buffer] {
+        buffer.pushBatch(std::vector<PriceData>{tick(0, 201.0), tick(1, 50.0)});
+    }));
+    CHECK(buffer.sequence(1) == 1);
+    buffer.getStats(stats);
+    CHECK(stats.producer_waits == 1);
+    buffer.shutdown();
+}
+
+}  // namespace
+
+int main() {
+    testDelistedTicksAreDropped();
+    testDelistingReleasesBlockedProducer();
+    return test::failures();
+}
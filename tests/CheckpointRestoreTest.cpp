@@ -0,0 +1,125 @@
+// Warm restart with a blocking consumer: the buffer's copy of each restored
+// indicator's cursor must continue from the checkpoint, so the producer is
+// not held back by a cursor that still says 0. Listings come back as they
+// were: delisted symbols stay delisted.
+
+#include "TestUtil.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "SMACalculator.h"
+#include "Checkpoint.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr size_t kSymbols = 5;
+constexpr size_t kHistory = 16;
+constexpr size_t kTicks = 40;       // Per symbol, well past the history and the lag limit
+
+void pushTicks(SharedBuffer& buffer, size_t count) {
+    for (size_t n = 0; n < count; ++n) {
+        for (size_t id = 0; id < kSymbols; ++id) {
+            buffer.push(PriceData(static_cast<SymbolId>(id), 100.0 + n, 0.0, 10.0, TickClock::now()));
+        }
+    }
+}
+
+// Take a checkpoint of a buffer whose SMA indicator has read every tick
+void writeCheckpoint(const std::string& path) {
+    SymbolRegistry registry = test::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    SMACalculator sma(buffer, monitor, 4);
+    sma.setLogEvery(0);
+    
+    pushTicks(buffer, kTicks);
+    for (size_t id = 0; id < kSymbols; ++id) sma.calculateSymbol(static_cast<SymbolId>(id));
+    
+    Checkpointer checkpointer(buffer, path, 60000);
+    checkpointer.addIndicator(sma);
+    checkpointer.start();
+    checkpointer.stop();    // Writes the final checkpoint
+    CHECK(checkpointer.written() == 1);
+}
+
+void testRestoreThenBlockingPush(const std::string& path) {
+    SymbolRegistry registry = test::makeRegistry(kSymbols);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    
+    MappedCheckpoint checkpoint(path);
+    checkpoint.restoreBuffer(buffer);
+    CHECK(buffer.sequence(0) == kTicks);
+    
+    SMACalculator sma(buffer, monitor, 4);
+    sma.setLogEvery(0);
+    buffer.setOverloadPolicy(sma.consumerId(), OverloadPolicy::BlockProducer, 4);
+    CHECK(checkpoint.restoreIndicator(sma));
+    
+    // Restored cursors are caught up: nothing is reported as lag
+    BufferStats stats;
+    buffer.getStats(stats);
+    CHECK(stats.consumers.size() == 1 && stats.consumers[0].lag == 0);
+    
+    // Up to the lag limit the producer must not wait (it used to block forever)
+    CHECK(test::finishesWithin(std::chrono::seconds(2), [&buffer] { pushTicks(buffer, 4); }));
+    buffer.getStats(stats);
+    CHECK(stats.producer_waits == 0);
+    CHECK(stats.consumers[0].lag == 4 * kSymbols);
+    
+    // The indicator continues from its restored cursor: only the new ticks
+    CHECK(sma.hasNewData(0));
+    sma.calculateSymbol(0);
+    CHECK(!sma.hasNewData(0));
+    buffer.shutdown();
+}
+
+// A cursor ahead of the sequence (restored state, or a wrapped subtraction)
+// is never "behind"
+void testCursorAheadHasRoom() {
+    ConsumerCursors cursors(1);
+    ConsumerId id = cursors.add("ahead", BarResolution::Tick, 4);
+    cursors.setPolicy(id, OverloadPolicy::BlockProducer, 4);
+    cursors[id].cursors[0].store(100);
+    CHECK(cursors.hasRoom(0, 50));
+    CHECK(cursors.hasRoom(0, 104));
+    CHECK(!cursors.hasRoom(0, 105));
+}
+
+// Symbols listed and delisted at runtime, then a checkpoint and a restore
+void testRestoreKeepsListings(const std::string& path) {
+    {
+        SymbolRegistry registry = test::makeRegistry(3, 6);
+        SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+        buffer.updateListings({"A", "B"}, {});
+        for (SymbolId id = 0; id < 5; ++id) buffer.push(PriceData(id, 100.0 + id, 0.0, 10.0, TickClock::now()));
+        buffer.updateListings({}, {1, 3});     // S1 and A
+        Checkpointer checkpointer(buffer, path, 60000);
+        checkpointer.start();
+        checkpointer.stop();
+    }
+    
+    SymbolRegistry registry = test::makeRegistry(3, 6);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    MappedCheckpoint checkpoint(path);
+    CHECK(checkpoint.restoreBuffer(buffer) == 5);
+    CHECK(registry.size() == 5 && registry.name(3) == "A" && registry.name(4) == "B");
+    SymbolTable::Reader listed(buffer.symbolTable());
+    CHECK((listed.symbols() == std::vector<SymbolId>{0, 2, 4}));
+    CHECK(buffer.sequence(1) == 1 && buffer.sequence(3) == 1);     // Delisted symbols keep their ticks
+}
+
+}  // namespace
+
+int main() {
+    std::string path = test::tempPath("restore.ckpt");
+    std::cout.setstate(std::ios::failbit);  // Component logs
+    writeCheckpoint(path);
+    testRestoreThenBlockingPush(path);
+    testCursorAheadHasRoom();
+    testRestoreKeepsListings(path);
+    std::cout.clear();
+    std::remove(path.c_str());
+    return test::failures();
+}
@@ -0,0 +1,157 @@
+// WorkStealingExecutor: wait() returns only once every task of the group
+// has run, each task runs exactly once, a worker's backlog is stolen while
+// it is busy, and a waiting caller runs tasks itself.
+
+#include "TestUtil.h"
+#include "WorkStealingExecutor.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+constexpr size_t kTasks = 1000;
+
+using Clock = std::chrono::steady_clock;
+
+struct Counts {
+    std::vector<std::atomic<int>> runs;
+    std::atomic<size_t> total{0};
+    
+    explicit Counts(size_t n) : runs(n) {
+        for (auto& r : runs) r.store(0);
+    }
+};
+
+// Spin until count reaches target (bounded, so a broken executor fails
+// the test instead of hanging it)
+void awaitCount(const std::atomic<size_t>& count, size_t target) {
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+    while (count.load() < target && Clock::now() < deadline) std::this_thread::yield();
+}
+
+// Every 16th task is much heavier than the rest
+void countTask(void* context, size_t argument) {
+    Counts& counts = *static_cast<Counts*>(context);
+    if (argument % 16 == 0) {
+        volatile double sink = 0.0;
+        for (int i = 0; i < 20000; ++i) sink = sink + i * 0.5;
+    }
+    counts.runs[argument].fetch_add(1);
+    counts.total.fetch_add(1);
+}
+
+std::vector<ExecutorTask> makeTasks(Counts& counts, TaskGroup& group) {
+    std::vector<ExecutorTask> tasks(counts.runs.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i] = ExecutorTask{countTask, &counts, i, &group};
+    }
+    return tasks;
+}
+
+bool eachRanOnce(const Counts& counts) {
+    for (const auto& r : counts.runs) {
+        if (r.load() != 1) return false;
+    }
+    return true;
+}
+
+void testWaitCompletesGroup() {
+    WorkStealingExecutor executor(3);
+    Counts counts(kTasks);
+    TaskGroup group;
+    std::vector<ExecutorTask> tasks = makeTasks(counts, group);
+    executor.submit(tasks.data(), tasks.size());
+    executor.wait(group);
+    
+    CHECK(group.done());
+    CHECK(counts.total.load() == kTasks);
+    CHECK(eachRanOnce(counts));
+    
+    // The group is reusable for the next pass
+    for (auto& r : counts.runs) r.store(0);
+    counts.total.store(0);
+    executor.submit(tasks.data(), tasks.size());
+    executor.wait(group);
+    CHECK(group.done());
+    CHECK(eachRanOnce(counts));
+}
+
+// One task queues the whole batch on its own worker's deque and then stays
+// busy until the batch is done: only the other worker stealing can finish it
+struct Spawner {
+    WorkStealingExecutor* executor;
+    std::vector<ExecutorTask> tasks;
+    Counts* counts;
+};
+
+void spawnTask(void* context, size_t) {
+    Spawner& spawner = *static_cast<Spawner*>(context);
+    spawner.executor->submit(spawner.tasks.data(), spawner.tasks.size());
+    awaitCount(spawner.counts->total, spawner.tasks.size());
+}
+
+void testBusyWorkerIsStolenFrom() {
+    WorkStealingExecutor executor(2);
+    Counts counts(kTasks);
+    TaskGroup group;
+    Spawner spawner{&executor, makeTasks(counts, group), &counts};
+    executor.submit(ExecutorTask{spawnTask, &spawner, 0, &group});
+    
+    // Not wait(): the caller would help and hide whether the workers steal
+    awaitCount(counts.total, kTasks);
+    executor.wait(group);
+    
+    size_t executed = 0, stolen = 0;
+    executor.getStats(executed, stolen);
+    CHECK(group.done());
+    CHECK(eachRanOnce(counts));
+    CHECK(executed >= kTasks);      // The spawner may not be counted yet
+    CHECK(stolen >= kTasks);
+}
+
+// A single worker held up by a long task: the waiting caller runs the group
+struct Blocker {
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> release{0};
+};
+
+void blockTask(void* context, size_t) {
+    Blocker& blocker = *static_cast<Blocker*>(context);
+    blocker.started.store(1);
+    awaitCount(blocker.release, 1);
+}
+
+void testCallerHelpsWhileWaiting() {
+    WorkStealingExecutor executor(1);
+    Blocker blocker;
+    TaskGroup blocked;
+    executor.submit(ExecutorTask{blockTask, &blocker, 0, &blocked});
+    awaitCount(blocker.started, 1);
+    
+    Counts counts(kTasks);
+    TaskGroup group;
+    std::vector<ExecutorTask> tasks = makeTasks(counts, group);
+    executor.submit(tasks.data(), tasks.size());
+    executor.wait(group);
+    
+    size_t executed = 0, stolen = 0;
+    executor.getStats(executed, stolen);
+    CHECK(group.done());
+    CHECK(eachRanOnce(counts));
+    CHECK(executed == 0);           // The worker is still inside the blocker
+    blocker.release.store(1);
+    executor.wait(blocked);
+    CHECK(blocked.done());
+}
+
+}  // namespace
+
+int main() {
+    std::cout.setstate(std::ios::failbit);  // Component logs
+    testWaitCompletesGroup();
+    testBusyWorkerIsStolenFrom();
+    testCallerHelpsWhileWaiting();
+    std::cout.clear();
+    return test::failures();
+}
@@ -0,0 +1,89 @@
+// Feed accounting: FeedStats::ticks counts the ticks a packet actually
+// produced, not the records it carried, and records for unlisted symbols
+// are dropped and counted on their own.
+
+#include "TestUtil.h"
+#include "MulticastFeed.h"
+
+#include <vector>
+
+namespace {
+
+constexpr size_t kSymbols = 4;
+
+void testUnknownSymbolsAreNotTicks() {
+    std::vector<TickFileRecord> records;
+    for (uint32_t symbol : {0u, 1u, 7u, 3u, 100u}) {
+        records.push_back(TickFileRecord{symbol, 10, 100.0 + symbol, 0});
+    }
+    std::vector<std::byte> packet(kFeedMaxPacketBytes);
+    size_t length = feed::encodePacket(records.data(), records.size(), 1, packet.data());
+    
+    FeedDecoder decoder(kSymbols);
+    FeedStats stats;
+    std::vector<PriceData> out;
+    CHECK(decoder.decode(packet.data(), length, TickClock::now(), out, stats));
+    CHECK(out.size() == 3);
+    CHECK(stats.ticks == 3);
+    CHECK(stats.unknown_symbols == 2);
+    CHECK(stats.packets == 1);
+}
+
+void testDroppedPacketsAddNoTicks() {
+    TickFileRecord record{0, 10, 100.0, 0};
+    std::vector<std::byte> packet(kFeedMaxPacketBytes);
+    FeedDecoder decoder(kSymbols);
+    FeedStats stats;
+    std::vector<PriceData> out;
+    
+    size_t length = feed::encodePacket(&record, 1, 5, packet.data());
+    CHECK(decoder.decode(packet.data(), length, TickClock::now(), out, stats));
+    length = feed::encodePacket(&record, 1, 4, packet.data());
+    CHECK(!decoder.decode(packet.data(), length, TickClock::now(), out, stats));     // Late
+    CHECK(!decoder.decode(packet.data(), length - 1, TickClock::now(), out, stats)); // Malformed
+    CHECK(stats.late == 1 && stats.malformed == 1);
+    CHECK(stats.ticks == 1 && out.size() == 1);
+}
+
+void testUnlistedSymbolsAreDropped() {
+    std::vector<TickFileRecord> records;
+    for (uint32_t symbol = 0; symbol < kSymbols; ++symbol) {
+        records.push_back(TickFileRecord{symbol, 10, 100.0 + symbol, 0});
+    }
+    std::vector<std::byte> packet(kFeedMaxPacketBytes);
+    size_t length = feed::encodePacket(records.data(), records.size(), 1, packet.data());
+    
+    // What the receiver hands the decoder after a delisting
+    SymbolTable table(kSymbols, {0, 1, 2, 3});
+    table.update({}, {1, 3});
+    SymbolTable::Reader listed(table);
+    FeedDecoder decoder(kSymbols);
+    decoder.setListed(listed.symbols());
+    
+    FeedStats stats;
+    std::vector<PriceData> out;
+    CHECK(decoder.decode(packet.data(), length, TickClock::now(), out, stats));
+    CHECK(out.size() == 2 && out[0].symbol == 0 && out[1].symbol == 2);
+    CHECK(stats.ticks == 2);
+    CHECK(stats.unlisted == 2);
+    CHECK(stats.unknown_symbols == 0);
+    
+    // Listed again: published from the next packet on
+    table.update({3}, {});
+    CHECK(listed.refresh());
+    decoder.setListed(listed.symbols());
+    length = feed::encodePacket(records.data(), records.size(), 2, packet.data());
+    out.clear();
+    CHECK(decoder.decode(packet.data(), length, TickClock::now(), out, stats));
+    CHECK(out.size() == 3 && out[2].symbol == 3);
+    CHECK(stats.unlisted == 3);
+}
+
+}  // namespace
+
+int main() {
+    testUnknownSymbolsAreNotTicks();
+    testDroppedPacketsAddNoTicks();
+    testUnlistedSymbolsAreDropped();
+    return test::failures();
+}
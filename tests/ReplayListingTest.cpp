@@ -0,0 +1,73 @@
+// Replay and runtime listings: a symbol delisted partway through a replay
+// gets no more ticks, and a blocking consumer that stopped reading it does
+// not hold the replay back.
+
+#include "TestUtil.h"
+#include "SharedBuffer.h"
+#include "PerformanceMonitor.h"
+#include "TickFile.h"
+#include "TickReplayer.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+constexpr size_t kHistory = 64;
+constexpr uint64_t kLagLimit = 16;
+constexpr int64_t kMs = 1000000;
+
+// S0: 10 ticks early and 5 late (within the lag limit); S1: 10 early and 60 late (past the lag limit)
+void writeFile(const std::string& path) {
+    TickFileWriter writer(path, {"S0", "S1"});
+    for (int64_t i = 0; i < 10; ++i) {
+        writer.append(TickFileRecord{0, 10, 100.0 + i, i * kMs});
+        writer.append(TickFileRecord{1, 10, 200.0 + i, i * kMs});
+    }
+    for (int64_t i = 0; i < 60; ++i) {
+        if (i < 5) writer.append(TickFileRecord{0, 10, 110.0 + i, 300 * kMs + i * kMs / 2});
+        writer.append(TickFileRecord{1, 10, 210.0 + i, 300 * kMs + i * kMs / 2});
+    }
+    writer.close();
+}
+
+void testDelistDuringReplay(const std::string& path) {
+    SymbolRegistry registry = test::makeRegistry(2);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    PerformanceMonitor monitor(registry);
+    ConsumerId consumer = buffer.registerConsumer("idle");     // Never reads: only the lag limit goes
+    buffer.setOverloadPolicy(consumer, OverloadPolicy::BlockProducer, kLagLimit);
+    
+    MappedTickFile file(path);
+    TickReplayer replayer(buffer, monitor, file, 1.0);
+    replayer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));   // Between the early and late ticks
+    buffer.delistSymbol(1);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!replayer.finished() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(replayer.finished());
+    buffer.shutdown();
+    replayer.stop();
+    
+    BufferStats stats;
+    buffer.getStats(stats);
+    CHECK(buffer.sequence(0) == 15);
+    CHECK(buffer.sequence(1) == 10);        // Nothing after the delisting
+    CHECK(stats.producer_waits == 0);
+    CHECK(stats.unlisted_dropped == 0);     // The replayer skipped them itself
+}
+
+}  // namespace
+
+int main() {
+    std::string path = test::tempPath("listing.ticks");
+    writeFile(path);
+    std::cout.setstate(std::ios::failbit);  // Component logs
+    testDelistDuringReplay(path);
+    std::cout.clear();
+    std::remove(path.c_str());
+    return test::failures();
+}
@@ -0,0 +1,115 @@
+// Lock-free rings under a concurrent writer: every copy a reader accepts
+// is a run of consecutive ticks whose columns belong together, and a
+// cursor-based reader accounts for every tick exactly once (read or
+// reported missed).
+
+#include "TestUtil.h"
+#include "PriceRing.h"
+#include "SharedBuffer.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kHistory = 8;          // Small, so the writer laps readers often
+constexpr uint64_t kTicks = 200000;
+
+// Tick n (1-based) carries n in every column
+PriceData tick(SymbolId symbol, uint64_t n) {
+    double x = static_cast<double>(n);
+    return PriceData(symbol, x, 2.0 * x, 3.0 * x, TickClock::time_point(TickClock::duration(n)));
+}
+
+bool consistent(const PriceData& data) {
+    return data.change == 2.0 * data.price && data.volume == 3.0 * data.price &&
+           static_cast<double>(data.timestamp.time_since_epoch().count()) == data.price;
+}
+
+void testRingReadersSeeWholeTicks() {
+    PriceRing ring(0, kHistory);
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    std::atomic<uint64_t> copies(0);
+    
+    std::thread reader([&] {
+        std::vector<PriceData> recent;
+        PriceData latest;
+        uint64_t last_seen = 0;
+        while (!done.load()) {
+            size_t n = ring.readRecent(kHistory, recent);
+            for (size_t i = 0; i < n; ++i) {
+                if (!consistent(recent[i]) || (i > 0 && recent[i].price != recent[i - 1].price + 1.0)) ++bad;
+            }
+            uint64_t sequence = 0;
+            if (ring.readLatest(latest, &sequence)) {
+                // The newest tick is the one the sequence names, and never goes back
+                if (!consistent(latest) || latest.price != static_cast<double>(sequence) ||
+                    sequence < last_seen) ++bad;
+                last_seen = sequence;
+            }
+            ++copies;
+        }
+    });
+    
+    for (uint64_t n = 1; n <= kTicks; ++n) {
+        ring.publish(tick(0, n));
+        if (n % 1024 == 0) std::this_thread::yield();   // Let the reader run mid-stream on one core
+    }
+    done.store(true);
+    reader.join();
+    
+    CHECK(bad.load() == 0);
+    CHECK(copies.load() > 0);
+    CHECK(ring.sequence() == kTicks);
+}
+
+void testBufferCursorAccountsForEveryTick() {
+    SymbolRegistry registry = test::makeRegistry(2);
+    SharedBuffer buffer(registry, kHistory, BufferMode::LockFree);
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    uint64_t read = 0;
+    uint64_t missed_total = 0;
+    
+    std::thread consumer([&] {
+        TickBatch batch;
+        uint64_t cursor = 0;
+        for (;;) {
+            bool last = done.load();
+            uint64_t missed = 0;
+            uint64_t next = buffer.readSince(1, cursor, batch, &missed);
+            // The batch is the newest ticks up to next, preceded by the missed ones
+            if (next - cursor != batch.size() + missed) ++bad;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                PriceData data = batch[i];
+                if (!consistent(data) || data.price != static_cast<double>(next - batch.size() + 1 + i)) ++bad;
+            }
+            read += batch.size();
+            missed_total += missed;
+            cursor = next;
+            if (last) break;
+        }
+    });
+    
+    for (uint64_t n = 1; n <= kTicks; ++n) {
+        buffer.push(tick(1, n));
+        if (n % 1024 == 0) std::this_thread::yield();
+    }
+    done.store(true);
+    consumer.join();
+    
+    CHECK(bad.load() == 0);
+    CHECK(read + missed_total == kTicks);
+    CHECK(read > 0);
+    CHECK(buffer.sequence(0) == 0);     // Other symbols' rings untouched
+}
+
+}  // namespace
+
+int main() {
+    testRingReadersSeeWholeTicks();
+    testBufferCursorAccountsForEveryTick();
+    return test::failures();
+}
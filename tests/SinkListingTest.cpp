@@ -0,0 +1,87 @@
+// Indicator output and runtime listings: a symbol listed after the sink
+// started must be named in the output's symbol table, so its records can
+// be read back by name.
+
+#include "TestUtil.h"
+#include "SharedBuffer.h"
+#include "IndicatorSink.h"
+#include "IndicatorOutput.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr size_t kSymbols = 3;
+constexpr size_t kCapacity = 6;
+
+// Start a sink, list a symbol, emit one record for it and one for S0
+SymbolId emitAcrossListing(SharedBuffer& buffer, IndicatorSink& sink, uint16_t indicator) {
+    sink.start();
+    SymbolId listed = buffer.listSymbol("LATE");
+    auto now = TickClock::now();
+    sink.emit(listed, indicator, 1.5, 10.0, now, now, 1);
+    sink.emit(0, indicator, 2.5, 20.0, now, now, 1);
+    sink.stop();
+    return listed;
+}
+
+void testQueueNamesListedSymbol() {
+    SymbolRegistry registry = test::makeRegistry(kSymbols, kCapacity);
+    SharedBuffer buffer(registry, 16, BufferMode::LockFree);
+    std::string path = test::tempPath("listing.shm");
+    IndicatorSink sink(registry, std::make_unique<IndicatorQueueTarget>(path, 16));
+    uint16_t indicator = sink.registerIndicator("SMA");
+    SymbolId listed = emitAcrossListing(buffer, sink, indicator);
+    
+    IndicatorQueueReader reader(path);
+    CHECK(reader.symbols().size() == kCapacity);
+    CHECK(reader.published() == 2);
+    IndicatorRecord record;
+    CHECK(reader.read(0, record));
+    CHECK(record.symbol == listed);
+    CHECK(reader.symbol(record.symbol) == "LATE");
+    CHECK(reader.read(1, record));
+    CHECK(reader.symbol(record.symbol) == "S0");
+    CHECK(reader.symbol(kCapacity - 1).empty());     // Spare slot, never listed
+    CHECK(reader.symbol(kCapacity).empty());
+    std::remove(path.c_str());
+}
+
+void testFileNamesListedSymbol() {
+    SymbolRegistry registry = test::makeRegistry(kSymbols, kCapacity);
+    SharedBuffer buffer(registry, 16, BufferMode::LockFree);
+    std::string path = test::tempPath("listing.bin");
+    IndicatorSink sink(registry, std::make_unique<IndicatorFileTarget>(path));
+    uint16_t indicator = sink.registerIndicator("SMA");
+    SymbolId listed = emitAcrossListing(buffer, sink, indicator);
+    
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    IndicatorStreamHeader header;
+    CHECK(bytes.size() >= sizeof(header));
+    if (bytes.size() < sizeof(header)) return;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    CHECK(header.symbol_count == kCapacity);
+    CHECK(header.record_count == 2);
+    CHECK(bytes.size() == header.records_offset + 2 * sizeof(IndicatorRecord));
+    if (bytes.size() != header.records_offset + 2 * sizeof(IndicatorRecord)) return;
+    
+    IndicatorRecord record;
+    std::memcpy(&record, bytes.data() + header.records_offset, sizeof(record));
+    CHECK(record.symbol == listed);
+    const char* name = bytes.data() + sizeof(header) + record.symbol * kIndicatorNameBytes;
+    CHECK(std::string(name, strnlen(name, kIndicatorNameBytes)) == "LATE");
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    std::cout.setstate(std::ios::failbit);  // Component logs
+    testQueueNamesListedSymbol();
+    testFileNamesListedSymbol();
+    std::cout.clear();
+    return test::failures();
+}
@@ -0,0 +1,148 @@
+// SymbolTable: listing, delisting and relisting publish new versions, a
+// Reader sees a version only after refresh(), and retired versions are
+// freed once no Reader can still hold them.
+
+#include "TestUtil.h"
+#include "SymbolTable.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kCapacity = 8;
+
+bool ascending(const std::vector<SymbolId>& symbols) {
+    for (size_t i = 1; i < symbols.size(); ++i) {
+        if (symbols[i - 1] >= symbols[i]) return false;
+    }
+    return true;
+}
+
+void testListDelistRelist() {
+    SymbolTable table(kCapacity, {4, 0, 2});
+    CHECK(table.listedSymbols() == std::vector<SymbolId>({0, 2, 4}));
+    CHECK(table.listed(2) && !table.listed(1) && !table.listed(kCapacity));
+    
+    CHECK(table.update({1, 2}, {4}) == 2);      // 2 was listed already
+    CHECK(table.listedSymbols() == std::vector<SymbolId>({0, 1, 2}));
+    CHECK(table.update({2, kCapacity}, {5}) == 0);  // Nothing to change
+    CHECK(table.getStats().version == 2);
+    
+    CHECK(table.update({}, {0}) == 1);
+    CHECK(!table.listed(0));
+    CHECK(table.update({4, 0}, {}) == 2);       // Relisted, in ID order
+    CHECK(table.listedSymbols() == std::vector<SymbolId>({0, 1, 2, 4}));
+    CHECK(table.listed(0) && table.listed(4));
+    
+    SymbolTable::Stats stats = table.getStats();
+    CHECK(stats.version == 4);
+    CHECK(stats.listed == 4);
+    CHECK(stats.listings == 3);
+    CHECK(stats.delistings == 2);
+}
+
+void testReaderSeesVersionOnRefresh() {
+    SymbolTable table(kCapacity, {0, 2});
+    SymbolTable::Reader reader(table);
+    CHECK(reader.version() == 1);
+    CHECK(!reader.refresh());
+    
+    table.update({5}, {0});
+    CHECK(reader.version() == 1);                // Still on the snapshot it had
+    CHECK(reader.symbols() == std::vector<SymbolId>({0, 2}));
+    CHECK(reader.refresh());
+    CHECK(reader.version() == 2);
+    CHECK(reader.symbols() == std::vector<SymbolId>({2, 5}));
+    CHECK(!reader.refresh());
+}
+
+void testRetiredVersionsAreReclaimed() {
+    SymbolTable table(kCapacity, {0, 1});
+    SymbolTable::Reader reader(table);
+    table.update({2}, {});
+    CHECK(table.getStats().unreclaimed == 1);    // The reader is still on version 1
+    reader.refresh();
+    {
+        SymbolTable::Reader stale(table);        // Stays on version 2
+        table.update({}, {0});
+        CHECK(table.getStats().unreclaimed == 1);    // Version 1 freed
+        reader.refresh();
+        table.update({0}, {});
+        CHECK(table.getStats().unreclaimed == 2);    // Versions 2 (stale) and 3
+        CHECK(stale.version() == 2);
+        CHECK(stale.symbols() == std::vector<SymbolId>({0, 1, 2}));
+    }
+    table.update({}, {1});
+    CHECK(table.getStats().unreclaimed == 2);    // Version 2 freed, reader holds 3
+    reader.refresh();
+    table.update({1}, {});
+    CHECK(table.getStats().unreclaimed == 1);
+    CHECK(reader.symbols() == std::vector<SymbolId>({0, 2}));
+}
+
+void testReaderLimit() {
+    SymbolTable table(kCapacity, {0});
+    std::vector<std::unique_ptr<SymbolTable::Reader>> readers;
+    for (size_t i = 0; i < SymbolTable::kMaxReaders; ++i) {
+        readers.push_back(std::make_unique<SymbolTable::Reader>(table));
+    }
+    bool threw = false;
+    try {
+        SymbolTable::Reader extra(table);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    readers.pop_back();     // Its slot is free again
+    SymbolTable::Reader again(table);
+    CHECK(again.version() == 1);
+}
+
+// A reader refreshing while the writer churns only ever sees whole,
+// ascending snapshots, newer each time
+void testConcurrentRefresh() {
+    constexpr int kUpdates = 20000;
+    SymbolTable table(kCapacity, {0, 1, 2, 3});
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    
+    std::thread consumer([&] {
+        SymbolTable::Reader reader(table);
+        uint64_t last = reader.version();
+        while (!done.load()) {
+            if (!reader.refresh()) continue;
+            if (reader.version() <= last || !ascending(reader.symbols()) || reader.symbols().size() != 4) ++bad;
+            last = reader.version();
+        }
+    });
+    
+    // Each update swaps one symbol for another, so four are always listed
+    for (int i = 0; i < kUpdates; ++i) {
+        SymbolId out = static_cast<SymbolId>(i % kCapacity);
+        SymbolId in = static_cast<SymbolId>((i + 4) % kCapacity);
+        table.update({in}, {out});
+        if (i % 256 == 0) std::this_thread::yield();
+    }
+    done.store(true);
+    consumer.join();
+    
+    SymbolTable::Stats stats = table.getStats();
+    CHECK(bad.load() == 0);
+    CHECK(stats.version == kUpdates + 1);
+    CHECK(stats.listed == 4);
+}
+
+}  // namespace
+
+int main() {
+    testListDelistRelist();
+    testReaderSeesVersionOnRefresh();
+    testRetiredVersionsAreReclaimed();
+    testReaderLimit();
+    testConcurrentRefresh();
+    return test::failures();
+}
@@ -0,0 +1,64 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "SymbolRegistry.h"
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Minimal test support: each test is a plain executable that returns
+// failures() from main, registered with CTest in CMakeLists.txt.
+namespace test {
+
+inline int& failureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int failures() { return failureCount() > 0 ? 1 : 0; }
+
+inline void check(bool ok, const char* what, const char* file, int line) {
+    if (!ok) {
+        std::cerr << file << ":" << line << ": check failed: " << what << "\n";
+        ++failureCount();
+    }
+}
+
+// Registry with symbols "S0", "S1", ... "S<count-1>" and room for capacity
+inline SymbolRegistry makeRegistry(size_t count, size_t capacity = 0) {
+    SymbolRegistry registry(std::vector<std::string>{}, capacity > count ? capacity : count);
+    for (size_t i = 0; i < count; ++i) {
+        registry.intern("S" + std::to_string(i));
+    }
+    return registry;
+}
+
+// Path for a scratch file, unique per process
+inline std::string tempPath(const std::string& name) {
+    return "/tmp/stock_simulator_test_" + std::to_string(::getpid()) + "_" + name;
+}
+
+// True if fn() returns within timeout (a hang is reported as a failure
+// instead of stalling the test run; the stuck thread is abandoned)
+template <typename Fn>
+bool finishesWithin(std::chrono::milliseconds timeout, Fn fn) {
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> result = done->get_future();
+    std::thread([done, fn]() mutable {
+        fn();
+        done->set_value();
+    }).detach();
+    return result.wait_for(timeout) == std::future_status::ready;
+}
+
+}  // namespace test
+
+#define CHECK(condition) ::test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // TEST_UTIL_H